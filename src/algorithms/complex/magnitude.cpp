@@ -19,6 +19,7 @@
 
 #include "magnitude.h"
 #include "essentiamath.h"
+#include "simd.h"
 
 using namespace essentia;
 using namespace standard;
@@ -40,7 +41,5 @@ void Magnitude::compute() {
 
   magnitude.resize(cmplex.size());
 
-  for (::essentia::VectorEx<Real>::size_type i=0; i<magnitude.size(); i++) {
-    magnitude[i] = sqrt(cmplex[i].real()*cmplex[i].real() + cmplex[i].imag()*cmplex[i].imag());
-  }
+  simd::magnitude(cmplex.data(), magnitude.data(), (int)cmplex.size());
 }
@@ -19,6 +19,7 @@
 
 #include "musicextractor.h"
 #include "extractor_music/tagwhitelist.h"
+#include "essentia/streaming/algorithms/vectoroutput.h"
 
 using namespace std;
 
@@ -57,6 +58,9 @@ void MusicExtractor::configure() {
   startTime = parameter("startTime").toReal();
   endTime = parameter("endTime").toReal();
   requireMbid = parameter("requireMbid").toBool();
+  schedulerThreads = parameter("schedulerThreads").toInt();
+  decodeOnce = parameter("decodeOnce").toBool();
+  decodeAhead = parameter("decodeAhead").toBool();
 
   lowlevelFrameSize = parameter("lowlevelFrameSize").toInt();
   lowlevelHopSize = parameter("lowlevelHopSize").toInt();
@@ -106,6 +110,9 @@ void MusicExtractor::configure() {
     startTime = options.value<Real>("startTime");
     endTime = options.value<Real>("endTime");
     requireMbid = options.value<Real>("requireMbid");
+    schedulerThreads = (int) options.value<Real>("schedulerThreads");
+    decodeOnce = options.value<Real>("decodeOnce");
+    decodeAhead = options.value<Real>("decodeAhead");
   }
 
   if (options.value<Real>("highlevel.compute")) {
@@ -130,6 +137,9 @@ void MusicExtractor::setExtractorDefaultOptions() {
   options.set("endTime", endTime);
   options.set("analysisSampleRate", analysisSampleRate);
   options.set("requireMbid", requireMbid);
+  options.set("schedulerThreads", schedulerThreads);
+  options.set("decodeOnce", decodeOnce);
+  options.set("decodeAhead", decodeAhead);
 
   // lowlevel
   options.set("lowlevel.frameSize", lowlevelFrameSize);
@@ -241,7 +251,8 @@ void MusicExtractor::compute() {
                                     "startTime",  startTime,
                                     "endTime",    endTime,
                                     "replayGain", replayGain,
-                                    "downmix",    downmix);
+                                    "downmix",    downmix,
+                                    "decodeAhead", decodeAhead);
   MusicLowlevelDescriptors *lowlevel = new MusicLowlevelDescriptors(options);
   MusicRhythmDescriptors *rhythm = new MusicRhythmDescriptors(options);
   MusicTonalDescriptors *tonal = new MusicTonalDescriptors(options);
@@ -253,25 +264,48 @@ void MusicExtractor::compute() {
   rhythm->createNetwork(source, results);
   tonal->createNetworkTuningFrequency(source, results);
 
+  // keep the decoded audio for the second pass if we don't want to decode it
+  // again. The first pass has to be run entirely before the second one can
+  // start anyway, so this can't be avoided by streaming
+  ::essentia::VectorEx<Real> audio;
+  if (decodeOnce) {
+    source >> audio;
+  }
+
   scheduler::Network network(loader);
+  network.setNumThreads(schedulerThreads);
   network.run();
   
   // Descriptors that require values from other descriptors in the previous chain
   lowlevel->computeAverageLoudness(results);  // requires 'loudness'
 
-  streaming::Algorithm* loader_2 = factory.create("EasyLoader",
-                                       "filename",   audioFilename,
-                                       "sampleRate", analysisSampleRate,
-                                       "startTime",  startTime,
-                                       "endTime",    endTime,
-                                       "replayGain", replayGain,
-                                       "downmix",    downmix);
+  streaming::Algorithm* loader_2;
+  SourceBase* source_2;
+  if (decodeOnce) {
+    // feed the audio in chunks of the same order of magnitude as the ones
+    // coming out of the loader, not one sample at a time
+    streaming::VectorInput<Real>* audioInput = new streaming::VectorInput<Real>(&audio);
+    audioInput->setAcquireSize(4096);
+    loader_2 = audioInput;
+    source_2 = &loader_2->output("data");
+  }
+  else {
+    loader_2 = factory.create("EasyLoader",
+                              "filename",   audioFilename,
+                              "sampleRate", analysisSampleRate,
+                              "startTime",  startTime,
+                              "endTime",    endTime,
+                              "replayGain", replayGain,
+                              "downmix",    downmix,
+                              "decodeAhead", decodeAhead);
+    source_2 = &loader_2->output("audio");
+  }
 
-  SourceBase& source_2 = loader_2->output("audio");
-  rhythm->createNetworkBeatsLoudness(source_2, results);  // requires 'beat_positions'
-  tonal->createNetwork(source_2, results);                // requires 'tuning frequency'
+  rhythm->createNetworkBeatsLoudness(*source_2, results);  // requires 'beat_positions'
+  tonal->createNetwork(*source_2, results);                // requires 'tuning frequency'
 
   scheduler::Network network_2(loader_2);
+  network_2.setNumThreads(schedulerThreads);
   network_2.run();
 
   // Descriptors that require values from other descriptors in the previous chain
@@ -41,6 +41,9 @@ class MusicExtractor : public Algorithm {
   Real startTime;
   Real endTime;
   bool requireMbid;
+  int schedulerThreads;
+  bool decodeOnce;
+  bool decodeAhead;
 
   int lowlevelFrameSize;
   int lowlevelHopSize;
@@ -109,6 +112,9 @@ class MusicExtractor : public Algorithm {
     declareParameter("requireMbid", "ignore audio files without musicbrainz recording id tag (throw exception)", "{true,false}", false);
     // requireMbid option is very specific for AcousticBrainz extractor
     // however, we'll keep it here for now...
+    declareParameter("schedulerThreads", "the number of threads used to run the independent branches of the analysis networks (0 to use all hardware threads)", "[0,inf)", 1);
+    declareParameter("decodeOnce", "decode the audio only once and keep it in memory for the second analysis pass instead of decoding the file again (uses 4 bytes of memory per sample of analyzed audio)", "{true,false}", false);
+    declareParameter("decodeAhead", "decode the audio on a separate thread, so that decoding overlaps with the analysis (see AudioLoader)", "{true,false}", false);
   
     declareParameter("lowlevelFrameSize", "the frame size for computing low-level features", "(0,inf)", 2048);
     declareParameter("lowlevelHopSize", "the hop size for computing low-level features", "(0,inf)", 1024);
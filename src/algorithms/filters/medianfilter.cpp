@@ -20,8 +20,10 @@
 #include "medianfilter.h"
 #include "essentiamath.h"
 
-using namespace essentia;
-using namespace standard;
+using namespace std;
+
+namespace essentia {
+namespace standard {
 
 const char *MedianFilter::name = "MedianFilter";
 const char *MedianFilter::category = "Filters";
@@ -38,6 +40,8 @@ void MedianFilter::configure() {
 
   if (_kernelSize % 2 != 1)
     throw(EssentiaException("MedianFilter: kernelSize has to be odd"));
+
+  _window.setSize(_kernelSize);
 }
 
 void MedianFilter::compute() {
@@ -52,15 +56,20 @@ void MedianFilter::compute() {
         EssentiaException("kernelSize has to be smaller than the input size"));
   output.resize(inputSize);
 
-  // add padding at the beginning and end so the ouput fits the input size.
-  ::essentia::VectorEx<Real> paddedArray = input;
-  paddedArray.insert(paddedArray.begin(), paddingSize, input[0]);
-  paddedArray.insert(paddedArray.end(), paddingSize, input.back());
+  // the input is padded at the beginning and end with its first and last
+  // values so that the output fits the input size. The window is slid over
+  // it instead of sorting each window again
+  _window.reset();
+  for (int i = 0; i < paddingSize; i++) _window.push(input[0]);
+  for (int i = 0; i < paddingSize; i++) _window.push(input[i]);
 
-  ::essentia::VectorEx<Real>::const_iterator first = paddedArray.begin();
-  ::essentia::VectorEx<Real> window;
   for (int i = 0; i < inputSize; i++) {
-    window.assign(first + i, first + i + _kernelSize);
-    output[i] = median(window);
+    int next = i + paddingSize;
+    _window.push(next < inputSize ? input[next] : input.back());
+    output[i] = _window.median();
   }
 }
+
+}  // namespace standard
+}  // namespace essentia
+
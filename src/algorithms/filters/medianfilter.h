@@ -21,6 +21,7 @@
 #define ESSENTIA_MEDIANFILTER_H
 
 #include "algorithm.h"
+#include "slidingmedian.h"
 
 namespace essentia {
 namespace standard {
@@ -32,6 +33,7 @@ class MedianFilter : public Algorithm {
   Output<::essentia::VectorEx<Real>> _filteredArray;
 
   int _kernelSize;
+  util::SlidingMedian _window;
 
  public:
   MedianFilter() {
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "medianfilterstream.h"
+
+using namespace std;
+
+namespace essentia {
+namespace streaming {
+
+const char* MedianFilterStream::name = "MedianFilterStream";
+const char* MedianFilterStream::category = "Filters";
+const char* MedianFilterStream::description =
+    DOC("This algorithm computes the median filtered version of a stream of "
+        "values, giving the kernel size as detailed in [1]. Unlike "
+        "MedianFilter, which filters each input array independently, its "
+        "window slides over the whole stream, so that the output is the same "
+        "as filtering the whole signal at once with the standard MedianFilter. "
+        "The output is delayed by kernelSize/2 values, and the end of the "
+        "stream is padded with its last value.\n"
+        "\n"
+        "References:\n"
+        "  [1] Median Filter -- from Wikipedia.org, \n"
+        "  https://en.wikipedia.org/wiki/Median_filter");
+
+void MedianFilterStream::configure() {
+  _kernelSize = parameter("kernelSize").toInt();
+
+  if (_kernelSize % 2 != 1)
+    throw(EssentiaException("MedianFilterStream: kernelSize has to be odd"));
+
+  _paddingSize = _kernelSize / 2;
+  _window.setSize(_kernelSize);
+
+  // the values are processed in chunks of _preferredSize, but flushing the
+  // end of the stream outputs _paddingSize of them at once
+  _preferredSize = _array.acquireSize();
+  _filteredArray.setAcquireSize(max(_preferredSize, _paddingSize));
+  _filteredArray.setReleaseSize(max(_preferredSize, _paddingSize));
+
+  reset();
+}
+
+void MedianFilterStream::reset() {
+  Algorithm::reset();
+  _window.reset();
+  _consumed = 0;
+  _last = 0;
+  _flushed = false;
+}
+
+AlgorithmStatus MedianFilterStream::process() {
+  int nInput = _preferredSize;
+
+  if (!_array.acquire(nInput)) {
+    if (!shouldStop()) return NO_INPUT;
+
+    // take whatever is left, and flush the delayed values once it is gone
+    nInput = _array.available();
+    if (nInput == 0 && (_flushed || _consumed == 0)) return NO_INPUT;
+    if (nInput > 0 && !_array.acquire(nInput)) return NO_INPUT;
+  }
+
+  // the first _paddingSize values don't give any output yet
+  int nOutput;
+  if (nInput > 0) {
+    nOutput = (int)(max(_consumed + nInput - _paddingSize, 0LL) - max(_consumed - _paddingSize, 0LL));
+  }
+  else {
+    nOutput = (int)min((long long)_paddingSize, _consumed);
+  }
+
+  if (nOutput > 0 && !_filteredArray.acquire(nOutput)) return NO_OUTPUT;
+
+  Real* output = nOutput > 0 ? &_filteredArray.tokens()[0] : 0;
+  int o = 0;
+
+  if (nInput > 0) {
+    const ::essentia::VectorEx<Real>& input = _array.tokens();
+    for (int i = 0; i < nInput; i++) {
+      // left padding, as in the standard version
+      if (_consumed == 0) {
+        for (int j = 0; j < _paddingSize; j++) _window.push(input[i]);
+      }
+      _window.push(input[i]);
+      _consumed++;
+      if (_window.full()) output[o++] = _window.median();
+    }
+    _last = input[nInput-1];
+    _array.release(nInput);
+  }
+  else {
+    // end of the stream: right padding with the last value
+    for (int i = 0; i < _paddingSize; i++) {
+      _window.push(_last);
+      if (_window.full()) output[o++] = _window.median();
+    }
+    _flushed = true;
+  }
+
+  if (nOutput > 0) _filteredArray.release(nOutput);
+
+  return OK;
+}
+
+}  // namespace streaming
+}  // namespace essentia
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_MEDIANFILTERSTREAM_H
+#define ESSENTIA_MEDIANFILTERSTREAM_H
+
+#include "streamingalgorithm.h"
+#include "slidingmedian.h"
+
+namespace essentia {
+namespace streaming {
+
+/**
+ * MedianFilterStream filters a stream of values, whereas MedianFilter filters
+ * each array it receives independently. It keeps its window across calls, so
+ * its output is delayed by kernelSize/2 values, which are flushed at the end
+ * of the stream using the same padding as MedianFilter.
+ */
+class MedianFilterStream : public Algorithm {
+ protected:
+  Sink<Real> _array;
+  Source<Real> _filteredArray;
+
+  int _kernelSize;
+  int _paddingSize;
+  int _preferredSize;
+  util::SlidingMedian _window;
+  long long _consumed;  // number of values received since the last reset
+  Real _last;           // last value received, used to pad the end
+  bool _flushed;
+
+ public:
+  MedianFilterStream() {
+    declareInput(_array, 4096, "array", "the input signal");
+    declareOutput(_filteredArray, 4096, "filteredArray", "the median-filtered signal");
+    _filteredArray.setBufferType(BufferUsage::forAudioStream);
+  }
+
+  void declareParameters() {
+    declareParameter("kernelSize", "scalar giving the size of the median filter window. Must be odd", "[1,inf)", 11);
+  }
+
+  void configure();
+  void reset();
+  AlgorithmStatus process();
+
+  static const char* name;
+  static const char* category;
+  static const char* description;
+};
+
+}  // namespace streaming
+}  // namespace essentia
+
+#endif // ESSENTIA_MEDIANFILTERSTREAM_H
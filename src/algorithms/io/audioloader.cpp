@@ -32,7 +32,9 @@ const char* AudioLoader::description = essentia::standard::AudioLoader::descript
 
 
 AudioLoader::~AudioLoader() {
+    stopDecoder();
     closeAudioFile();
+    delete _cacheWriter;
 
     av_freep(&_buffer);
     av_freep(&_md5Encoded);
@@ -44,8 +46,27 @@ void AudioLoader::configure() {
     // "invalid new backstep" messages anymore, when everything is actually fine
     av_log_set_level(AV_LOG_QUIET);
     //av_log_set_level(AV_LOG_VERBOSE);
+
+    // the decoding thread reads the configuration
+    stopDecoder();
+
     _computeMD5 = parameter("computeMD5").toBool();
     _selectedStream = parameter("audioStream").toInt();
+    _decodeAhead = parameter("decodeAhead").toBool();
+    _decodeThreads = parameter("decodeThreads").toInt();
+
+    if (parameter("startTime").toReal() > parameter("endTime").toReal()) {
+        throw EssentiaException("AudioLoader: startTime cannot be larger than endTime.");
+    }
+
+    // the file is hashed here rather than in reset(), so that it is only read
+    // once per configuration
+    _cachePath.clear();
+    string cacheDirectory = audioCacheDirectory(parameter("cacheDirectory").toString());
+    if (!cacheDirectory.empty() && parameter("filename").isConfigured()) {
+        _cachePath = audioCachePath(cacheDirectory, parameter("filename").toString(), _selectedStream);
+    }
+
     reset();
 }
 
@@ -106,6 +127,11 @@ void AudioLoader::openAudioFile(const string& filename) {
         throw EssentiaException("AudioLoader: Unsupported codec!");
     }
 
+    // let the codecs that support it decode on several threads, by slices
+    // within a frame or by overlapping the decoding of consecutive frames
+    _audioCtx->thread_count = _decodeThreads;
+    _audioCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
     if (avcodec_open2(_audioCtx, _audioCodec, NULL) < 0) {
         throw EssentiaException("AudioLoader: Unable to instantiate codec...");
     }
@@ -180,12 +206,18 @@ void AudioLoader::pushChannelsSampleRateInfo(int nChannels, Real sampleRate) {
 
     _channels.push(nChannels);
     _sampleRate.push(sampleRate);
+
+    _cacheInfo.channels = nChannels;
+    _cacheInfo.sampleRate = sampleRate;
 }
 
 
 void AudioLoader::pushCodecInfo(std::string codec, int bit_rate) {
     _codec.push(codec);
     _bit_rate.push(bit_rate);
+
+    _cacheInfo.codec = codec;
+    _cacheInfo.bitRate = bit_rate;
 }
 
 
@@ -203,6 +235,39 @@ AlgorithmStatus AudioLoader::process() {
         throw EssentiaException("AudioLoader: Trying to call process() on an AudioLoader algo which hasn't been correctly configured.");
     }
 
+    if (_cacheEntry.isOpen()) return processCachedAudio();
+
+    if (_decodeAhead) return processDecodedAudio();
+
+    AlgorithmStatus status = decodeNextPacket();
+    if (status == FINISHED) {
+        shouldStop(true);
+        _md5.push(_md5Result);
+    }
+    return status;
+}
+
+
+/**
+ * Reads the next packet of the selected stream and decodes it, outputting the
+ * samples with outputAudio(). Returns FINISHED once the file (or the segment)
+ * has been entirely decoded. This is called from process(), or from the
+ * decoding thread when decoding ahead.
+ */
+AlgorithmStatus AudioLoader::decodeNextPacket() {
+    if (_restart) {
+        closeAudioFile();
+        openAudioFile(parameter("filename").toString());
+        _position = 0;
+        _positionUnknown = false;
+        _restart = false;
+    }
+
+    // once the end of the segment has been output, the rest of the file is
+    // only read if its MD5 checksum is needed
+    bool segmentDone = !_positionUnknown && _position >= _endSample;
+    if (segmentDone && !_computeMD5) return finishDecoding(false);
+
     // read frames until we get a good one
     do {
         int result = av_read_frame(_demuxCtx, &_packet);
@@ -218,26 +283,22 @@ AlgorithmStatus AudioLoader::process() {
             }
             // TODO: should try reading again on EAGAIN error?
             //       https://github.com/FFmpeg/FFmpeg/blob/master/ffmpeg.c
-            shouldStop(true);
+            if (segmentDone) return finishDecoding(false);
             flushPacket();
-            closeAudioFile();
-            if (_computeMD5) {
-                av_md5_final(_md5Encoded, _checksum);
-                _md5.push(uint8_t_to_hex(_checksum, 16));
-            }
-            else {
-                string md5 = "";
-                _md5.push(md5);
-            }
-            return FINISHED;
+            return finishDecoding(true);
         }
     } while (_packet.stream_index != _streamIdx);
 
     // compute md5 first
-    if (_computeMD5) {
+    if (_computeMD5 || _storeInCache) {
         av_md5_update(_md5Encoded, _packet.data, _packet.size);
     }
 
+    if (segmentDone) {
+        av_free_packet(&_packet);
+        return OK;
+    }
+
     // decode frames in packet
     while(_packet.size > 0) {
         if (!decodePacket()) break;
@@ -400,7 +461,7 @@ int AudioLoader::decodePacket() {
         // data until it is completely consumed or an error occurs.
 
         E_WARNING("AudioLoader: more than 1 frame in packet, decoding remaining bytes...");
-        E_WARNING("at sample index: " << output("audio").totalProduced());
+        E_WARNING("at sample index: " << _position);
         E_WARNING("decoded samples: " << len);
         E_WARNING("packet size: " << _packet.size);
     }
@@ -425,10 +486,96 @@ inline Real scale(int16_t value) {
 }
 */
 
+/**
+ * Ends the decoding of the file, and stores the decoded audio in the cache if
+ * the whole file has been decoded. The MD5 checksum to output is left in
+ * _md5Result.
+ */
+AlgorithmStatus AudioLoader::finishDecoding(bool complete) {
+    closeAudioFile();
+
+    // the MD5 checksum is always stored in the cache, so that it can
+    // be output on a cache hit whatever the value of computeMD5
+    string md5 = "";
+    if (_computeMD5 || _cacheWriter) {
+        av_md5_final(_md5Encoded, _checksum);
+        md5 = uint8_t_to_hex(_checksum, 16);
+    }
+    if (_cacheWriter) {
+        if (complete) {
+            _cacheInfo.md5 = md5;
+            _cacheWriter->commit(_cacheInfo);
+        }
+        delete _cacheWriter;
+        _cacheWriter = 0;
+    }
+    if (!_cachePath.empty()) audioCacheMiss();
+
+    _md5Result = _computeMD5 ? md5 : string();
+    return FINISHED;
+}
+
+
+AlgorithmStatus AudioLoader::processCachedAudio() {
+    const AudioCacheInfo& info = _cacheEntry.info();
+    uint64_t end = min((uint64_t)_endSample, info.frames);
+
+    if (_cachePosition >= end) {
+        shouldStop(true);
+        _md5.push(_computeMD5 ? info.md5 : string());
+        audioCacheHit((end - min((uint64_t)_startSample, end)) * info.channels * sizeof(float));
+        _cacheEntry.close();
+        return FINISHED;
+    }
+
+    int nsamples = (int)min((uint64_t)CACHE_CHUNK_SIZE, end - _cachePosition);
+    copyAudio(_cacheEntry.frames(_cachePosition), nsamples);
+    _cachePosition += nsamples;
+
+    return OK;
+}
+
+
 void AudioLoader::copyFFmpegOutput() {
     int nsamples = _dataSize / (av_get_bytes_per_sample(AV_SAMPLE_FMT_FLT)  * _nChannels);
-    if (nsamples == 0) return;
+    if (nsamples == 0 || _restart) return;
+
+    if (_positionUnknown) {
+        // first frame decoded after seeking: its timestamp gives its position
+        int64_t timestamp = _decodedFrame->best_effort_timestamp;
+        if (timestamp == AV_NOPTS_VALUE || timestampToSample(timestamp) > _startSample) {
+            E_DEBUG(EAlgorithm, "AudioLoader: seek did not land before the start of the segment, decoding from the beginning");
+            _restart = true;
+            return;
+        }
+        _position = timestampToSample(timestamp);
+        _positionUnknown = false;
+    }
+
+    if (_storeInCache) {
+        if (!_cacheWriter) {
+            try {
+                _cacheWriter = new AudioCacheWriter(_cachePath, _nChannels);
+            }
+            catch (EssentiaException& e) {
+                // an unusable cache should not prevent loading the file
+                E_WARNING("AudioLoader: disabling the cache: " << e.what());
+                _storeInCache = false;
+            }
+        }
+        if (_cacheWriter) _cacheWriter->append(_buffer, nsamples);
+    }
+
+    // only output the decoded samples that are within the segment
+    int64_t begin = max(_startSample - _position, (int64_t)0);
+    int64_t end = min(_endSample - _position, (int64_t)nsamples);
+    if (begin < end) outputAudio(_buffer + begin*_nChannels, (int)(end - begin));
+
+    _position += nsamples;
+}
+
 
+void AudioLoader::copyAudio(const float* samples, int nsamples) {
     // acquire necessary data
     bool ok = _audio.acquire(nsamples);
     if (!ok) {
@@ -439,15 +586,15 @@ void AudioLoader::copyFFmpegOutput() {
 
     if (_nChannels == 1) {
         for (int i=0; i<nsamples; i++) {
-          audio[i].left() = _buffer[i];
+          audio[i].left() = samples[i];
           //audio[i].left() = scale(_buffer[i]);
         }
     }
     else { // _nChannels == 2
       // The output format is always AV_SAMPLE_FMT_FLT, which is interleaved
       for (int i=0; i<nsamples; i++) {
-        audio[i].left() = _buffer[2*i];
-        audio[i].right() = _buffer[2*i+1];
+        audio[i].left() = samples[2*i];
+        audio[i].right() = samples[2*i+1];
         //audio[i].left() = scale(_buffer[2*i]);
         //audio[i].right() = scale(_buffer[2*i+1]);
       }
@@ -464,7 +611,145 @@ void AudioLoader::copyFFmpegOutput() {
     _audio.release(nsamples);
 }
 
+AlgorithmStatus AudioLoader::processDecodedAudio() {
+    if (!_decoder) startDecoder();
+
+    DecodedBlock* block = _blocks.front();
+    if (!block) {
+        unique_lock<mutex> lock(_decoderMutex);
+        _decoderEvent.wait(lock, [this] { return _blocks.front() || _decoderDone; });
+        // blocks are published before the decoder is done, so a block may
+        // still be waiting even if it is
+        block = _blocks.front();
+    }
+
+    if (block) {
+        copyAudio(block->samples.data(), block->nsamples);
+        _blocks.pop();
+        notifyDecoderEvent();
+        return OK;
+    }
+
+    stopDecoder();
+    if (_decoderError) {
+        exception_ptr error = _decoderError;
+        _decoderError = nullptr;
+        rethrow_exception(error);
+    }
+
+    shouldStop(true);
+    _md5.push(_md5Result);
+    return FINISHED;
+}
+
+
+/**
+ * Outputs decoded samples: directly when decoding in process(), through the
+ * ring of blocks when decoding ahead. In the latter case, this blocks while
+ * the ring is full.
+ */
+void AudioLoader::outputAudio(const float* samples, int nsamples) {
+    if (!_decodeAhead) {
+        copyAudio(samples, nsamples);
+        return;
+    }
+
+    if (!_currentBlock) {
+        _currentBlock = _blocks.back();
+        if (!_currentBlock) {
+            unique_lock<mutex> lock(_decoderMutex);
+            _decoderEvent.wait(lock, [this] { return _blocks.back() || _stopDecoder; });
+            if (_stopDecoder) return;
+            _currentBlock = _blocks.back();
+        }
+        _currentBlock->nsamples = 0;
+    }
+
+    // the samples of the block keep their capacity, so that blocks are only
+    // allocated while the ring fills up for the first time
+    ::essentia::VectorEx<float>& blockSamples = _currentBlock->samples;
+    size_t offset = (size_t)_currentBlock->nsamples * _nChannels;
+    blockSamples.resize(offset + (size_t)nsamples * _nChannels);
+    memcpy(blockSamples.data() + offset, samples, nsamples * _nChannels * sizeof(float));
+    _currentBlock->nsamples += nsamples;
+
+    if (_currentBlock->nsamples >= DECODE_AHEAD_BLOCK_SIZE) publishBlock();
+}
+
+
+void AudioLoader::publishBlock() {
+    if (!_currentBlock) return;
+    if (_currentBlock->nsamples > 0) {
+        _blocks.push();
+        notifyDecoderEvent();
+    }
+    _currentBlock = 0;
+}
+
+
+void AudioLoader::notifyDecoderEvent() {
+    // taking the mutex makes sure that the other thread is either waiting or
+    // will see the new state before waiting
+    { lock_guard<mutex> lock(_decoderMutex); }
+    _decoderEvent.notify_all();
+}
+
+
+void AudioLoader::decoderLoop() {
+    try {
+        while (!_stopDecoder && decodeNextPacket() == OK) {}
+        if (!_stopDecoder) publishBlock();
+    }
+    catch (...) {
+        _decoderError = current_exception();
+    }
+
+    {
+        lock_guard<mutex> lock(_decoderMutex);
+        _decoderDone = true;
+    }
+    _decoderEvent.notify_all();
+}
+
+
+void AudioLoader::startDecoder() {
+    _decoderDone = false;
+    _stopDecoder = false;
+    _decoderError = nullptr;
+    _currentBlock = 0;
+    _blocks.clear();
+    _decoder = new thread(&AudioLoader::decoderLoop, this);
+}
+
+
+/**
+ * Stops the decoding thread, if any, and waits for it to terminate. The file
+ * is left open, and any error of the decoding thread in _decoderError.
+ */
+void AudioLoader::stopDecoder() {
+    if (!_decoder) return;
+
+    {
+        lock_guard<mutex> lock(_decoderMutex);
+        _stopDecoder = true;
+    }
+    _decoderEvent.notify_all();
+
+    _decoder->join();
+    delete _decoder;
+    _decoder = 0;
+
+    _currentBlock = 0;
+    _blocks.clear();
+    _stopDecoder = false;
+    _decoderDone = false;
+}
+
+
 void AudioLoader::reset() {
+    stopDecoder();
+    _decoderError = nullptr;
+
     Algorithm::reset();
 
     if (!parameter("filename").isConfigured()) return;
@@ -472,10 +757,76 @@ void AudioLoader::reset() {
     string filename = parameter("filename").toString();
 
     closeAudioFile();
+    _cacheEntry.close();
+    delete _cacheWriter;
+    _cacheWriter = 0;
+    _position = 0;
+    _positionUnknown = false;
+    _restart = false;
+
+    if (!_cachePath.empty() && _cacheEntry.open(_cachePath)) {
+        E_DEBUG(EAlgorithm, "AudioLoader: loading " << filename << " from the cache: " << _cachePath);
+        const AudioCacheInfo& info = _cacheEntry.info();
+        pushChannelsSampleRateInfo(info.channels, info.sampleRate);
+        pushCodecInfo(info.codec, info.bitRate);
+
+        // the cached audio can be read directly from the start of the segment
+        configureSegment(info.sampleRate);
+        _cachePosition = min((uint64_t)_startSample, info.frames);
+        return;
+    }
+
     openAudioFile(filename);
 
     pushChannelsSampleRateInfo(_audioCtx->channels, _audioCtx->sample_rate);
     pushCodecInfo(_audioCodec->name, _audioCtx->bit_rate);
+
+    configureSegment(_audioCtx->sample_rate);
+
+    // only the audio of whole files is stored in the cache
+    _storeInCache = !_cachePath.empty() && _startSample == 0;
+
+    // the MD5 checksum covers the whole file, so there is no point in seeking
+    // if it needs to be computed
+    if (!_computeMD5) seekToSegment();
+}
+
+
+void AudioLoader::configureSegment(Real sampleRate) {
+    _startSample = (int64_t)(parameter("startTime").toReal() * sampleRate);
+    _endSample = (int64_t)(parameter("endTime").toReal() * sampleRate);
+}
+
+
+void AudioLoader::seekToSegment() {
+    int64_t preroll = (int64_t)SEEK_PREROLL_MS * _audioCtx->sample_rate / 1000;
+    if (_startSample <= preroll) return;
+
+    AVStream* stream = _demuxCtx->streams[_streamIdx];
+    AVRational sampleTimeBase = { 1, _audioCtx->sample_rate };
+    int64_t timestamp = av_rescale_q(_startSample - preroll, sampleTimeBase, stream->time_base);
+    if (stream->start_time != AV_NOPTS_VALUE) timestamp += stream->start_time;
+
+    if (av_seek_frame(_demuxCtx, _streamIdx, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        E_DEBUG(EAlgorithm, "AudioLoader: could not seek, decoding from the beginning");
+        _restart = true;
+        return;
+    }
+
+    avcodec_flush_buffers(_audioCtx);
+    _positionUnknown = true;
+}
+
+
+/**
+ * Converts a timestamp of the decoded stream to the index of the corresponding
+ * sample, counted from the first sample of the stream.
+ */
+int64_t AudioLoader::timestampToSample(int64_t timestamp) {
+    AVStream* stream = _demuxCtx->streams[_streamIdx];
+    if (stream->start_time != AV_NOPTS_VALUE) timestamp -= stream->start_time;
+    AVRational sampleTimeBase = { 1, _audioCtx->sample_rate };
+    return av_rescale_q(timestamp, stream->time_base, sampleTimeBase);
 }
 
 } // namespace streaming
@@ -492,6 +843,12 @@ const char* AudioLoader::description = DOC("This algorithm loads the single audi
 "This algorithm will throw an exception if it was not properly configured which is normally due to not specifying a valid filename. Invalid names comprise those with extensions different than the supported  formats and non existent files. If using this algorithm on Windows, you must ensure that the filename is encoded as UTF-8\n\n"
 "Note: ogg files are decoded in reverse phase, due to be using ffmpeg library.\n"
 "\n"
+"A segment of the file can be loaded by setting the 'startTime' and 'endTime' parameters. Decoding then starts close to the segment (a short pre-roll lets the decoder warm up) instead of at the beginning of the file, whenever the container supports seeking, so that the cost of loading a segment depends on its length rather than on the length of the file. Samples are trimmed to the segment according to the timestamps of the decoded frames. The whole file is still read if the MD5 checksum is computed.\n"
+"\n"
+"The file can be decoded on a separate thread by setting the 'decodeAhead' parameter, so that decoding overlaps with the processing of the algorithms consuming the audio: the decoding thread fills a bounded ring of blocks of samples ahead of the network, and waits whenever the network falls behind. Independently, 'decodeThreads' sets the number of threads used internally by the codecs that support multithreaded decoding.\n"
+"\n"
+"Decoded audio can be stored in an on-disk cache, so that loading the same file again (even under another name) reads the decoded samples from a memory-mapped file instead of decoding it. The cache is enabled by setting the 'cacheDirectory' parameter or the ESSENTIA_AUDIO_CACHE environment variable, and its entries are keyed by a hash of the content of the file and the selected audio stream. The numbers of cache hits and misses are returned by essentia.audioCacheStatistics() in python.\n"
+"\n"
 "References:\n"
 "  [1] WAV - Wikipedia, the free encyclopedia,\n"
 "      http://en.wikipedia.org/wiki/Wav\n"
@@ -521,7 +878,12 @@ void AudioLoader::createInnerNetwork() {
 void AudioLoader::configure() {
     _loader->configure(INHERIT("filename"),
                        INHERIT("computeMD5"),
-                       INHERIT("audioStream"));
+                       INHERIT("audioStream"),
+                       INHERIT("cacheDirectory"),
+                       INHERIT("startTime"),
+                       INHERIT("endTime"),
+                       INHERIT("decodeAhead"),
+                       INHERIT("decodeThreads"));
 }
 
 void AudioLoader::compute() {
@@ -24,10 +24,22 @@
 #include "network.h"
 #include "ffmpegapi.h"
 #include "poolstorage.h"
+#include "audiocache.h"
+#include "spscring.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 
 #define MAX_AUDIO_FRAME_SIZE 192000
 
+// when loading a segment that does not start at the beginning of the file,
+// decoding starts this long before it, so that the decoder has warmed up
+// (overlapping transform frames, mp3 bit reservoir) by its first sample
+#define SEEK_PREROLL_MS 500
+
 namespace essentia {
 namespace streaming {
 
@@ -67,6 +79,54 @@ class AudioLoader : public Algorithm {
   int _selectedStream;
   bool _configured;
 
+  // segment of the file to output, in samples, and index in the file of the
+  // next decoded sample. After a seek, the index is unknown until a frame with
+  // a timestamp is decoded. If the seek failed or did not land before the
+  // start of the segment, the file is decoded again from the beginning.
+  int64_t _startSample;
+  int64_t _endSample;
+  int64_t _position;
+  bool _positionUnknown;
+  bool _restart;
+
+  // on-disk cache of decoded audio (see audiocache.h). When the file is in
+  // the cache, it is read from _cacheEntry instead of being decoded,
+  // otherwise the decoded audio is stored in it with _cacheWriter.
+  std::string _cachePath;
+  AudioCacheInfo _cacheInfo;
+  AudioCacheEntry _cacheEntry;
+  AudioCacheWriter* _cacheWriter;
+  uint64_t _cachePosition;
+  bool _storeInCache;
+
+  // number of frames output at once when reading from the cache
+  const static int CACHE_CHUNK_SIZE = 16384;
+
+  // decoding ahead (see the decodeAhead parameter): a dedicated thread reads
+  // and decodes the file into a ring of blocks of interleaved samples, which
+  // process() outputs. The decoding thread writes _md5Result and
+  // _decoderError before setting _decoderDone.
+  struct DecodedBlock {
+    ::essentia::VectorEx<float> samples;
+    int nsamples;
+  };
+
+  bool _decodeAhead;
+  int _decodeThreads;
+  util::SPSCRing<DecodedBlock> _blocks;
+  DecodedBlock* _currentBlock; // block being filled by the decoding thread
+  std::thread* _decoder;
+  std::atomic<bool> _decoderDone;
+  std::atomic<bool> _stopDecoder;
+  std::exception_ptr _decoderError;
+  std::mutex _decoderMutex;
+  std::condition_variable _decoderEvent;
+  std::string _md5Result;
+
+  // a block is passed to process() once it holds at least this many frames
+  const static int DECODE_AHEAD_BLOCKS = 16;
+  const static int DECODE_AHEAD_BLOCK_SIZE = 16384;
+
 
   void openAudioFile(const std::string& filename);
   void closeAudioFile();
@@ -78,12 +138,32 @@ class AudioLoader : public Algorithm {
   int decodePacket();
   void flushPacket();
   void copyFFmpegOutput();
+  void copyAudio(const float* samples, int nsamples);
+  void outputAudio(const float* samples, int nsamples);
+  AlgorithmStatus decodeNextPacket();
+  AlgorithmStatus processCachedAudio();
+  AlgorithmStatus processDecodedAudio();
+  AlgorithmStatus finishDecoding(bool complete);
+
+  void startDecoder();
+  void stopDecoder();
+  void decoderLoop();
+  void publishBlock();
+  void notifyDecoderEvent();
+
+  void configureSegment(Real sampleRate);
+  void seekToSegment();
+  int64_t timestampToSample(int64_t timestamp);
 
 
  public:
   AudioLoader() : Algorithm(), _buffer(0),  _demuxCtx(0),
 	          _audioCtx(0), _audioCodec(0), _decodedFrame(0),
-            _convertCtxAv(0), _configured(false) {
+            _convertCtxAv(0), _configured(false), _startSample(0), _endSample(0),
+            _position(0), _positionUnknown(false), _restart(false),
+            _cacheWriter(0), _cachePosition(0), _storeInCache(false),
+            _decodeAhead(false), _decodeThreads(1), _blocks(DECODE_AHEAD_BLOCKS),
+            _currentBlock(0), _decoder(0), _decoderDone(false), _stopDecoder(false) {
 
     declareOutput(_audio, 1, "audio", "the input audio signal");
     declareOutput(_sampleRate, 0, "sampleRate", "the sampling rate of the audio signal [Hz]");
@@ -115,6 +195,11 @@ class AudioLoader : public Algorithm {
     declareParameter("filename", "the name of the file from which to read", "", Parameter::STRING);
     declareParameter("computeMD5", "compute the MD5 checksum", "{true,false}", false);
     declareParameter("audioStream", "audio stream index to be loaded. Other streams are not taken into account (e.g. if stream 0 is video and 1 is audio use index 0 to access it.)", "[0,inf)", 0);
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio. If empty, the ESSENTIA_AUDIO_CACHE environment variable is used, and the cache is disabled if it is not set", "", "");
+    declareParameter("startTime", "the start time of the segment to load [s]", "[0,inf)", 0.0);
+    declareParameter("endTime", "the end time of the segment to load [s]", "[0,inf)", 1.0e6);
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the algorithms consuming the audio, so that decoding overlaps with their processing", "{true,false}", false);
+    declareParameter("decodeThreads", "the number of threads used by the decoder for the codecs that support multithreaded decoding (0 to let the decoder choose)", "[0,inf)", 1);
   }
 
   void configure();
@@ -176,6 +261,11 @@ class AudioLoader : public Algorithm {
     declareParameter("filename", "the name of the file from which to read", "", Parameter::STRING);
     declareParameter("computeMD5", "compute the MD5 checksum", "{true,false}", false);
     declareParameter("audioStream", "audio stream index to be loaded. Other streams are no taken into account (e.g. if stream 0 is video and 1 is audio use index 0 to access it.)", "[0,inf)", 0);
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio. If empty, the ESSENTIA_AUDIO_CACHE environment variable is used, and the cache is disabled if it is not set", "", "");
+    declareParameter("startTime", "the start time of the segment to load [s]", "[0,inf)", 0.0);
+    declareParameter("endTime", "the end time of the segment to load [s]", "[0,inf)", 1.0e6);
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the algorithms consuming the audio, so that decoding overlaps with their processing", "{true,false}", false);
+    declareParameter("decodeThreads", "the number of threads used by the decoder for the codecs that support multithreaded decoding (0 to let the decoder choose)", "[0,inf)", 1);
   }
 
   void configure();
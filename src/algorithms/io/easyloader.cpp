@@ -58,16 +58,27 @@ void EasyLoader::configure() {
   // if no file has been specified, do not do anything
   if (!parameter("filename").isConfigured()) return;
 
+  // the slice is extracted by the loader, which only decodes the part of the
+  // file that contains it. It is loaded with a small margin at the end, which
+  // the trimmer removes, so that the length of the slice at the output
+  // sampling rate is the same as when trimming the whole resampled file.
+  Real startTime = parameter("startTime").toReal();
+  Real endTime = parameter("endTime").toReal();
+
   _monoLoader->configure(INHERIT("filename"),
                          INHERIT("sampleRate"),
                          INHERIT("downmix"),
-                         INHERIT("audioStream"));
+                         INHERIT("audioStream"),
+                         INHERIT("cacheDirectory"),
+                         INHERIT("decodeAhead"),
+                         "startTime", startTime,
+                         "endTime", endTime + 0.1);
 
   _params.add("originalSampleRate", _monoLoader->parameter("originalSampleRate"));
 
   _trimmer->configure(INHERIT("sampleRate"),
-                      INHERIT("startTime"),
-                      INHERIT("endTime"));
+                      "startTime", 0.0,
+                      "endTime", endTime - startTime);
 
   // apply a 6dB preamp, as done by all audio players.
   Real scalingFactor = db2amp(parameter("replayGain").toReal() + 6.0);
@@ -114,7 +125,9 @@ void EasyLoader::configure() {
                      INHERIT("endTime"),
                      INHERIT("replayGain"),
                      INHERIT("downmix"),
-                     INHERIT("audioStream"));
+                     INHERIT("audioStream"),
+                     INHERIT("cacheDirectory"),
+                     INHERIT("decodeAhead"));
 }
 
 void EasyLoader::compute() {
@@ -55,13 +55,22 @@ void EqloudLoader::configure() {
   // if no file has been specified, do not do anything
   if (!parameter("filename").isConfigured()) return;
 
+  // the slice is extracted by the loader, with a margin removed by the
+  // trimmer (see EasyLoader)
+  Real startTime = parameter("startTime").toReal();
+  Real endTime = parameter("endTime").toReal();
+
   _monoLoader->configure(INHERIT("filename"),
                          INHERIT("sampleRate"),
-                         INHERIT("downmix"));
+                         INHERIT("downmix"),
+                         INHERIT("cacheDirectory"),
+                         INHERIT("decodeAhead"),
+                         "startTime", startTime,
+                         "endTime", endTime + 0.1);
 
   _trimmer->configure(INHERIT("sampleRate"),
-                      INHERIT("startTime"),
-                      INHERIT("endTime"));
+                      "startTime", 0.0,
+                      "endTime", endTime - startTime);
 
   // apply a 6dB preamp, as done by all audio players.
   Real scalingFactor = db2amp(parameter("replayGain").toReal() + 6.0);
@@ -110,7 +119,9 @@ void EqloudLoader::configure() {
                      INHERIT("startTime"),
                      INHERIT("endTime"),
                      INHERIT("replayGain"),
-                     INHERIT("downmix"));
+                     INHERIT("downmix"),
+                     INHERIT("cacheDirectory"),
+                     INHERIT("decodeAhead"));
 }
 
 void EqloudLoader::compute() {
@@ -53,6 +53,8 @@ class EqloudLoader : public AlgorithmComposite {
     declareParameter("endTime", "the end time of the slice to be extracted [s]", "[0,inf)", 1e6);
     declareParameter("replayGain", "the value of the replayGain [dB] that should be used to normalize the signal [dB]", "(-inf,inf)", -6.0);
     declareParameter("downmix", "the mixing type for stereo files", "{left,right,mix}", "mix");
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio (see AudioLoader)", "", "");
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the processing of the audio (see AudioLoader)", "{true,false}", false);
   }
 
   void declareProcessOrder() {
@@ -108,6 +110,8 @@ class EqloudLoader : public Algorithm {
     declareParameter("endTime", "the end time of the slice to be extracted [s]", "[0,inf)", 1e6);
     declareParameter("replayGain", "the value of the replayGain [dB] that should be used to normalize the signal [dB]", "(-inf,inf)", -6.0);
     declareParameter("downmix", "the mixing type for stereo files", "{left,right,mix}", "mix");
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio (see AudioLoader)", "", "");
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the processing of the audio (see AudioLoader)", "{true,false}", false);
   }
 
   void configure();
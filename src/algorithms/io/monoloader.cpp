@@ -60,7 +60,11 @@ void MonoLoader::configure() {
 
   _audioLoader->configure("filename", filename,
                           "computeMD5", false,
-                          INHERIT("audioStream"));
+                          INHERIT("audioStream"),
+                          INHERIT("cacheDirectory"),
+                          INHERIT("startTime"),
+                          INHERIT("endTime"),
+                          INHERIT("decodeAhead"));
 
   int inputSampleRate = (int)lastTokenProduced<Real>(_audioLoader->output("sampleRate"));
 
@@ -88,6 +92,8 @@ const char* MonoLoader::name = "MonoLoader";
 const char* MonoLoader::category = "Input/output";
 const char* MonoLoader::description = DOC("This algorithm loads the raw audio data from an audio file and downmixes it to mono. Audio is resampled in case the given sampling rate does not match the sampling rate of the input signal.\n"
 "\n"
+"A segment of the file can be loaded by setting the 'startTime' and 'endTime' parameters, in which case decoding starts close to the segment instead of at the beginning of the file (see AudioLoader).\n"
+"\n"
 "This algorithm uses AudioLoader and thus inherits all of its input requirements and exceptions.");
 
 
@@ -107,7 +113,11 @@ void MonoLoader::configure() {
   _loader->configure(INHERIT("filename"),
                      INHERIT("sampleRate"),
                      INHERIT("downmix"),
-                     INHERIT("audioStream"));
+                     INHERIT("audioStream"),
+                     INHERIT("cacheDirectory"),
+                     INHERIT("startTime"),
+                     INHERIT("endTime"),
+                     INHERIT("decodeAhead"));
 }
 
 void MonoLoader::compute() {
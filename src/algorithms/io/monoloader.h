@@ -56,6 +56,10 @@ class MonoLoader : public AlgorithmComposite {
     declareParameter("sampleRate", "the desired output sampling rate [Hz]", "(0,inf)", 44100.);
     declareParameter("downmix", "the mixing type for stereo files", "{left,right,mix}", "mix");
     declareParameter("audioStream", "audio stream index to be loaded. Other streams are no taken into account (e.g. if stream 0 is video and 1 is audio use index 0 to access it.)", "[0,inf)", 0);
+    declareParameter("startTime", "the start time of the segment to load [s]", "[0,inf)", 0.0);
+    declareParameter("endTime", "the end time of the segment to load [s]", "[0,inf)", 1.0e6);
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio (see AudioLoader)", "", "");
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the processing of the audio (see AudioLoader)", "{true,false}", false);
 
   }
 
@@ -109,6 +113,10 @@ class MonoLoader : public Algorithm {
     declareParameter("sampleRate", "the desired output sampling rate [Hz]", "(0,inf)", 44100.);
     declareParameter("downmix", "the mixing type for stereo files", "{left,right,mix}", "mix");
     declareParameter("audioStream", "audio stream index to be loaded. Other streams are no taken into account (e.g. if stream 0 is video and 1 is audio use index 0 to access it.)", "[0,inf)", 0);
+    declareParameter("startTime", "the start time of the segment to load [s]", "[0,inf)", 0.0);
+    declareParameter("endTime", "the end time of the segment to load [s]", "[0,inf)", 1.0e6);
+    declareParameter("cacheDirectory", "directory of the on-disk cache of decoded audio (see AudioLoader)", "", "");
+    declareParameter("decodeAhead", "decode the file on a separate thread, ahead of the processing of the audio (see AudioLoader)", "{true,false}", false);
 
   }
 
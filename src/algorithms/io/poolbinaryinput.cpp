@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include "poolbinaryinput.h"
+#include "poolbinary.h"
+
+using namespace std;
+using namespace essentia;
+using namespace standard;
+
+const char* PoolBinaryInput::name = "PoolBinaryInput";
+const char* PoolBinaryInput::category = "Input/output";
+const char* PoolBinaryInput::description = DOC("This algorithm reads a Pool from a file written by the PoolBinaryOutput algorithm. The file is memory-mapped and its arrays of Reals are copied as a whole into the Pool.\n"
+"\n"
+"An exception is thrown if the file is not a valid binary Pool file, or if it has been written on a machine with a different byte order.");
+
+void PoolBinaryInput::configure() {
+  if (parameter("filename").isConfigured()) {
+    _filename = parameter("filename").toString();
+  }
+}
+
+void PoolBinaryInput::compute() {
+  if (!parameter("filename").isConfigured()) {
+    throw EssentiaException("PoolBinaryInput: 'filename' parameter has not been configured");
+  }
+  if (_filename == "") throw EssentiaException("PoolBinaryInput: please provide a valid filename");
+
+  readPoolBinary(_filename, _pool.get());
+}
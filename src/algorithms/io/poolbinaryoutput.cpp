@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include "poolbinaryoutput.h"
+#include "poolbinary.h"
+#include <fstream>
+
+using namespace std;
+using namespace essentia;
+using namespace standard;
+
+const char* PoolBinaryOutput::name = "PoolBinaryOutput";
+const char* PoolBinaryOutput::category = "Input/output";
+const char* PoolBinaryOutput::description = DOC("This algorithm writes a Pool to a file in a compact binary format, which is much faster to write and to read than the text output of the YamlOutput algorithm, especially for frame-level descriptors.\n"
+"\n"
+"The values of each descriptor are stored as they are laid out in memory, under their full descriptor name, with all the arrays of Reals stored contiguously as 32-bit floats. The file can be read back with the PoolBinaryInput algorithm, or in python with the essentia.poolbinary module, which returns numpy arrays that map the file without copying it. The layout of the file is documented in src/essentia/utils/poolbinary.h.\n"
+"\n"
+"The file is written in the byte order of the machine, and can't be read on a machine with a different byte order.");
+
+void PoolBinaryOutput::configure() {
+  _filename = parameter("filename").toString();
+  if (_filename == "") throw EssentiaException("PoolBinaryOutput: please provide a valid filename");
+}
+
+void PoolBinaryOutput::compute() {
+  const Pool& pool = _pool.get();
+
+  ofstream out(_filename.c_str(), ios::out | ios::binary);
+  if (!out.good()) {
+    throw EssentiaException("PoolBinaryOutput: could not open file for writing: ", _filename);
+  }
+
+  writePoolBinary(pool, out);
+  out.close();
+
+  if (out.fail()) {
+    throw EssentiaException("PoolBinaryOutput: error while writing file: ", _filename);
+  }
+}
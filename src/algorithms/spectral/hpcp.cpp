@@ -231,8 +231,8 @@ void HPCP::compute() {
   hpcp.resize(_size);
   fill(hpcp.begin(), hpcp.end(), (Real)0.0);
 
-  ::essentia::VectorEx<Real> hpcp_LO;
-  ::essentia::VectorEx<Real> hpcp_HI;
+  ::essentia::VectorEx<Real>& hpcp_LO = _hpcpLow;
+  ::essentia::VectorEx<Real>& hpcp_HI = _hpcpHigh;
 
   if (_bandPreset) {
     hpcp_LO.resize(_size);
@@ -301,13 +301,6 @@ void HPCP::compute() {
   // only if this option is enabled.
   if (_maxShifted) {
     int idxMax = argmax(hpcp);
-    ::essentia::VectorEx<Real> hpcp_bak = hpcp;
-    for (int i=idxMax; i<(int)hpcp.size(); i++) {
-      hpcp[i-idxMax] = hpcp_bak[i];
-    }
-    int offset = hpcp.size() - idxMax;
-    for (int i=0; i<idxMax; i++) {
-      hpcp[i+offset] = hpcp_bak[i];
-    }
+    rotate(hpcp.begin(), hpcp.begin() + idxMax, hpcp.end());
   }
 }
@@ -100,6 +100,11 @@ class HPCP : public Algorithm {
   bool _maxShifted;
 
   ::essentia::VectorEx<HarmonicPeak> _harmonicPeaks;
+
+  // low and high bands of the HPCP when using the band preset, kept between
+  // calls so that compute() doesn't allocate
+  ::essentia::VectorEx<Real> _hpcpLow;
+  ::essentia::VectorEx<Real> _hpcpHigh;
 };
 
 } // namespace standard
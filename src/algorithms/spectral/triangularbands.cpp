@@ -19,6 +19,7 @@
 
 #include "triangularbands.h"
 #include "essentiamath.h"
+#include "simd.h"
 
 namespace essentia {
 namespace standard {
@@ -37,6 +38,7 @@ void TriangularBands::configure() {
   _sampleRate = parameter("sampleRate").toReal();
   _normalize = parameter("normalize").toLower();
   _type = parameter("type").toLower();
+  _power = (_type == "power");
   if ( _bandFrequencies.size() < 2 ) {
     throw EssentiaException("TriangularBands: the 'frequencyBands' parameter contains only one element (at least two elements are required)");
   }
@@ -64,34 +66,24 @@ void TriangularBands::compute() {
     throw EssentiaException("TriangularBands: the size of the input spectrum is not greater than one");
   }
 
-  if (_filterCoefficients.empty() || _filterCoefficients[0].size() != spectrum.size()) {
-      E_INFO("TriangularBands: input spectrum size (" << spectrum.size() << ") does not correspond to the \"inputSize\" parameter (" << _filterCoefficients[0].size() << "). Recomputing the filter bank.");
+  if ((int)spectrum.size() != _spectrumSize) {
+      E_INFO("TriangularBands: input spectrum size (" << spectrum.size() << ") does not correspond to the \"inputSize\" parameter (" << _spectrumSize << "). Recomputing the filter bank.");
     createFilters(spectrum.size());
   }
 
-  Real frequencyScale = (_sampleRate / 2.0) / (spectrum.size() - 1);
+  const Real* input = &spectrum[0];
+  if (_power) {
+    _powerSpectrum.resize(spectrum.size());
+    simd::square(&spectrum[0], &_powerSpectrum[0], (int)spectrum.size());
+    input = &_powerSpectrum[0];
+  }
 
   bands.resize(_nBands);
-  fill(bands.begin(), bands.end(), (Real) 0.0);
 
   for (int i=0; i<_nBands; ++i) {
+    const ::essentia::VectorEx<Real>& weights = _filterCoefficients[i];
+    bands[i] = simd::dot(input + _bandBegin[i], weights.data(), (int)weights.size());
 
-    // Find margins for FFT bins to iterate through
-    // (all bins fall inside the triangle and therefore have non-zero weights).
-    int jbegin = ceil(_bandFrequencies[i] / frequencyScale);
-    int jend = floor(_bandFrequencies[i+2] / frequencyScale);
-
-    for (int j=jbegin; j<=jend; ++j) {
-
-      if (_type == "power") {
-        bands[i] += (spectrum[j] * spectrum[j]) * _filterCoefficients[i][j];
-      }
-
-      if (_type == "magnitude") {
-        bands[i] += (spectrum[j]) * _filterCoefficients[i][j];
-      }
-
-    }
     if (_isLog) bands[i] = log2(1 + bands[i]);
   }
   
@@ -120,7 +112,9 @@ void TriangularBands::createFilters(int spectrumSize) {
     throw EssentiaException("TriangularBands: Filter bank cannot be computed from a spectrum with less than 2 bins");
   }
 
-  _filterCoefficients = ::essentia::VectorEx<::essentia::VectorEx<Real> >(_nBands, ::essentia::VectorEx<Real>(spectrumSize, 0.0));
+  _bandBegin.resize(_nBands);
+  _filterCoefficients.resize(_nBands);
+  _spectrumSize = 0; // in case we throw before the end
 
   Real frequencyScale = (_sampleRate / 2.0) / (spectrumSize - 1);
 
@@ -137,18 +131,22 @@ void TriangularBands::createFilters(int spectrumSize) {
       throw EssentiaException("TriangularBands: the 'frequencyBands' parameter contains a value above the Nyquist frequency (", _sampleRate/2, " Hz): ", _bandFrequencies.back());
     }
 
+    _bandBegin[i] = jbegin;
+    ::essentia::VectorEx<Real>& weights = _filterCoefficients[i];
+    weights.assign(max(jend - jbegin + 1, 0), (Real)0.0);
+
     Real weight = 0.;
     for (int j=jbegin; j<=jend; ++j) {
       Real binfreq = j*frequencyScale;
       // in the ascending part of the triangle...
       if (binfreq < _bandFrequencies[i+1]) {
-        _filterCoefficients[i][j] = ((*_weighter)(binfreq) - (*_weighter)(_bandFrequencies[i])) / fstep1;
+        weights[j-jbegin] = ((*_weighter)(binfreq) - (*_weighter)(_bandFrequencies[i])) / fstep1;
       }
       // in the descending part of the triangle...
       else if (binfreq >= _bandFrequencies[i+1]) {
-        _filterCoefficients[i][j] = ((*_weighter)(_bandFrequencies[i+2]) - (*_weighter)(binfreq)) / fstep2;
+        weights[j-jbegin] = ((*_weighter)(_bandFrequencies[i+2]) - (*_weighter)(binfreq)) / fstep2;
       }
-      weight += _filterCoefficients[i][j];
+      weight += weights[j-jbegin];
     }
 
     if (!weight) {
@@ -164,10 +162,12 @@ void TriangularBands::createFilters(int spectrumSize) {
 
     if (_normalize == "unit_sum" || _normalize == "unit_tri") {
       for (int j=jbegin; j<=jend; ++j) {
-        _filterCoefficients[i][j] = _filterCoefficients[i][j] / weight;
+        weights[j-jbegin] = weights[j-jbegin] / weight;
       }
     }
   }
+
+  _spectrumSize = spectrumSize;
 }
 
 void TriangularBands::setWeightingFunctions(std::string weighting) {
@@ -39,10 +39,16 @@ class TriangularBands : public Algorithm {
   int _nBands;
   Real _sampleRate;
   bool _isLog;
+  // the filterbank is stored as a sparse matrix: for each band, the weights
+  // of the bins from _bandBegin[i] on, which are the only non-zero ones
+  ::essentia::VectorEx<int> _bandBegin;
   ::essentia::VectorEx<::essentia::VectorEx<Real> > _filterCoefficients;
+  int _spectrumSize;
+  ::essentia::VectorEx<Real> _powerSpectrum;
   Real _inputSize;
   std::string _normalize;
   std::string _type;
+  bool _power;
   void createFilters(int spectrumSize);
   void setWeightingFunctions(std::string weighting);
 
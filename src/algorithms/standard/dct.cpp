@@ -19,6 +19,7 @@
 
 #include "dct.h"
 #include "essentiamath.h"
+#include "simd.h"
 
 using namespace std;
 using namespace essentia;
@@ -149,10 +150,7 @@ void DCT::compute() {
   dct.resize(_outputSize);
 
   for (int i=0; i<_outputSize; ++i) {
-    dct[i] = 0.0;
-    for (int j=0; j<inputSize; ++j) {
-      dct[i] += array[j] * _dctTable[i][j];
-    }
+    dct[i] = simd::dot(array.data(), _dctTable[i].data(), inputSize);
   }
 
   if (_lifter != 0.0){
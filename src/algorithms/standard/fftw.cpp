@@ -19,6 +19,7 @@
 
 #include "fftw.h"
 #include "essentia.h"
+#include <cstdlib>
 
 using namespace std;
 using namespace essentia;
@@ -37,6 +38,96 @@ const char* FFTW::description = DOC("This algorithm computes the positive comple
 
 ForcedMutex FFTW::globalFFTWMutex;
 
+
+FFTWPlanCache& FFTWPlanCache::instance() {
+  // never destroyed, as algorithms using the plans might outlive static objects
+  static FFTWPlanCache* cache = new FFTWPlanCache();
+  return *cache;
+}
+
+FFTWPlanCache::FFTWPlanCache() : _plannerFlags(FFTW_ESTIMATE) {
+  const char* planner = getenv("ESSENTIA_FFTW_PLANNER");
+  if (planner) {
+    string effort = toLower(planner);
+    if (effort == "measure") _plannerFlags = FFTW_MEASURE;
+    else if (effort == "patient") _plannerFlags = FFTW_PATIENT;
+    else if (effort != "estimate") {
+      E_WARNING("FFTWPlanCache: unknown ESSENTIA_FFTW_PLANNER value '" << planner << "', using 'estimate'");
+    }
+  }
+
+  const char* wisdom = getenv("ESSENTIA_FFTW_WISDOM");
+  if (wisdom) {
+    _wisdomFile = wisdom;
+    // the file doesn't exist the first time, nothing to complain about
+    importWisdom(_wisdomFile);
+  }
+}
+
+fftwf_plan FFTWPlanCache::plan(Type type, int size) {
+  ForcedMutexLocker lock(FFTW::globalFFTWMutex);
+
+  pair<int, int> key(type, size);
+  map<pair<int, int>, fftwf_plan>::const_iterator it = _plans.find(key);
+  if (it != _plans.end()) return it->second;
+
+  // plan on temporary arrays: they are overwritten when measuring, and the
+  // algorithms execute the plans on their own arrays anyway. The output is
+  // big enough for all types
+  void* input = fftwf_malloc(sizeof(complex<Real>)*size);
+  void* output = fftwf_malloc(sizeof(complex<Real>)*size);
+
+  fftwf_plan p = 0;
+  switch (type) {
+    case RealForward:
+      p = fftwf_plan_dft_r2c_1d(size, (Real*)input, (fftwf_complex*)output, _plannerFlags);
+      break;
+    case RealBackward:
+      p = fftwf_plan_dft_c2r_1d(size, (fftwf_complex*)input, (Real*)output, _plannerFlags);
+      break;
+    case ComplexForward:
+      p = fftwf_plan_dft_1d(size, (fftwf_complex*)input, (fftwf_complex*)output, FFTW_FORWARD, _plannerFlags);
+      break;
+    case ComplexBackward:
+      p = fftwf_plan_dft_1d(size, (fftwf_complex*)input, (fftwf_complex*)output, FFTW_BACKWARD, _plannerFlags);
+      break;
+  }
+
+  fftwf_free(input);
+  fftwf_free(output);
+
+  if (!p) {
+    throw EssentiaException("FFTWPlanCache: could not create a plan for size ", size);
+  }
+  _plans[key] = p;
+
+  // planning with estimate doesn't generate any wisdom worth saving
+  if (!_wisdomFile.empty() && _plannerFlags != FFTW_ESTIMATE) {
+    exportWisdom(_wisdomFile);
+  }
+
+  return p;
+}
+
+void FFTWPlanCache::setPlannerFlags(unsigned flags) {
+  ForcedMutexLocker lock(FFTW::globalFFTWMutex);
+  _plannerFlags = flags;
+}
+
+bool FFTWPlanCache::importWisdom(const string& filename) {
+  // fftwf_import_wisdom_from_filename also returns 0 if the file doesn't exist
+  return fftwf_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+bool FFTWPlanCache::exportWisdom(const string& filename) {
+  if (!fftwf_export_wisdom_to_filename(filename.c_str())) {
+    E_WARNING("FFTWPlanCache: could not write FFTW wisdom to " << filename);
+    return false;
+  }
+  return true;
+}
+
+
 FFTW::~FFTW() {
   ForcedMutexLocker lock(globalFFTWMutex);
 
@@ -45,7 +136,6 @@ FFTW::~FFTW() {
   // This will cause a memory leak then, but it is definitely a better choice
   // than a crash (right, right??? :-) )
   if (essentia::isInitialized()) {
-    fftwf_destroy_plan(_fftPlan);
     fftwf_free(_input);
     fftwf_free(_output);
   }
@@ -67,14 +157,23 @@ void FFTW::compute() {
     createFFTObject(size);
   }
 
+  fft.resize(size/2+1);
+
+  // r2c plans don't overwrite their input, so the fft can be computed
+  // directly from the input frame into the output vector if they are aligned,
+  // which saves copying them in and out of our own arrays
+  if (isAligned(&signal[0]) && isAligned(&fft[0])) {
+    fftwf_execute_dft_r2c(_fftPlan, const_cast<Real*>(&signal[0]), (fftwf_complex*)&fft[0]);
+    return;
+  }
+
   // copy input into plan
   memcpy(_input, &signal[0], size*sizeof(Real));
 
   // calculate the fft
-  fftwf_execute(_fftPlan);
+  fftwf_execute_dft_r2c(_fftPlan, _input, (fftwf_complex*)_output);
 
   // copy result from plan to output vector
-  fft.resize(size/2+1);
   memcpy(&fft[0], _output, (size/2+1)*sizeof(complex<Real>));
 
 }
@@ -84,8 +183,6 @@ void FFTW::configure() {
 }
 
 void FFTW::createFFTObject(int size) {
-  ForcedMutexLocker lock(globalFFTWMutex);
-
   // This is only needed because at the moment we return half of the spectrum,
   // which means that there are 2 different input signals that could yield the
   // same FFT...
@@ -93,16 +190,16 @@ void FFTW::createFFTObject(int size) {
     throw EssentiaException("FFT: can only compute FFT of arrays which have an even size");
   }
 
+  // get the plan first, as the cache takes the lock itself
+  _fftPlan = FFTWPlanCache::instance().plan(FFTWPlanCache::RealForward, size);
+
+  ForcedMutexLocker lock(globalFFTWMutex);
+
   // create the temporary storage array
   fftwf_free(_input);
   fftwf_free(_output);
   _input = (Real*)fftwf_malloc(sizeof(Real)*size);
   _output = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
 
-  if (_fftPlan != 0) {
-    fftwf_destroy_plan(_fftPlan);
-  }
-
-  _fftPlan = fftwf_plan_dft_r2c_1d(size, _input, (fftwf_complex*)_output, FFTW_ESTIMATE);
   _fftPlanSize = size;
 }
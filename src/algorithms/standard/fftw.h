@@ -22,12 +22,59 @@
 
 #include "algorithm.h"
 #include "threading.h"
+#include <map>
 #include <complex>
 #include <fftw3.h>
 
 namespace essentia {
 namespace standard {
 
+/**
+ * Process-wide cache of the FFTW plans, shared by all the FFTW-based
+ * algorithms (FFT, IFFT, FFTC, IFFTC), so that a plan is created only once
+ * per size and direction instead of once per algorithm instance and size
+ * change. The algorithms execute the shared plans on their own buffers (plans
+ * are thread-safe to execute, only their creation needs to be serialized).
+ *
+ * Plans are created with FFTW_ESTIMATE by default. Setting the environment
+ * variable ESSENTIA_FFTW_PLANNER to "measure" or "patient" makes FFTW time
+ * several algorithms instead, which is slower to plan but gives faster
+ * transforms. As this only pays off if the planning is done once per machine,
+ * the environment variable ESSENTIA_FFTW_WISDOM can be set to the path of a
+ * wisdom file, which is imported when the cache is first used and updated
+ * every time a new plan has been created.
+ */
+class FFTWPlanCache {
+ public:
+  enum Type {
+    RealForward,     // r2c
+    RealBackward,    // c2r
+    ComplexForward,  // c2c, FFTW_FORWARD
+    ComplexBackward  // c2c, FFTW_BACKWARD
+  };
+
+  static FFTWPlanCache& instance();
+
+  /**
+   * Returns the plan of the given type for the given size, creating it if
+   * needed. The plan is for out-of-place transforms on arrays allocated with
+   * fftwf_malloc(), and must be executed with the new-array execute functions.
+   * The cache keeps the ownership of the plan.
+   */
+  fftwf_plan plan(Type type, int size);
+
+  void setPlannerFlags(unsigned flags);
+  bool importWisdom(const std::string& filename);
+  bool exportWisdom(const std::string& filename);
+
+ protected:
+  FFTWPlanCache();
+
+  std::map<std::pair<int, int>, fftwf_plan> _plans;
+  unsigned _plannerFlags;
+  std::string _wisdomFile;
+};
+
 class FFTW : public Algorithm {
 
  protected:
@@ -57,9 +104,18 @@ class FFTW : public Algorithm {
   friend class IFFTW;
   friend class FFTWComplex;
   friend class IFFTWComplex;
+  friend class FFTWPlanCache;
   static ForcedMutex globalFFTWMutex;
 
-  fftwf_plan _fftPlan;
+  // whether the plans can be executed directly on an array, i.e. whether it is
+  // aligned like the fftwf_malloc'ed arrays the plans have been created on.
+  // This is the case for the data owned by VectorEx<Real> and
+  // VectorEx<complex<Real> >, see VectorExAllocator
+  static bool isAligned(const void* p) {
+    return fftwf_alignment_of((float*)p) == 0;
+  }
+
+  fftwf_plan _fftPlan;  // owned by the FFTWPlanCache
   int _fftPlanSize;
   Real* _input;
   std::complex<Real>* _output;
@@ -45,7 +45,6 @@ FFTWComplex::~FFTWComplex() {
   // This will cause a memory leak then, but it is definitely a better choice
   // than a crash (right, right??? :-) )
   if (essentia::isInitialized()) {
-    fftwf_destroy_plan(_fftPlan);
     fftwf_free(_input);
     fftwf_free(_output);
   }
@@ -67,11 +66,22 @@ void FFTWComplex::compute() {
     createFFTObject(size);
   }
 
+  // compute the fft directly from the input into the output vector if they
+  // are aligned and distinct (the plans are out-of-place), and only keep the
+  // positive frequencies afterwards
+  fft.resize(size);
+  if (FFTW::isAligned(&signal[0]) && FFTW::isAligned(&fft[0]) && &signal[0] != &fft[0]) {
+    fftwf_execute_dft(_fftPlan, (fftwf_complex*)const_cast<complex<Real>*>(&signal[0]),
+                      (fftwf_complex*)&fft[0]);
+    if (!_negativeFrequencies) fft.resize(size/2+1);
+    return;
+  }
+
   // copy input into plan
   memcpy(_input, &signal[0], size*sizeof(complex<Real>));
 
   // calculate the fft
-  fftwf_execute(_fftPlan);
+  fftwf_execute_dft(_fftPlan, (fftwf_complex*)_input, (fftwf_complex*)_output);
 
   // copy result from plan to output vector
   if (_negativeFrequencies){
@@ -90,8 +100,6 @@ void FFTWComplex::configure() {
 }
 
 void FFTWComplex::createFFTObject(int size) {
-  ForcedMutexLocker lock(FFTW::globalFFTWMutex);
-
   // This is only needed because at the moment we return half of the spectrum,
   // which means that there are 2 different input signals that could yield the
   // same FFT...
@@ -99,16 +107,16 @@ void FFTWComplex::createFFTObject(int size) {
     throw EssentiaException("FFT: can only compute FFT of arrays which have an even size");
   }
 
+  // get the plan first, as the cache takes the lock itself
+  _fftPlan = FFTWPlanCache::instance().plan(FFTWPlanCache::ComplexForward, size);
+
+  ForcedMutexLocker lock(FFTW::globalFFTWMutex);
+
   // create the temporary storage array
   fftwf_free(_input);
   fftwf_free(_output);
   _input = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
   _output = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
 
-  if (_fftPlan != 0) {
-    fftwf_destroy_plan(_fftPlan);
-  }
-
-  _fftPlan = fftwf_plan_dft_1d(size, (fftwf_complex*)_input, (fftwf_complex*)_output, FFTW_FORWARD, FFTW_ESTIMATE);
   _fftPlanSize = size;
 }
@@ -40,7 +40,6 @@ const char* IFFTW::description = DOC("This algorithm calculates the inverse shor
 IFFTW::~IFFTW() {
   ForcedMutexLocker lock(FFTW::globalFFTWMutex);
 
-  fftwf_destroy_plan(_fftPlan);
   fftwf_free(_input);
   fftwf_free(_output);
 }
@@ -63,12 +62,19 @@ void IFFTW::compute() {
   // copy input into plan
   memcpy(_input, &fft[0], (size/2+1)*sizeof(complex<Real>));
 
-  // calculate the fft
-  fftwf_execute(_fftPlan);
-
-  // copy result from plan to output vector
+  // c2r plans overwrite their input, so it always has to be copied, but the
+  // output can be written directly into the output vector if it is aligned
   signal.resize(size);
-  memcpy(&signal[0], _output, size*sizeof(Real));
+  if (FFTW::isAligned(&signal[0])) {
+    fftwf_execute_dft_c2r(_fftPlan, (fftwf_complex*)_input, &signal[0]);
+  }
+  else {
+    // calculate the fft
+    fftwf_execute_dft_c2r(_fftPlan, (fftwf_complex*)_input, _output);
+
+    // copy result from plan to output vector
+    memcpy(&signal[0], _output, size*sizeof(Real));
+  }
 
   if (_normalize) {
     Real norm = (Real)size;
@@ -85,6 +91,9 @@ void IFFTW::configure() {
 }
 
 void IFFTW::createFFTObject(int size) {
+  // get the plan first, as the cache takes the lock itself
+  _fftPlan = FFTWPlanCache::instance().plan(FFTWPlanCache::RealBackward, size);
+
   ForcedMutexLocker lock(FFTW::globalFFTWMutex);
 
   // create the temporary storage array
@@ -93,12 +102,6 @@ void IFFTW::createFFTObject(int size) {
   _input = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
   _output = (Real*)fftwf_malloc(sizeof(Real)*size);
 
-  if (_fftPlan != 0) {
-    fftwf_destroy_plan(_fftPlan);
-  }
-
-  //_fftPlan = fftwf_plan_dft_c2r_1d(size, (fftwf_complex*)_input, _output, FFTW_MEASURE);
-  _fftPlan = fftwf_plan_dft_c2r_1d(size, (fftwf_complex*)_input, _output, FFTW_ESTIMATE);
   _fftPlanSize = size;
 
 }
@@ -56,7 +56,7 @@ class IFFTW : public Algorithm {
   static const char* description;
 
  protected:
-  fftwf_plan _fftPlan;
+  fftwf_plan _fftPlan;  // owned by the FFTWPlanCache
   int _fftPlanSize;
   std::complex<Real>* _input;
   Real* _output;
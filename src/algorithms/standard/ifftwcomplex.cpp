@@ -40,7 +40,6 @@ const char* IFFTWComplex::description = DOC("This algorithm calculates the inver
 IFFTWComplex::~IFFTWComplex() {
   ForcedMutexLocker lock(FFTW::globalFFTWMutex);
 
-  fftwf_destroy_plan(_fftPlan);
   fftwf_free(_input);
   fftwf_free(_output);
 }
@@ -60,15 +59,24 @@ void IFFTWComplex::compute() {
     createFFTObject(size);
   }
 
-  // copy input into plan
-  memcpy(_input, &fft[0], size*sizeof(complex<Real>));
+  // compute the ifft directly from the input into the output vector if they
+  // are aligned and distinct (the plans are out-of-place), otherwise go
+  // through our own arrays
+  signal.resize(size);
+  if (FFTW::isAligned(&fft[0]) && FFTW::isAligned(&signal[0]) && &fft[0] != &signal[0]) {
+    fftwf_execute_dft(_fftPlan, (fftwf_complex*)const_cast<complex<Real>*>(&fft[0]),
+                      (fftwf_complex*)&signal[0]);
+  }
+  else {
+    // copy input into plan
+    memcpy(_input, &fft[0], size*sizeof(complex<Real>));
 
-  // calculate the fft
-  fftwf_execute(_fftPlan);
+    // calculate the fft
+    fftwf_execute_dft(_fftPlan, (fftwf_complex*)_input, (fftwf_complex*)_output);
 
-  // copy result from plan to output vector
-  signal.resize(size);
-  memcpy(&signal[0], _output, size*sizeof(complex<Real>));
+    // copy result from plan to output vector
+    memcpy(&signal[0], _output, size*sizeof(complex<Real>));
+  }
 
   if (_normalize) {
     Real norm = (Real)size;
@@ -85,6 +93,9 @@ void IFFTWComplex::configure() {
 }
 
 void IFFTWComplex::createFFTObject(int size) {
+  // get the plan first, as the cache takes the lock itself
+  _fftPlan = FFTWPlanCache::instance().plan(FFTWPlanCache::ComplexBackward, size);
+
   ForcedMutexLocker lock(FFTW::globalFFTWMutex);
 
   // create the temporary storage array
@@ -93,12 +104,6 @@ void IFFTWComplex::createFFTObject(int size) {
   _input = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
   _output = (complex<Real>*)fftwf_malloc(sizeof(complex<Real>)*size);
 
-  if (_fftPlan != 0) {
-    fftwf_destroy_plan(_fftPlan);
-  }
-
-  //_fftPlan = fftwf_plan_dft_c2r_1d(size, (fftwf_complex*)_input, _output, FFTW_MEASURE);
-  _fftPlan = fftwf_plan_dft_1d(size, (fftwf_complex*)_input, (fftwf_complex*)_output, FFTW_BACKWARD, FFTW_ESTIMATE);
   _fftPlanSize = size;
 
 }
@@ -57,7 +57,7 @@ class IFFTWComplex : public Algorithm {
   static const char* description;
 
  protected:
-  fftwf_plan _fftPlan;
+  fftwf_plan _fftPlan;  // owned by the FFTWPlanCache
   int _fftPlanSize;
   std::complex<Real>* _input;
   std::complex<Real>* _output;
@@ -19,7 +19,6 @@
 
 #include "peakdetection.h"
 #include "essentiamath.h"
-#include "peak.h"
 
 using namespace essentia;
 using namespace standard;
@@ -74,7 +73,8 @@ void PeakDetection::compute() {
   // which makes more sense in general?
   const Real scale = _range / (Real)(size - 1);
 
-  ::essentia::VectorEx<Peak> peaks;
+  ::essentia::VectorEx<Peak>& peaks = _peaks;
+  peaks.clear();
   peaks.reserve(size);
 
   // we want to round up to the next integer instead of simple truncation,
@@ -170,7 +170,8 @@ void PeakDetection::compute() {
   // remove peaks that are closer than 'minPeakDistance'
   if (_minPeakDistance > 0 && peaks.size() > 1) {
     
-    ::essentia::VectorEx<int> deletedPeaks;
+    ::essentia::VectorEx<int>& deletedPeaks = _deletedPeaks;
+    deletedPeaks.clear();
     deletedPeaks.reserve(peaks.size());
     Real minPos;
     Real maxPos;
@@ -21,6 +21,7 @@
 #define ESSENTIA_PEAKDETECTION_H
 
 #include "algorithm.h"
+#include "peak.h"
 
 namespace essentia {
 namespace standard {
@@ -41,6 +42,10 @@ class PeakDetection : public Algorithm {
   std::string _orderBy;
   Real _minPeakDistance;
 
+  // scratch buffers, kept between calls so that compute() doesn't allocate
+  ::essentia::VectorEx<util::Peak> _peaks;
+  ::essentia::VectorEx<int> _deletedPeaks;
+
  public:
   PeakDetection() {
     declareInput(_array, "array", "the input array");
@@ -18,6 +18,7 @@
  */
 
 #include "powerspectrum.h"
+#include "simd.h"
 
 using namespace essentia;
 using namespace standard;
@@ -53,8 +54,5 @@ void PowerSpectrum::compute() {
 
   // ...and then the square magnitude of it
   powerSpectrum.resize(_fftBuffer.size());
-  for (int i=0; i<int(_fftBuffer.size()); ++i) {
-    powerSpectrum[i] = _fftBuffer[i].real()*_fftBuffer[i].real() +
-                       _fftBuffer[i].imag()*_fftBuffer[i].imag();
-  }
+  simd::power(_fftBuffer.data(), powerSpectrum.data(), (int)_fftBuffer.size());
 }
@@ -19,6 +19,7 @@
 
 #include "windowing.h"
 #include "essentiamath.h"
+#include "simd.h"
 
 using namespace std;
 using namespace essentia;
@@ -62,10 +63,18 @@ void Windowing::createWindow(const std::string& windowtype) {
 }
 
 void Windowing::compute() {
+  window(_frame.get(), _windowedFrame.get());
+}
 
-  const ::essentia::VectorEx<Real>& signal = _frame.get();
-  ::essentia::VectorEx<Real>& windowedSignal = _windowedFrame.get();
+void Windowing::computeBatch(int n) {
+  // the frames are windowed in a row, without the wrapper having to rebind
+  // the input and output between each of them
+  for (int i=0; i<n; i++) {
+    window(_frame.get(i), _windowedFrame.get(i));
+  }
+}
 
+void Windowing::window(const ::essentia::VectorEx<Real>& signal, ::essentia::VectorEx<Real>& windowedSignal) {
   if (signal.size() <= 1) {
     throw EssentiaException("Windowing: frame size should be larger than 1");
   }
@@ -80,35 +89,28 @@ void Windowing::compute() {
 
   windowedSignal.resize(totalSize);
 
-  int i = 0;
+  Real* out = windowedSignal.data();
+  int half = signalSize/2;
 
   if (_zeroPhase) {
     // first half of the windowed signal is the
     // second half of the signal with windowing!
-    for (int j=signalSize/2; j<signalSize; j++) {
-      windowedSignal[i++] = signal[j] * _window[j];
-    }
+    simd::multiply(&signal[half], &_window[half], out, signalSize - half);
+    out += signalSize - half;
 
     // zero padding
-    for (int j=0; j<_zeroPadding; j++) {
-      windowedSignal[i++] = 0.0;
-    }
+    fill(out, out + _zeroPadding, (Real)0.0);
+    out += _zeroPadding;
 
     // second half of the signal
-    for (int j=0; j<signalSize/2; j++) {
-      windowedSignal[i++] = signal[j] * _window[j];
-    }
+    simd::multiply(&signal[0], &_window[0], out, half);
   }
   else {
     // windowed signal
-    for (int j=0; j<signalSize; j++) {
-      windowedSignal[i++] = signal[j] * _window[j];
-    }
+    simd::multiply(&signal[0], &_window[0], out, signalSize);
 
     // zero padding
-    for (int j=0; j<_zeroPadding; j++) {
-      windowedSignal[i++] = 0.0;
-    }
+    fill(out + signalSize, out + totalSize, (Real)0.0);
   }
 }
 
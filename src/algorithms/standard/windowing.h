@@ -49,11 +49,15 @@ class Windowing : public Algorithm {
 
   void compute();
 
+  bool supportsBatch() const { return true; }
+  void computeBatch(int n);
+
   static const char* name;
   static const char* category;
   static const char* description;
 
 protected:
+  void window(const ::essentia::VectorEx<Real>& signal, ::essentia::VectorEx<Real>& windowedSignal);
   void createWindow(const std::string& windowtype);
 
   // window generators
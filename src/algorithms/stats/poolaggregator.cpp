@@ -22,6 +22,11 @@
 #include "essentiamath.h"
 #include "essentiautil.h"
 #include "tnt/tnt2essentiautils.h"
+#include "runningmoments.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
 
 using namespace std;
 using namespace essentia;
@@ -56,6 +61,8 @@ const char* PoolAggregator::description = DOC("This algorithm performs statistic
 
 "For vectors, if the input pool value consists of only one vector, its aggregation will be skipped, and the vector itself will be added to the output.\n\n"
 
+"The descriptors of the input Pool are independent, and can be aggregated in parallel by setting the 'threads' parameter. The output Pool does not depend on the number of threads.\n\n"
+
 "The 'value' and 'copy' are auxiliary aggregation methods that can be used to copy values in the input Pool to the output Pool without aggregation. In the case of 'last', the last value in the input vector of Reals (or input vector of vectors of Reals) will be taken and saved as a single Real (or single vector of Reals) in the output Pool."
 );
 
@@ -79,6 +86,198 @@ void addMatrixAsVectorVector(Pool& p, const string& key, const TNT::Array2D<Real
   }
 }
 
+namespace {
+
+// The statistics of each column of the frames of a descriptor. Only the ones
+// that have been asked for are computed.
+struct FrameStatistics {
+  bool skip; // frames of different sizes
+  ::essentia::VectorEx<Real> mean, var, stdev, skew, kurt, min, max, median;
+  ::essentia::VectorEx<Real> dmean, dvar, dmean2, dvar2;
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > cov, icov;
+
+  FrameStatistics() : skip(false) {}
+};
+
+// a Real descriptor is aggregated as a sequence of frames of size 1
+class RealFrames {
+ public:
+  RealFrames(const ::essentia::VectorEx<Real>& data) : _data(data) {}
+  int size() const { return (int)_data.size(); }
+  int width() const { return 1; }
+  const Real* operator[](int i) const { return &_data[i]; }
+
+ protected:
+  const ::essentia::VectorEx<Real>& _data;
+};
+
+class VectorRealFrames {
+ public:
+  VectorRealFrames(const ::essentia::VectorEx<::essentia::VectorEx<Real> >& data) : _data(data) {}
+  int size() const { return (int)_data.size(); }
+  int width() const { return (int)_data[0].size(); }
+  const Real* operator[](int i) const { return _data[i].data(); }
+
+ protected:
+  const ::essentia::VectorEx<::essentia::VectorEx<Real> >& _data;
+};
+
+bool containsAny(const ::essentia::VectorEx<string>& stats, const char* a, const char* b) {
+  return contains(stats, string(a)) || contains(stats, string(b));
+}
+
+// Computes the statistics of all the columns in a single pass over the
+// frames, including the ones of the absolute values of their derivatives,
+// which therefore never need to be stored. The median is the only statistic
+// needing the values of a column, which are then partially sorted.
+template <typename Frames>
+void computeFrameStatistics(const Frames& frames,
+                            const ::essentia::VectorEx<string>& stats,
+                            FrameStatistics& result) {
+  int dsize = frames.size();
+  int vsize = frames.width();
+
+  bool moments = containsAny(stats, "mean", "var") || containsAny(stats, "stdev", "skew") || contains(stats, string("kurt"));
+  bool minmax = containsAny(stats, "min", "max");
+  bool derived = containsAny(stats, "dmean", "dvar");
+  bool derived2 = containsAny(stats, "dmean2", "dvar2");
+
+  ::essentia::VectorEx<util::RunningMoments> m(moments ? vsize : 0);
+  ::essentia::VectorEx<util::RunningMoments> d(derived ? vsize : 0);
+  ::essentia::VectorEx<util::RunningMoments> d2(derived2 ? vsize : 0);
+
+  if (minmax) {
+    result.min.resize(vsize);
+    result.max.resize(vsize);
+    for (int j=0; j<vsize; ++j) result.min[j] = result.max[j] = frames[0][j];
+  }
+
+  for (int i=0; i<dsize; ++i) {
+    const Real* x = frames[i];
+
+    if (moments) {
+      for (int j=0; j<vsize; ++j) m[j].add(x[j]);
+    }
+
+    if (minmax) {
+      for (int j=0; j<vsize; ++j) {
+        result.min[j] = min(x[j], result.min[j]);
+        result.max[j] = max(x[j], result.max[j]);
+      }
+    }
+
+    // the absolute values are taken before computing the variance, so that
+    // the mean and the variance of the derivatives are consistent
+    if ((derived || derived2) && i > 0) {
+      const Real* prev = frames[i-1];
+      const Real* prev2 = i > 1 ? frames[i-2] : 0;
+      for (int j=0; j<vsize; ++j) {
+        Real diff = x[j] - prev[j];
+        if (derived) d[j].add(abs(diff));
+        if (derived2 && prev2) d2[j].add(abs(diff - (prev[j] - prev2[j])));
+      }
+    }
+  }
+
+  if (moments) {
+    result.mean.resize(vsize);
+    result.var.resize(vsize);
+    result.stdev.resize(vsize);
+    result.skew.resize(vsize);
+    result.kurt.resize(vsize);
+    for (int j=0; j<vsize; ++j) {
+      result.mean[j] = (Real)m[j].mean();
+      result.var[j] = (Real)m[j].variance();
+      result.stdev[j] = sqrt(result.var[j]);
+      result.skew[j] = (Real)m[j].skewness();
+      result.kurt[j] = (Real)m[j].kurtosis();
+    }
+  }
+
+  // with less than 2 (resp. 3) frames, there is no derivative and its
+  // statistics are those of a single 0 value
+  if (derived) {
+    result.dmean.resize(vsize);
+    result.dvar.resize(vsize);
+    for (int j=0; j<vsize; ++j) {
+      result.dmean[j] = (Real)d[j].mean();
+      result.dvar[j] = (Real)d[j].variance();
+    }
+  }
+
+  if (derived2) {
+    result.dmean2.resize(vsize);
+    result.dvar2.resize(vsize);
+    for (int j=0; j<vsize; ++j) {
+      result.dmean2[j] = (Real)d2[j].mean();
+      result.dvar2[j] = (Real)d2[j].variance();
+    }
+  }
+
+  if (contains(stats, string("median"))) {
+    result.median.resize(vsize);
+    ::essentia::VectorEx<Real> column(dsize);
+    int half = dsize / 2;
+    for (int j=0; j<vsize; ++j) {
+      for (int i=0; i<dsize; ++i) column[i] = frames[i][j];
+      nth_element(column.begin(), column.begin() + half, column.end());
+      result.median[j] = column[half];
+      if (dsize % 2 == 0) {
+        // the lower middle value is the largest one of the lower half
+        Real lower = *max_element(column.begin(), column.begin() + half);
+        result.median[j] = (lower + column[half]) / 2;
+      }
+    }
+  }
+
+  // only compute cov and icov matrix if asked, because it could throw an
+  // exception if matrix is singular...
+  if (containsAny(stats, "cov", "icov")) {
+
+    // create an Array2D and copy all the data values into it
+    TNT::Array2D<Real> array(dsize, vsize);
+    for (int i=0; i<dsize; i++) {
+      for (int j=0; j<vsize; j++) {
+        array[i][j] = frames[i][j];
+      }
+    }
+
+    ::essentia::VectorEx<Real> framesMean; // not used
+    TNT::Array2D<Real> covTnt, icovTnt;
+
+    Algorithm* sg = AlgorithmFactory::create("SingleGaussian");
+    sg->input("matrix").set(array);
+    sg->output("mean").set(framesMean);
+    sg->output("covariance").set(covTnt);
+    sg->output("inverseCovariance").set(icovTnt);
+
+    try {
+      sg->compute();
+    }
+    catch (...) {
+      delete sg;
+      throw;
+    }
+
+    delete sg;
+
+    // convert the Array2D back into ::essentia::VectorEx<::essentia::VectorEx<Real> >
+    int covSize = covTnt.dim1();
+    result.cov.resize(vsize);
+    result.icov.resize(vsize);
+    for (int i=0; i<covSize; ++i) {
+      result.cov[i].resize(covSize);
+      result.icov[i].resize(covSize);
+      for (int j=0; j<covSize; ++j) {
+        result.cov[i][j] = covTnt[i][j];
+        result.icov[i][j] = icovTnt[i][j];
+      }
+    }
+  }
+}
+
+} // namespace
+
 
 void PoolAggregator::aggregateSingleRealPool(const Pool& input, Pool& output) {
   const map<string, Real>& realPool = input.getSingleRealPool();
@@ -93,72 +292,49 @@ void PoolAggregator::aggregateSingleRealPool(const Pool& input, Pool& output) {
 }
 
 void PoolAggregator::aggregateRealPool(const Pool& input, Pool& output) {
-  PoolOf(Real) realPool = input.getRealPool();
+  const PoolOf(Real)& realPool = input.getRealPool();
 
+  ::essentia::VectorEx<PoolOf(Real)::const_iterator> descriptors;
   for (PoolOf(Real)::const_iterator it = realPool.begin();
        it != realPool.end();
        ++it) {
-    string key = it->first;
-    ::essentia::VectorEx<Real> data = it->second;
-    int dsize = int(data.size());
-
-    // mean, variance, and standard deviation
-    Real meanVal = mean(data);
-    Real varianceVal = variance(data, meanVal);
-    Real stdevVal = sqrt(varianceVal);
-
-    // median
-    Real medianVal = median(data);
-
-    // skewness and kurtosis
-    Real skewnessVal = skewness(data, meanVal);
-    Real kurtosisVal = kurtosis(data, meanVal);
-
-    // min and max
-    Real minVal = data[0], maxVal = data[0];
-    for (int i=1; i<dsize; ++i) {
-      minVal = min(minVal, data[i]);
-      maxVal = max(maxVal, data[i]);
-    }
-
-    // derived mean & var
-    ::essentia::VectorEx<Real> derived(dsize > 1 ? dsize-1 : 1, 0.0);
-    ::essentia::VectorEx<Real> derived2(dsize > 2 ? dsize-2 : 1, 0.0);
-
-    for (int i=0; i<dsize-1; ++i) {
-      derived[i] = data[i+1] - data[i];
-    }
-    for (int i=0; i<dsize-2; ++i) {
-      derived2[i] = derived[i+1] - derived[i];
-    }
+    if (!it->second.empty()) descriptors.push_back(it);
+  }
 
-    Real dmeanVal, d2meanVal, dvarianceVal, d2varianceVal;
+  // compute the statistics of all descriptors first, possibly in parallel,
+  // as only adding them to the output pool needs to be done in order
+  ::essentia::VectorEx<FrameStatistics> results(descriptors.size());
+  ::essentia::VectorEx<function<void()> > tasks(descriptors.size());
+  for (int k=0; k<(int)descriptors.size(); ++k) {
+    const ::essentia::VectorEx<Real>& data = descriptors[k]->second;
+    const ::essentia::VectorEx<string>& stats = getStats(descriptors[k]->first);
+    FrameStatistics& result = results[k];
+    tasks[k] = [&data, &stats, &result]() {
+      computeFrameStatistics(RealFrames(data), stats, result);
+    };
+  }
+  runTasks(tasks);
 
-    // we need to perform the absolute value conversion before taking the
-    // variance so that the mean and variance caclulation both use the absolute
-    // value technique and thus consistent
-    for (int i=0; i<(int)derived.size(); i++) derived[i] = abs(derived[i]);
-    for (int i=0; i<(int)derived2.size(); i++) derived2[i] = abs(derived2[i]);
-    dmeanVal = mean(derived);
-    d2meanVal = mean(derived2);
-    dvarianceVal = variance(derived, mean(derived));
-    d2varianceVal = variance(derived2, mean(derived2));
+  for (int k=0; k<(int)descriptors.size(); ++k) {
+    const string& key = descriptors[k]->first;
+    const ::essentia::VectorEx<Real>& data = descriptors[k]->second;
+    const FrameStatistics& r = results[k];
 
     // figure out which computed stats to add to the output pool
     const ::essentia::VectorEx<string>& stats = getStats(key);
     for (int i=0; i<(int)stats.size(); ++i) {
-      if      (stats[i] == "mean")   output.set(key + ".mean", meanVal);
-      else if (stats[i] == "median") output.set(key + ".median", medianVal);
-      else if (stats[i] == "min")    output.set(key + ".min", minVal);
-      else if (stats[i] == "max")    output.set(key + ".max", maxVal);
-      else if (stats[i] == "var")    output.set(key + ".var", varianceVal);
-      else if (stats[i] == "stdev")  output.set(key + ".stdev", stdevVal);    
-      else if (stats[i] == "skew")   output.set(key + ".skew", skewnessVal);
-      else if (stats[i] == "kurt")   output.set(key + ".kurt", kurtosisVal);
-      else if (stats[i] == "dmean")  output.set(key + ".dmean", dmeanVal);
-      else if (stats[i] == "dvar")   output.set(key + ".dvar", dvarianceVal);
-      else if (stats[i] == "dmean2") output.set(key + ".dmean2", d2meanVal);
-      else if (stats[i] == "dvar2")  output.set(key + ".dvar2", d2varianceVal);
+      if      (stats[i] == "mean")   output.set(key + ".mean", r.mean[0]);
+      else if (stats[i] == "median") output.set(key + ".median", r.median[0]);
+      else if (stats[i] == "min")    output.set(key + ".min", r.min[0]);
+      else if (stats[i] == "max")    output.set(key + ".max", r.max[0]);
+      else if (stats[i] == "var")    output.set(key + ".var", r.var[0]);
+      else if (stats[i] == "stdev")  output.set(key + ".stdev", r.stdev[0]);
+      else if (stats[i] == "skew")   output.set(key + ".skew", r.skew[0]);
+      else if (stats[i] == "kurt")   output.set(key + ".kurt", r.kurt[0]);
+      else if (stats[i] == "dmean")  output.set(key + ".dmean", r.dmean[0]);
+      else if (stats[i] == "dvar")   output.set(key + ".dvar", r.dvar[0]);
+      else if (stats[i] == "dmean2") output.set(key + ".dmean2", r.dmean2[0]);
+      else if (stats[i] == "dvar2")  output.set(key + ".dvar2", r.dvar2[0]);
       else if (stats[i] == "copy") {
         for (int i=0; i<int(data.size()); ++i) {
           output.add(key, data[i]);
@@ -184,192 +360,101 @@ void PoolAggregator::aggregateSingleVectorRealPool(const Pool& input, Pool& outp
        ++it) {
 
     string key = it->first;
-    ::essentia::VectorEx<Real> data = it->second;
+    const ::essentia::VectorEx<Real>& data = it->second;
     output.set(key, data);
   }
 }
 
 void PoolAggregator::aggregateVectorRealPool(const Pool& input, Pool& output) {
-  PoolOf(::essentia::VectorEx<Real>) vectorRealPool = input.getVectorRealPool();
+  const PoolOf(::essentia::VectorEx<Real>)& vectorRealPool = input.getVectorRealPool();
 
+  ::essentia::VectorEx<PoolOf(::essentia::VectorEx<Real>)::const_iterator> descriptors;
   for (PoolOf(::essentia::VectorEx<Real>)::const_iterator it = vectorRealPool.begin();
        it != vectorRealPool.end();
        ++it) {
+    if (!it->second.empty()) descriptors.push_back(it);
+  }
 
-    string key = it->first;
-    ::essentia::VectorEx<::essentia::VectorEx<Real> > data = it->second;
-    int dsize = data.size();
-
-    if (dsize == 0) continue;
-
-    // if pool value consists of only one vector, don't perform aggregation,
-    // just add it to the output
-    //if (dsize == 1) {
-    //  output.add(key, data[0]);
-    //  continue;
-    //}
-
-    int vsize = data[0].size();
-
-    // check if all the vectors are the same size, otherwise skip the descriptor
-    bool skipDescriptor = false;
-    for (int i=1; i<dsize; ++i) {
-      if ((int)data[i].size() != vsize) {
-        E_WARNING("PoolAggregator: not aggregating \"" << key << "\" because it has frames of different sizes");
-        skipDescriptor = true;
-        break;
-      }
-    }
-    if (skipDescriptor) continue;
-
-
-    // mean & var
-    ::essentia::VectorEx<Real> meanVals = meanFrames(data);
-    ::essentia::VectorEx<Real> varVals = varianceFrames(data);
-
-    // stdev
-    ::essentia::VectorEx<Real> stdevVals(varVals);
-    std::transform(stdevVals.begin(), stdevVals.end(), stdevVals.begin(), static_cast<Real (*)(Real)>(std::sqrt));
-
-    // median
-    ::essentia::VectorEx<Real> medianVals = medianFrames(data);
-
-    // skewness & kurtosis
-    ::essentia::VectorEx<Real> skewnessVals = skewnessFrames(data);
-    ::essentia::VectorEx<Real> kurtosisVals = kurtosisFrames(data);
-
-    // min & max
-    ::essentia::VectorEx<Real> minVals(vsize, 0.0), maxVals(vsize, 0.0);
-    for (int j=0; j<vsize; j++) minVals[j] = maxVals[j] = data[0][j]; // init values
-    for (int i=1; i<dsize; i++) {
-      for (int j=0; j<vsize; j++) {
-        minVals[j] = min(data[i][j], minVals[j]);
-        maxVals[j] = max(data[i][j], maxVals[j]);
-      }
-    }
-
-    // derived mean & var
-    ::essentia::VectorEx<::essentia::VectorEx<Real> > derived(dsize > 1 ? dsize-1 : 1, ::essentia::VectorEx<Real>(vsize, 0.0));
-    ::essentia::VectorEx<::essentia::VectorEx<Real> > derived2(dsize > 2 ? dsize-2 : 1, ::essentia::VectorEx<Real>(vsize, 0.0));
-
-    // first derivative
-    for (int i=0; i<dsize-1; i++) {
-      for (int j=0; j<vsize; j++) {
-        derived[i][j] += data[i+1][j] - data[i][j];
-      }
-    }
-
-    // second derivative
-    for (int i=0; i<dsize-2; i++) {
-      for (int j=0; j<vsize; j++) {
-        derived2[i][j] += derived[i+1][j] - derived[i][j];
-      }
-    }
-
-    for (int i=0; i<int(derived.size()); i++) {
-      for (int j=0; j<int(derived[i].size()); j++) {
-        derived[i][j] = abs(derived[i][j]);
-      }
-    }
-
-    for (int i=0; i<int(derived2.size()); i++) {
-      for (int j=0; j<int(derived2[i].size()); j++) {
-        derived2[i][j] = abs(derived2[i][j]);
-      }
-    }
-
-    ::essentia::VectorEx<Real> dmeanVals = meanFrames(derived);
-    ::essentia::VectorEx<Real> d2meanVals = meanFrames(derived2);
-    ::essentia::VectorEx<Real> dvarVals = varianceFrames(derived);
-    ::essentia::VectorEx<Real> d2varVals = varianceFrames(derived2);
-
-    // only compute cov and icov matrix if asked, because it could throw an
-    // exception if matrix is singular...
-    const ::essentia::VectorEx<string>& stats = getStats(key);
-
-    ::essentia::VectorEx<::essentia::VectorEx<Real> > cov(vsize), icov(vsize);
-
-    if (contains(stats, string("cov")) || contains(stats, string("icov"))) {
-
-      // create an Array2D and copy all the data values into it
-      TNT::Array2D<Real> frames(dsize, vsize);
-      for (int i=0; i<dsize; i++) {
-        for (int j=0; j<vsize; j++) {
-          frames[i][j] = data[i][j];
+  // compute the statistics of all descriptors first, possibly in parallel,
+  // as only adding them to the output pool needs to be done in order
+  ::essentia::VectorEx<FrameStatistics> results(descriptors.size());
+  ::essentia::VectorEx<function<void()> > tasks(descriptors.size());
+  for (int k=0; k<(int)descriptors.size(); ++k) {
+    const ::essentia::VectorEx<::essentia::VectorEx<Real> >& data = descriptors[k]->second;
+    const ::essentia::VectorEx<string>& stats = getStats(descriptors[k]->first);
+    FrameStatistics& result = results[k];
+    tasks[k] = [&data, &stats, &result]() {
+      // check if all the vectors are the same size, otherwise skip the descriptor
+      int vsize = data[0].size();
+      for (int i=1; i<(int)data.size(); ++i) {
+        if ((int)data[i].size() != vsize) {
+          result.skip = true;
+          return;
         }
       }
+      computeFrameStatistics(VectorRealFrames(data), stats, result);
+    };
+  }
+  runTasks(tasks);
 
-      ::essentia::VectorEx<Real> framesMean; // not used
-      TNT::Array2D<Real> covTnt, icovTnt;
-
-      Algorithm* sg = AlgorithmFactory::create("SingleGaussian");
-      sg->input("matrix").set(frames);
-      sg->output("mean").set(framesMean);
-      sg->output("covariance").set(covTnt);
-      sg->output("inverseCovariance").set(icovTnt);
+  for (int k=0; k<(int)descriptors.size(); ++k) {
+    const string& key = descriptors[k]->first;
+    const ::essentia::VectorEx<::essentia::VectorEx<Real> >& data = descriptors[k]->second;
+    const FrameStatistics& r = results[k];
 
-      sg->compute();
-
-      delete sg;
-
-      // convert the Array2D back into ::essentia::VectorEx<::essentia::VectorEx<Real> >
-      //for (int i=0; i<dsize; ++i) {
-      int covSize = covTnt.dim1();
-      for (int i=0; i<covSize; ++i) {
-        cov[i].resize(covSize);
-        icov[i].resize(covSize);
-        for (int j=0; j<covSize; ++j) {
-          cov[i][j] = covTnt[i][j];
-          icov[i][j] = icovTnt[i][j];
-        }
-      }
+    if (r.skip) {
+      E_WARNING("PoolAggregator: not aggregating \"" << key << "\" because it has frames of different sizes");
+      continue;
     }
 
+    int vsize = data[0].size();
+
     // Now add all the computed statistics into the output pool
+    const ::essentia::VectorEx<string>& stats = getStats(key);
     for (int i=0; i<(int)stats.size(); ++i) {
       string subkey = key + "." + stats[i];
 
       if (stats[i] == "mean")
-        for (int j=0; j<int(meanVals.size()); ++j) output.add(subkey, meanVals[j]);
+        for (int j=0; j<int(r.mean.size()); ++j) output.add(subkey, r.mean[j]);
 
       else if (stats[i] == "median")
-        for (int j=0; j<int(medianVals.size()); ++j) output.add(subkey, medianVals[j]);
-    
+        for (int j=0; j<int(r.median.size()); ++j) output.add(subkey, r.median[j]);
+
       else if (stats[i] == "min")
-        for (int j=0; j<int(minVals.size()); ++j) output.add(subkey, minVals[j]);
+        for (int j=0; j<int(r.min.size()); ++j) output.add(subkey, r.min[j]);
 
       else if (stats[i] == "max")
-        for (int j=0; j<int(maxVals.size()); ++j) output.add(subkey, maxVals[j]);
+        for (int j=0; j<int(r.max.size()); ++j) output.add(subkey, r.max[j]);
 
       else if (stats[i] == "var")
-        for (int j=0; j<int(varVals.size()); ++j) output.add(subkey, varVals[j]);
+        for (int j=0; j<int(r.var.size()); ++j) output.add(subkey, r.var[j]);
 
       else if (stats[i] == "stdev")
-        for (int j=0; j<int(stdevVals.size()); ++j) output.add(subkey, stdevVals[j]);
+        for (int j=0; j<int(r.stdev.size()); ++j) output.add(subkey, r.stdev[j]);
 
       else if (stats[i] == "skew")
-        for (int j=0; j<int(skewnessVals.size()); ++j) output.add(subkey, skewnessVals[j]);
+        for (int j=0; j<int(r.skew.size()); ++j) output.add(subkey, r.skew[j]);
 
       else if (stats[i] == "kurt")
-        for (int j=0; j<int(kurtosisVals.size()); ++j) output.add(subkey, kurtosisVals[j]);
+        for (int j=0; j<int(r.kurt.size()); ++j) output.add(subkey, r.kurt[j]);
 
       else if (stats[i] == "dmean")
-        for (int j=0; j<int(dmeanVals.size()); ++j) output.add(subkey, dmeanVals[j]);
+        for (int j=0; j<int(r.dmean.size()); ++j) output.add(subkey, r.dmean[j]);
 
       else if (stats[i] == "dvar")
-        for (int j=0; j<int(dvarVals.size()); ++j) output.add(subkey, dvarVals[j]);
+        for (int j=0; j<int(r.dvar.size()); ++j) output.add(subkey, r.dvar[j]);
 
       else if (stats[i] == "dmean2")
-        for (int j=0; j<int(d2meanVals.size()); ++j) output.add(subkey, d2meanVals[j]);
+        for (int j=0; j<int(r.dmean2.size()); ++j) output.add(subkey, r.dmean2[j]);
 
       else if (stats[i] == "dvar2")
-        for (int j=0; j<int(d2varVals.size()); ++j) output.add(subkey, d2varVals[j]);
+        for (int j=0; j<int(r.dvar2.size()); ++j) output.add(subkey, r.dvar2[j]);
 
       else if (stats[i] == "cov")
-        for (int j=0; j<vsize; ++j) output.add(subkey, cov[j]);
+        for (int j=0; j<vsize; ++j) output.add(subkey, r.cov[j]);
 
       else if (stats[i] == "icov")
-        for (int j=0; j<vsize; ++j) output.add(subkey, icov[j]);
+        for (int j=0; j<vsize; ++j) output.add(subkey, r.icov[j]);
 
       else if (stats[i] == "copy")
         // don't use the subkey in this case, just key
@@ -377,7 +462,7 @@ void PoolAggregator::aggregateVectorRealPool(const Pool& input, Pool& output) {
 
       else if (stats[i] == "value")
         for (int j=0; j<int(data.size()); ++j) output.add(subkey, data[j]);
-      
+
       else if (stats[i] == "last") {
         output.set(key, data.back());
       }
@@ -404,7 +489,7 @@ void PoolAggregator::aggregateStringPool(const Pool& input, Pool& output) {
        it != stringPool.end();
        ++it) {
     string key = it->first;
-    ::essentia::VectorEx<string> data = it->second;
+    const ::essentia::VectorEx<string>& data = it->second;
 
     for (int i=0; i<(int)data.size(); ++i) {
       output.add(key, data[i]);
@@ -420,7 +505,7 @@ void PoolAggregator::aggregateVectorStringPool(const Pool& input, Pool& output)
        it != vectorStringPool.end();
        ++it) {
     string key = it->first;
-    ::essentia::VectorEx<::essentia::VectorEx<string> > data = it->second;
+    const ::essentia::VectorEx<::essentia::VectorEx<string> >& data = it->second;
 
     for (int i=0; i<(int)data.size(); ++i) {
       output.add(key, data[i]);
@@ -429,14 +514,14 @@ void PoolAggregator::aggregateVectorStringPool(const Pool& input, Pool& output)
 }
 
 void PoolAggregator::aggregateArray2DRealPool(const Pool& input, Pool& output) {
-  PoolOf(TNT::Array2D<Real>) Array2DRealPool = input.getArray2DRealPool();
+  const PoolOf(TNT::Array2D<Real>)& Array2DRealPool = input.getArray2DRealPool();
 
   for (PoolOf(TNT::Array2D<Real>)::const_iterator it = Array2DRealPool.begin();
        it != Array2DRealPool.end();
        ++it) {
 
     string key = it->first;
-    ::essentia::VectorEx<TNT::Array2D<Real> > data = it->second;
+    const ::essentia::VectorEx<TNT::Array2D<Real> >& data = it->second;
     // get frames:
     int dsize = data.size();
 
@@ -567,10 +652,19 @@ void PoolAggregator::aggregateArray2DRealPool(const Pool& input, Pool& output) {
   }
 }
 
+PoolAggregator::~PoolAggregator() {
+  delete _threadPool;
+}
+
 void PoolAggregator::configure() {
   _defaultStats = parameter("defaultStats").toVectorString();
   _exceptions = parameter("exceptions").toMapVectorString();
 
+  int threads = parameter("threads").toInt();
+  delete _threadPool;
+  _threadPool = 0;
+  if (threads != 1) _threadPool = new ThreadPool(threads);
+
   // if the default stats includes the 'copy' statistical unit, make sure it
   // is the only one
   if (indexOf<string>(_defaultStats, "copy") != -1 &&
@@ -639,6 +733,32 @@ void PoolAggregator::compute() {
 }
 
 
+void PoolAggregator::runTasks(const ::essentia::VectorEx<function<void()> >& tasks) {
+  if (!_threadPool || tasks.size() < 2) {
+    for (int i=0; i<(int)tasks.size(); ++i) tasks[i]();
+    return;
+  }
+
+  // the first exception thrown by a task is rethrown once all of them are done
+  mutex errorMutex;
+  exception_ptr error;
+  for (int i=0; i<(int)tasks.size(); ++i) {
+    _threadPool->enqueue([&tasks, i, &errorMutex, &error]() {
+      try {
+        tasks[i]();
+      }
+      catch (...) {
+        lock_guard<mutex> lock(errorMutex);
+        if (!error) error = current_exception();
+      }
+    });
+  }
+  _threadPool->wait();
+
+  if (error) rethrow_exception(error);
+}
+
+
 const ::essentia::VectorEx<string>& PoolAggregator::getStats(const string& key) const {
   if (_exceptions.count(key) > 0) {
     return (*(_exceptions.find(key))).second;
@@ -21,10 +21,14 @@
 #define ESSENTIA_POOLAGGREGATOR_H
 
 #include <set>
+#include <functional>
 #include "algorithm.h"
 #include "pool.h"
 
 namespace essentia {
+
+class ThreadPool;
+
 namespace standard {
 
 class PoolAggregator : public Algorithm {
@@ -42,23 +46,30 @@ class PoolAggregator : public Algorithm {
   void aggregateStringPool(const Pool& input, Pool& output);
   void aggregateVectorStringPool(const Pool& input, Pool& output);
   const ::essentia::VectorEx<std::string>& getStats(const std::string& key) const;
+  void runTasks(const ::essentia::VectorEx<std::function<void()> >& tasks);
 
   ::essentia::VectorEx<std::string> _defaultStats;
   std::map<std::string, ::essentia::VectorEx<std::string> > _exceptions;
   static const std::set<std::string> _supportedStats;
 
+  // only created when aggregating with more than one thread
+  ThreadPool* _threadPool;
+
  public:
-  PoolAggregator() {
+  PoolAggregator() : _threadPool(0) {
     declareInput(_input, "input", "the input pool");
     declareOutput(_output, "output", "a pool containing the aggregate values of the input pool");
   }
 
+  ~PoolAggregator();
+
   void declareParameters() {
     const char* defaultStatsC[] = { "mean", "stdev", "min", "max", "median" };
     ::essentia::VectorEx<std::string> defaultStats = arrayToVector<std::string>(defaultStatsC);
 
     declareParameter("defaultStats", "the default statistics to be computed for each descriptor in the input pool", "", defaultStats);
     declareParameter("exceptions", "a mapping between descriptor names (no duplicates) and the types of statistics to be computed for those descriptors (e.g. { lowlevel.bpm : [min, max], lowlevel.gain : [var, min, dmean] })", "", std::map<std::string, ::essentia::VectorEx<std::string> >());
+    declareParameter("threads", "the number of threads used to aggregate independent descriptors in parallel (0 to use all hardware threads)", "[0,inf)", 1);
   }
 
   void compute();
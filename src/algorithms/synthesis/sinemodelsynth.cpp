@@ -42,12 +42,14 @@ void SineModelSynth::compute() {
   int i = 0;
 
   // convert frequencies to peak locations
-  ::essentia::VectorEx<Real> locs(frequencies.size());
+  ::essentia::VectorEx<Real>& locs = _locs;
+  locs.resize(frequencies.size());
   for (i=0; i < int(frequencies.size()); ++i){
     locs[i] = _fftSize*frequencies[i]/float(_sampleRate);
   }
   // init synth phase vector
-  ::essentia::VectorEx<Real> ytphase(frequencies.size());
+  ::essentia::VectorEx<Real>& ytphase = _ytphase;
+  ytphase.resize(frequencies.size());
   std::fill(ytphase.begin(), ytphase.end(), 0.);
 
   // initialize last phase and frequency vectors
@@ -65,7 +67,7 @@ void SineModelSynth::compute() {
 
   // propagate phase if necessary (no input phase vector)
   if (int(phases.size()) > 0){                                 // if no phases generate them
-	  	ytphase = phases;
+	  	ytphase.assign(phases.begin(), phases.end());
 	  }
   else{
 		for (i=0; i < int(ytphase.size()); ++i)
@@ -82,8 +84,9 @@ void SineModelSynth::compute() {
 		ytphase[i] = fmod (ytphase[i], float(2*M_PI));                        // make phase inside 2*pi
   }
 
-  // save frequency and phase for phase propagation
-  _lastytfreq = frequencies;
+  // save frequency and phase for phase propagation. The frequencies are
+  // copied, as assigning them would only give a view on the input
+  _lastytfreq.assign(frequencies.begin(), frequencies.end());
   _lastytphase = ytphase;
 
 }
@@ -46,6 +46,11 @@ class SineModelSynth : public Algorithm {
   ::essentia::VectorEx<Real> _lastytfreq;
   ::essentia::VectorEx<Real> _lastytphase;
 
+  // peak locations and synthesis phases of the current frame, kept between
+  // calls so that compute() doesn't allocate
+  ::essentia::VectorEx<Real> _locs;
+  ::essentia::VectorEx<Real> _ytphase;
+
 
  public:
   SineModelSynth() {
@@ -126,12 +126,11 @@ void PitchYinFFT::compute() {
 
   // build modified squared difference function using a weighted
   // input norm spectrum
-  ::essentia::VectorEx<complex<Real> > frameFFT;
   _fft->input("frame").set(_sqrMag);
-  _fft->output("fft").set(frameFFT);
+  _fft->output("fft").set(_frameFFT);
 
   // used to get phase and norm
-  _cart2polar->input("complex").set(frameFFT);
+  _cart2polar->input("complex").set(_frameFFT);
   _cart2polar->output("magnitude").set(_resNorm);
   _cart2polar->output("phase").set(_resPhase);
 
@@ -44,6 +44,7 @@ class PitchYinFFT : public Algorithm {
   Algorithm* _cart2polar;
   Algorithm* _peakDetect;
 
+  ::essentia::VectorEx<std::complex<Real> > _frameFFT; /** fft of the weighted squared spectrum */
   ::essentia::VectorEx<Real> _resPhase;    /** complex vector to compute square difference function */
   ::essentia::VectorEx<Real> _resNorm;
   ::essentia::VectorEx<Real> _sqrMag;      /** square difference function */
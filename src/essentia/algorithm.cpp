@@ -51,6 +51,10 @@ OutputBase& Algorithm::output(const string& name) {
 }
 
 
+void Algorithm::computeBatch(int n) {
+  throw EssentiaException("Algorithm ", name(), " cannot compute several frames at once");
+}
+
 ::essentia::VectorEx<const type_info*> Algorithm::inputTypes() const {
   ::essentia::VectorEx<const type_info*> types;
   types.reserve(_inputs.size());
@@ -79,6 +79,18 @@ class ESSENTIA_API Algorithm : public Configurable {
    */
   virtual void compute() = 0;
 
+  /**
+   * Batch interface, used by the streaming wrapper when it processes several
+   * tokens per call (see streaming::StreamingAlgorithmWrapper::setBatchSize()).
+   * Algorithms which can compute n frames at once more efficiently than one
+   * by one return true from supportsBatch() and implement computeBatch(). The
+   * inputs and outputs then point to the first of n frames stored
+   * contiguously, which are accessed with get(i) instead of get().
+   * Other algorithms simply have compute() called once per frame.
+   */
+  virtual bool supportsBatch() const { return false; }
+  virtual void computeBatch(int n);
+
   /**
    * This function will be called when doing batch computations between each
    * file that is processed. That is, if your algorithm is some sort of state
@@ -101,6 +101,17 @@
 #define ALLOW_DEFAULT_PARAMETERS 1
 #endif
 
+
+/**
+ * if set to @c 1, essentia::Mutex will be a real (spin) lock instead of a
+ * no-op, making the Pool and the buffers between streaming algorithms safe to
+ * use from several threads at the same time. This costs a little bit of
+ * performance in single-threaded code, hence it is disabled by default.
+ */
+#ifndef THREAD_SAFE_MUTEX
+#define THREAD_SAFE_MUTEX 0
+#endif
+
 /**
  * C++ version
  */
@@ -18,6 +18,7 @@
  */
 
 #include "debugging.h"
+#include "threading.h"
 #include <iostream>
 
 using namespace std;
@@ -102,9 +103,16 @@ void setDebugLevelForTimeIndex(int index) {
 }
 
 
-// NOTE: in a thread-safe implementation, the msg queue would be thread-safe and
-//       the flushing would need to happen in a separate thread
-//       This can be achieved using tbb::concurrent_queue
+// Algorithms can be computed concurrently from different threads (e.g. from
+// python threads, which do not hold the GIL while computing), so the message
+// queue is protected by a mutex. Messages are still flushed synchronously.
+// NOTE: an asynchronous implementation would flush the msg queue in a separate
+//       thread. This can be achieved using tbb::concurrent_queue
+// (function-local so that it is constructed before being used from static initializers)
+static ForcedMutex& loggerMutex() {
+  static ForcedMutex mutex;
+  return mutex;
+}
 
 void Logger::flush() {
   while (!_msgQueue.empty()) {
@@ -116,6 +124,7 @@ void Logger::flush() {
 
 void Logger::debug(DebuggingModule module, const string& msg, bool resetHeader) {
   if (module & activatedDebugLevels) {
+    ForcedMutexLocker lock(loggerMutex());
     if (_addHeader) {
       _msgQueue.push_back(E_STRINGIFY(debugModuleDescription(module)      // module name
                                       + string(debugIndentLevel * 8, ' ') // indentation
@@ -132,18 +141,21 @@ void Logger::debug(DebuggingModule module, const string& msg, bool resetHeader)
 
 void Logger::info(const string& msg) {
   if (!infoLevelActive) return;
+  ForcedMutexLocker lock(loggerMutex());
   _msgQueue.push_back(E_STRINGIFY(GREEN_FONT << "[   INFO   ] " << RESET_FONT << msg << '\n'));
   flush();
 }
 
 void Logger::warning(const string& msg) {
   if (!warningLevelActive) return;
+  ForcedMutexLocker lock(loggerMutex());
   _msgQueue.push_back(E_STRINGIFY(YELLOW_FONT << "[ WARNING  ] " << RESET_FONT << msg << '\n'));
   flush();
 }
 
 void Logger::error(const string& msg) {
   if (!errorLevelActive) return;
+  ForcedMutexLocker lock(loggerMutex());
   _msgQueue.push_back(E_STRINGIFY(RED_FONT << "[  ERROR   ] " << RESET_FONT << msg << '\n'));
   flush();
 }
@@ -106,7 +106,7 @@ void scheduleDebug(const DebuggingScheduleVector& schedule);
 void setDebugLevelForTimeIndex(int index);
 
 /**
- * Asynchronous thread-safe logger object. (TODO: implementation is still not thread-safe)
+ * Thread-safe logger object. (TODO: flushing is still synchronous)
  */
 class Logger {
  protected:
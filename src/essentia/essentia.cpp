@@ -33,6 +33,8 @@ namespace essentia {
 const char* version = ESSENTIA_VERSION;
 const char* version_git_sha = ESSENTIA_GIT_SHA;
 
+void (*alignedAllocationHook)(size_t bytes) = 0;
+
 
 bool _initialized;
 
@@ -402,7 +402,7 @@ template <typename T> T energy(const ::essentia::VectorEx<T>& array) {
   if (array.empty())
     throw EssentiaException("trying to calculate energy of empty array");
 
-  return inner_product(array.begin(), array.end(), array.begin(), (T)0.0);
+  return std::inner_product(array.begin(), array.end(), array.begin(), (T)0.0);
 }
 
 // returns the instantaneous power of an array
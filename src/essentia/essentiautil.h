@@ -198,19 +198,8 @@ inline void fastcopy<int>(int* dest, const int* src, int n) {
   memcpy(dest, src, n*sizeof(int));
 }
 
-// overload for iterators, which allow us to fastcopy(dest.begin(), src.begin(), 0) and not crash
-inline void fastcopy(::essentia::VectorEx<Real>::iterator dest, ::essentia::VectorEx<Real>::const_iterator src, int n) {
-  // need to test this because otherwise it is not legal to dereference the iterator
-  if (n > 0) {
-    fastcopy(&*dest, &*src, n);
-  }
-}
-
-inline void fastcopy(::essentia::VectorEx<StereoSample>::iterator dest, ::essentia::VectorEx<StereoSample>::const_iterator src, int n) {
-  if (n > 0) {
-    fastcopy(&*dest, &*src, n);
-  }
-}
+// VectorEx iterators are plain pointers, so fastcopy(dest.begin(), src.begin(), n)
+// uses the overloads above directly
 
 } // namespace essentia
 
@@ -57,6 +57,12 @@ class ESSENTIA_API InputBase : public TypeProxy {
     _data = sink.getTokens();
   }
 
+  // no type check here, this is called once per token by the streaming
+  // wrapper in batch mode, after setSinkFirstToken() has checked it already
+  void setSinkToken(streaming::SinkBase& sink, int i) {
+    _data = sink.getToken(i);
+  }
+
  protected:
   const void* _data;
 
@@ -88,6 +94,11 @@ class ESSENTIA_API OutputBase : public TypeProxy {
     _data = source.getTokens();
   }
 
+  // see InputBase::setSinkToken()
+  void setSourceToken(streaming::SourceBase& source, int i) {
+    _data = source.getToken(i);
+  }
+
  protected:
   void* _data;
 
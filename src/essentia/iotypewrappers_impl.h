@@ -56,6 +56,11 @@ class Input : public InputBase {
     }
     return *(Type*)_data;
   }
+
+  // i-th frame of a batch, see Algorithm::computeBatch()
+  const Type& get(int i) const {
+    return ((const Type*)&get())[i];
+  }
 };
 
 
@@ -88,6 +93,11 @@ class Output : public OutputBase {
     }
     return *(Type*)_data;
   }
+
+  // i-th frame of a batch, see Algorithm::computeBatch()
+  Type& get(int i) {
+    return ((Type*)&get())[i];
+  }
 };
 
 
@@ -42,6 +42,166 @@ void Pool::clear() {
   _poolSingleVectorReal.clear();
   _poolSingleVectorString.clear();
   _poolSingleTensorReal.clear();
+  _columnsVectorReal.clear();
+
+  MutexLocker lockIndex(_mutexIndex);
+  _descriptorIndex.clear();
+  ++_removals;
+}
+
+uint64_t Pool::newId() {
+  // 0 is the id of no Pool
+  static std::atomic<uint64_t> lastId(0);
+  return ++lastId;
+}
+
+Pool& Pool::operator=(const Pool& p) {
+  if (this == &p) return *this;
+
+  _poolSingleReal = p._poolSingleReal;
+  _poolSingleString = p._poolSingleString;
+  _poolSingleVectorReal = p._poolSingleVectorReal;
+  _poolSingleVectorString = p._poolSingleVectorString;
+  _poolSingleTensorReal = p._poolSingleTensorReal;
+  _poolReal = p._poolReal;
+  _poolVectorReal = p._poolVectorReal;
+  _poolString = p._poolString;
+  _poolVectorString = p._poolVectorString;
+  _poolArray2DReal = p._poolArray2DReal;
+  _poolTensorReal = p._poolTensorReal;
+  _poolStereoSample = p._poolStereoSample;
+  _descriptorIndex = p._descriptorIndex;
+  _columnar = p._columnar;
+  _columnsVectorReal = p._columnsVectorReal;
+  ++_removals;
+
+  // the copied frames are still views on the buffers of p
+  for (map<string, ::essentia::VectorEx<Real> >::iterator it = _columnsVectorReal.begin();
+       it != _columnsVectorReal.end(); ++it) {
+    bindColumns(_poolVectorReal[it->first], it->second);
+  }
+
+  return *this;
+}
+
+void Pool::setColumnarStorage(bool columnar) {
+  MutexLocker lock(mutexVectorReal);
+  _columnar = columnar;
+}
+
+bool Pool::columnarStorage() const {
+  MutexLocker lock(mutexVectorReal);
+  return _columnar;
+}
+
+bool Pool::isColumnar(const string& name) const {
+  MutexLocker lock(mutexVectorReal);
+  return _columnsVectorReal.find(name) != _columnsVectorReal.end();
+}
+
+void Pool::bindColumns(::essentia::VectorEx<::essentia::VectorEx<Real> >& frames,
+                       ::essentia::VectorEx<Real>& columns) {
+  if (frames.empty()) return;
+  size_t width = columns.size() / frames.size();
+  for (size_t i=0; i<frames.size(); ++i) {
+    frames[i].setReferenceData(columns.data() + i*width, width);
+  }
+}
+
+void Pool::detachColumns(const string& name, ::essentia::VectorEx<::essentia::VectorEx<Real> >& frames) {
+  map<string, ::essentia::VectorEx<Real> >::iterator it = _columnsVectorReal.find(name);
+  if (it == _columnsVectorReal.end()) return;
+
+  for (size_t i=0; i<frames.size(); ++i) {
+    ::essentia::VectorEx<Real> frame(frames[i].begin(), frames[i].end());
+    frames[i].swap(frame);
+  }
+  _columnsVectorReal.erase(it);
+}
+
+void Pool::pushValues(const string& name, ::essentia::VectorEx<::essentia::VectorEx<Real> >& frames,
+                      const ::essentia::VectorEx<Real>* newFrames, size_t count) {
+  if (count == 0) return;
+
+  map<string, ::essentia::VectorEx<Real> >::iterator it;
+  if (frames.empty() && _columnar) {
+    // new descriptor (the ones which have been emptied have been removed)
+    it = _columnsVectorReal.insert(make_pair(name, ::essentia::VectorEx<Real>())).first;
+  }
+  else if (_columnsVectorReal.empty() ||
+           (it = _columnsVectorReal.find(name)) == _columnsVectorReal.end()) {
+    if (count > 1) frames.reserve(frames.size() + count);
+    for (size_t i=0; i<count; ++i) {
+      // the new frames might be views on the columns of another Pool, which
+      // they would outlive, so their data is always copied
+      frames.push_back(::essentia::VectorEx<Real>());
+      frames.back().assign(newFrames[i].begin(), newFrames[i].end());
+    }
+    return;
+  }
+
+  size_t width = frames.empty() ? newFrames[0].size() : frames[0].size();
+  for (size_t i=0; i<count; ++i) {
+    if (newFrames[i].size() != width) {
+      // frames of different sizes can't be stored as a matrix
+      detachColumns(name, frames);
+      pushValues(name, frames, newFrames, count);
+      return;
+    }
+  }
+
+  ::essentia::VectorEx<Real>& columns = it->second;
+  size_t offset = columns.size();
+  const Real* previousData = columns.data();
+
+  // the new frames might be views on this buffer, which is about to move
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > copies;
+  if (width > 0) {
+    for (size_t i=0; i<count; ++i) {
+      if (newFrames[i].data() >= previousData && newFrames[i].data() < previousData + offset) {
+        copies.resize(count);
+        for (size_t j=0; j<count; ++j) copies[j].assign(newFrames[j].begin(), newFrames[j].end());
+        newFrames = &copies[0];
+        break;
+      }
+    }
+  }
+
+  columns.resize(offset + count*width);
+  for (size_t i=0; i<count; ++i) {
+    if (width > 0) fastcopy(&columns[offset + i*width], &newFrames[i][0], width);
+  }
+
+  frames.resize(frames.size() + count);
+  if (columns.data() != previousData) {
+    bindColumns(frames, columns);
+  }
+  else {
+    for (size_t i=frames.size()-count; i<frames.size(); ++i) {
+      frames[i].setReferenceData(columns.data() + i*width, width);
+    }
+  }
+}
+
+template <>
+void Pool::append(const string& name, const ::essentia::VectorEx<::essentia::VectorEx<Real> >& values) {
+  {
+    MutexLocker lock(mutexVectorReal);
+    PoolOf(::essentia::VectorEx<Real>)::iterator result = _poolVectorReal.find(name);
+    if (result != _poolVectorReal.end()) {
+      pushValues(name, result->second, values.data(), values.size());
+      return;
+    }
+  }
+
+  GLOBAL_LOCK
+  PoolOf(::essentia::VectorEx<Real>)::iterator result = _poolVectorReal.find(name);
+  if (result == _poolVectorReal.end()) {
+    validateKey(name);
+    result = _poolVectorReal.insert(make_pair(name, ::essentia::VectorEx<::essentia::VectorEx<Real> >())).first;
+  }
+  /* otherwise another thread added this descriptor while we were not holding any lock */
+  pushValues(name, result->second, values.data(), values.size());
 }
 
 void Pool::checkIntegrity() const {
@@ -65,6 +225,10 @@ void Pool::checkIntegrity() const {
 // this implementation makes the assumption that the key 'name' only exists in
 // one of the sub-pools, as enforced by checkIntegrity
 void Pool::remove(const string& name) {
+  {
+    MutexLocker lock(mutexVectorReal);
+    _columnsVectorReal.erase(name);
+  }
 
   #define SEARCH_AND_DESTROY(t, tname)                                         \
   {                                                                            \
@@ -72,6 +236,8 @@ void Pool::remove(const string& name) {
     map<string, t >::iterator i = _pool##tname.find(name);                     \
     if (i != _pool##tname.end()) {                                             \
       _pool##tname.erase(i);                                                   \
+      ++_removals;                                                             \
+      unindexKey(name);                                                        \
       return;                                                                  \
     }                                                                          \
   }
@@ -94,6 +260,11 @@ void Pool::remove(const string& name) {
 }
 
 void Pool::removeNamespace(const string& ns) {
+  {
+    MutexLocker lock(mutexVectorReal);
+    map<string, ::essentia::VectorEx<Real> >::iterator it = _columnsVectorReal.lower_bound(ns+".");
+    while (it != _columnsVectorReal.end() && it->first.find(ns+".") == 0) _columnsVectorReal.erase(it++);
+  }
 
   #define SEARCH_AND_DESTROY(t, tname)                              \
   {                                                                 \
@@ -116,6 +287,7 @@ void Pool::removeNamespace(const string& ns) {
         ++it;                                                       \
       }                                                             \
     }                                                               \
+    ++_removals;                                                    \
   }
 
   SEARCH_AND_DESTROY(Real, SingleReal);
@@ -133,6 +305,8 @@ void Pool::removeNamespace(const string& ns) {
   SEARCH_AND_DESTROY(::essentia::VectorEx<StereoSample>, StereoSample);
 
   #undef SEARCH_AND_DESTROY
+
+  unindexKey(ns, true);
 }
 
 
@@ -243,29 +417,52 @@ void Pool::removeNamespace(const string& ns) {
 }
 
 void Pool::validateKey(const string& name) {
-  ::essentia::VectorEx<std::string> allNames = descriptorNamesNoLocking();
-  for (int i=0; i<int(allNames.size()); ++i) {
-    /* first check if name already exists in another sub-pool */
-    if (name == allNames[i]) {
-      throw EssentiaException("Pool: Cannot set/add/merge value to the pool under "
-                              "the name '"+name+"' because that name already exists but "
-                              "contains a different data type than value");
-    }
-    /* now check if adding this new key will result in a parent descriptor
-     * having a value and child descriptors (there are 2 cases where this can
-     * happen)*/
-    if ( name.find(allNames[i] + ".") == 0 ) {
+  MutexLocker lock(_mutexIndex);
+
+  /* first check if name already exists in another sub-pool */
+  if (_descriptorIndex.find(name) != _descriptorIndex.end()) {
+    throw EssentiaException("Pool: Cannot set/add/merge value to the pool under "
+                            "the name '"+name+"' because that name already exists but "
+                            "contains a different data type than value");
+  }
+
+  /* now check if adding this new key will result in a parent descriptor
+   * having a value and child descriptors (there are 2 cases where this can
+   * happen)*/
+  for (string::size_type pos = name.find('.'); pos != string::npos; pos = name.find('.', pos+1)) {
+    string parent = name.substr(0, pos);
+    if (_descriptorIndex.find(parent) != _descriptorIndex.end()) {
       throw EssentiaException("Pool: Cannot set/add/merge value to the pool under the name '"+name+
                               "' because '"+name+"' has a parent descriptor name already in "
-                              "the pool (e.g. '"+allNames[i]+"')");
+                              "the pool (e.g. '"+parent+"')");
     }
+  }
 
-    if ( allNames[i].find(name+".") == 0 ) {
-      throw EssentiaException("Pool: Cannot add/set/merge value to the pool under "
-                              "the name '"+name+"' because '"+name+"' has child descriptor "
-                              "names (e.g. '"+allNames[i]+"')");
-    }
+  /* the children of name, if any, directly follow name+"." in the index */
+  string prefix = name + ".";
+  std::set<string>::const_iterator child = _descriptorIndex.lower_bound(prefix);
+  if (child != _descriptorIndex.end() && child->compare(0, prefix.size(), prefix) == 0) {
+    throw EssentiaException("Pool: Cannot add/set/merge value to the pool under "
+                            "the name '"+name+"' because '"+name+"' has child descriptor "
+                            "names (e.g. '"+*child+"')");
   }
+
+  _descriptorIndex.insert(name);
+}
+
+void Pool::unindexKey(const string& name, bool isNamespace) {
+  MutexLocker lock(_mutexIndex);
+
+  if (!isNamespace) {
+    _descriptorIndex.erase(name);
+    return;
+  }
+
+  string prefix = name + ".";
+  std::set<string>::iterator first = _descriptorIndex.lower_bound(prefix);
+  std::set<string>::iterator last = first;
+  while (last != _descriptorIndex.end() && last->compare(0, prefix.size(), prefix) == 0) ++last;
+  _descriptorIndex.erase(first, last);
 }
 
 #define SPECIALIZE_ADD_IMPL(type, tname)                                     \
@@ -279,14 +476,15 @@ void Pool::add(const string& name, const type& value, bool validityCheck) {  \
       throw EssentiaException("Pool::add value contains invalid numbers (NaN or inf)");\
     }                                                                        \
     if (_pool##tname.find(name) != _pool##tname.end()) {                     \
-      _pool##tname[name].push_back(value);                                   \
+      pushValues(name, _pool##tname[name], &value, 1);                       \
       return;                                                                \
     }                                                                        \
   }                                                                          \
   /* validating will require checking all sub-pools, acquire a global lock*/ \
   GLOBAL_LOCK                                                                \
-  validateKey(name);                                                         \
-  _pool##tname[name].push_back(value);                                       \
+  /* another thread might have added it while we were not holding any lock */\
+  if (_pool##tname.find(name) == _pool##tname.end()) validateKey(name);      \
+  pushValues(name, _pool##tname[name], &value, 1);                           \
 }
 
 
@@ -297,6 +495,38 @@ SPECIALIZE_ADD_IMPL(::essentia::VectorEx<string>, VectorString);
 SPECIALIZE_ADD_IMPL(StereoSample, StereoSample);
 
 
+#define SPECIALIZE_ADD_HANDLE_IMPL(type, tname)                              \
+void Pool::add(DescriptorHandle<type>& handle, const type& value, bool validityCheck) {\
+  {                                                                          \
+    MutexLocker lock(mutex##tname);                                          \
+    if (validityCheck && !isValid(value)) {                                  \
+      throw EssentiaException("Pool::add value contains invalid numbers (NaN or inf)");\
+    }                                                                        \
+    /* no descriptor has been removed since the handle was looked up, so it
+     * still points to its values */                                         \
+    if (handle._poolId == _id && handle._generation == _removals) {          \
+      pushValues(handle._name, *handle._values, &value, 1);                  \
+      return;                                                                \
+    }                                                                        \
+  }                                                                          \
+  add(handle._name, value);                                                  \
+                                                                             \
+  MutexLocker lock(mutex##tname);                                            \
+  PoolOf(type)::iterator it = _pool##tname.find(handle._name);               \
+  /* another thread might have removed it in the meantime */                 \
+  if (it == _pool##tname.end()) return;                                      \
+  handle._poolId = _id;                                                      \
+  handle._values = &it->second;                                              \
+  handle._generation = _removals;                                            \
+}
+
+SPECIALIZE_ADD_HANDLE_IMPL(Real, Real);
+SPECIALIZE_ADD_HANDLE_IMPL(::essentia::VectorEx<Real>, VectorReal);
+SPECIALIZE_ADD_HANDLE_IMPL(string, String);
+SPECIALIZE_ADD_HANDLE_IMPL(::essentia::VectorEx<string>, VectorString);
+SPECIALIZE_ADD_HANDLE_IMPL(StereoSample, StereoSample);
+
+
 void Pool::add(const string& name, const Tensor<Real>& value, bool validityCheck) {
   /* first check if the pool has ever seen this key before, if it has, we can
    * just add it, if not, we need to run some validation tests */
@@ -311,7 +541,8 @@ void Pool::add(const string& name, const Tensor<Real>& value, bool validityCheck
     }
   }
   GLOBAL_LOCK
-  validateKey(name);
+  // another thread might have added it while we were not holding any lock
+  if (_poolTensorReal.find(name) == _poolTensorReal.end()) validateKey(name);
   _poolTensorReal[name].push_back(Tensor<Real>(value));
 }
 
@@ -332,7 +563,8 @@ void Pool::add(const string& name, const Array2D<Real>& value, bool validityChec
     }
   }
   GLOBAL_LOCK
-  validateKey(name);
+  // another thread might have added it while we were not holding any lock
+  if (_poolArray2DReal.find(name) == _poolArray2DReal.end()) validateKey(name);
   _poolArray2DReal[name].push_back(value.copy());
 }
 
@@ -352,7 +584,8 @@ void Pool::set(const string& name, const type& value, bool validityCheck) {  \
     }                                                                        \
   }                                                                          \
   GLOBAL_LOCK                                                                \
-  validateKey(name);                                                         \
+  /* another thread might have set it while we were not holding any lock */  \
+  if (_poolSingle##tname.find(name) == _poolSingle##tname.end()) validateKey(name);\
   _poolSingle##tname[name] = value;                                          \
 }
 
@@ -377,7 +610,8 @@ void Pool::set(const string& name, const Tensor<Real>& value, bool validityCheck
     }
   }
   GLOBAL_LOCK
-  validateKey(name);
+  // another thread might have set it while we were not holding any lock
+  if (_poolSingleTensorReal.find(name) == _poolSingleTensorReal.end()) validateKey(name);
 
   _poolSingleTensorReal[name].resize(value.dimensions());
   _poolSingleTensorReal[name] = value;
@@ -454,29 +688,30 @@ void Pool::merge(const string& name, const ::essentia::VectorEx<type>& value, co
                                 "\"interleave\") is specified");                                       \
       }                                                                                                \
       else if (mergeType=="append") {                                                                  \
-        _pool##tname[name].reserve(_pool##tname[name].size()+value.size());                            \
-        for(int i=0; i<int(value.size()); i++) {                                                       \
-          _pool##tname[name].push_back(value[i]);                                                      \
-        }                                                                                              \
+        pushValues(name, it->second, &value[0], value.size());                                         \
       }                                                                                                \
       else if (mergeType == "replace") {                                                               \
+        detachColumns(name, it->second);                                                               \
         _pool##tname.erase(it);                                                                        \
-        _pool##tname.insert(make_pair(name, value));                                                   \
+        ++_removals;                                                                                   \
+        /* the values are copied, even if they are views on another Pool */                            \
+        pushValues(name, _pool##tname[name], &value[0], value.size());                                 \
       }                                                                                                \
       else if (mergeType=="interleave") {                                                              \
-        if (value.size() != _pool##tname[name].size()) {                                               \
+        if (value.size() != it->second.size()) {                                                       \
           throw EssentiaException("Pool::merge, cannot interleave descriptors with different sizes :", name);\
         }                                                                                              \
-        ::essentia::VectorEx<type> temp = _pool##tname[name];                                                        \
-        _pool##tname.erase(it);\
-        _pool##tname[name].push_back(temp[0]);                                                         \
-        _pool##tname[name].push_back(value[0]);                                                        \
-        _pool##tname[name].reserve(2*temp.size());                                                     \
-        for (int i=1; i<(int)temp.size(); i++) {                                                       \
-          _pool##tname[name].push_back(temp[i]);                                                       \
-          _pool##tname[name].push_back(value[i]);                                                      \
+        detachColumns(name, it->second);                                                               \
+        ::essentia::VectorEx<type> interleaved;                                                        \
+        interleaved.reserve(2*value.size());                                                           \
+        for (int i=0; i<(int)value.size(); i++) {                                                      \
+          interleaved.push_back(it->second[i]);                                                        \
+          interleaved.push_back(value[i]);                                                             \
         }                                                                                              \
-        return;\
+        _pool##tname.erase(it);                                                                        \
+        ++_removals;                                                                                   \
+        pushValues(name, _pool##tname[name], &interleaved[0], interleaved.size());                     \
+        return;                                                                                        \
       }                                                                                                \
       else {                                                                                           \
         throw EssentiaException("Pool::merge, unknown merge type: ", mergeType);                       \
@@ -484,13 +719,16 @@ void Pool::merge(const string& name, const ::essentia::VectorEx<type>& value, co
       return;                                                                                          \
     }                                                                                                  \
   }                                                                                                    \
-  GLOBAL_LOCK                                                                                          \
-  validateKey(name);                                                                                   \
-  _pool##tname[name].push_back(value[0]);                                                              \
-  _pool##tname[name].reserve(value.size());                                                            \
-  for (int i=1; i<(int)value.size(); ++i) {                                                            \
-    _pool##tname[name].push_back(value[i]);                                                            \
+  {                                                                                                    \
+    GLOBAL_LOCK                                                                                        \
+    if (_pool##tname.find(name) == _pool##tname.end()) {                                               \
+      validateKey(name);                                                                               \
+      pushValues(name, _pool##tname[name], &value[0], value.size());                                   \
+      return;                                                                                          \
+    }                                                                                                  \
   }                                                                                                    \
+  /* another thread added this descriptor while we were not holding any lock */                       \
+  merge(name, value, mergeType);                                                                       \
 }
 
 SPECIALIZE_MERGE_IMPL(Real, Real);
@@ -521,9 +759,16 @@ void Pool::mergeSingle(const string& name, const type& value, const string& merg
       return;                                                                                          \
     }                                                                                                  \
   }                                                                                                    \
-  GLOBAL_LOCK                                                                                          \
-  validateKey(name);                                                                                   \
-  _poolSingle##tname.insert(make_pair(name, value));                                                   \
+  {                                                                                                    \
+    GLOBAL_LOCK                                                                                        \
+    if (_poolSingle##tname.find(name) == _poolSingle##tname.end()) {                                   \
+      validateKey(name);                                                                               \
+      _poolSingle##tname.insert(make_pair(name, value));                                               \
+      return;                                                                                          \
+    }                                                                                                  \
+  }                                                                                                    \
+  /* another thread added this descriptor while we were not holding any lock */                       \
+  mergeSingle(name, value, mergeType);                                                                 \
 }
 
 SPECIALIZE_MERGE_SINGLE_IMPL(Real, Real)
@@ -579,13 +824,20 @@ void Pool::merge(const string& name, const ::essentia::VectorEx<Array2D<Real> >&
       return;
     }
   }
-  GLOBAL_LOCK
-  validateKey(name);
-  _poolArray2DReal[name].push_back(value[0].copy());
-  _poolArray2DReal[name].reserve(value.size());
-  for (int i=1; i<(int)value.size(); ++i) {
-    _poolArray2DReal[name].push_back(value[i].copy());
+  {
+    GLOBAL_LOCK
+    if (_poolArray2DReal.find(name) == _poolArray2DReal.end()) {
+      validateKey(name);
+      _poolArray2DReal[name].push_back(value[0].copy());
+      _poolArray2DReal[name].reserve(value.size());
+      for (int i=1; i<(int)value.size(); ++i) {
+        _poolArray2DReal[name].push_back(value[i].copy());
+      }
+      return;
+    }
   }
+  // another thread added this descriptor while we were not holding any lock
+  merge(name, value, mergeType);
 }
 
 bool Pool::isSingleValue(const string& name) {
@@ -24,6 +24,8 @@
 #include "threading.h"
 #include "utils/tnt/tnt.h"
 #include "essentiautil.h"
+#include <set>
+#include <atomic>
 
 namespace essentia {
 
@@ -34,9 +36,53 @@ namespace essentia {
 
 typedef std::string DescriptorName;
 
+class Pool;
+
+/**
+ * A DescriptorHandle refers to the values added to a Pool under a given
+ * descriptor name. Adding values through a handle (see Pool::add) only needs
+ * to look the name up the first time, so it should be used by the writers
+ * that add a value to the same descriptor for every frame.
+ *
+ * A handle can be used with any Pool, it is looked up again when it is used
+ * with another Pool than the last one or when descriptors have been removed
+ * from the Pool since then. Pools are told apart by a unique id rather than
+ * by their address, which a new Pool could reuse.
+ */
+template <typename T>
+class DescriptorHandle {
+ protected:
+  friend class Pool;
+
+  std::string _name;
+  uint64_t _poolId;  // id of the Pool _values points into, 0 if none
+  ::essentia::VectorEx<T>* _values;
+  unsigned int _generation;
+
+ public:
+  explicit DescriptorHandle(const std::string& name) :
+    _name(name), _poolId(0), _values(0), _generation(0) {}
+
+  const std::string& name() const { return _name; }
+};
+
 /**
  * The pool is a storage structure which can hold frames of all kinds of
- * descriptors. A Pool instance is thread-safe.
+ * descriptors.
+ *
+ * A Pool instance is thread-safe when essentia has been compiled with
+ * THREAD_SAFE_MUTEX set to 1 (see config.h): add(), set(), append(), merge(),
+ * remove() and the other methods can then be called concurrently from several
+ * threads, e.g.: by several networks writing into the same Pool. Note however
+ * that the references returned by value() and the get*Pool() methods are not
+ * protected by any lock, so they should not be used while other threads are
+ * still modifying the same descriptors. Without THREAD_SAFE_MUTEX, all locks
+ * are no-ops and a Pool must not be accessed from several threads at once.
+ *
+ * A Pool can optionally store the frames of the vector of Reals descriptors
+ * in a columnar way (see setColumnarStorage()), where all the frames of a
+ * descriptor are in a single contiguous buffer instead of each one being a
+ * separate allocation.
  *
  * More specifically, a Pool maps descriptor names to data. A descriptor name
  * is a period ('.') delimited string of identifiers that are associated with
@@ -84,11 +130,13 @@ typedef std::string DescriptorName;
  *         MutexLocker lockString(mutexString)
  *         MutexLocker lockVectorString(mutexVectorString)
  *         MutexLocker lockArray2DReal(mutexArray2DReal)
+ *         MutexLocker lockTensorReal(mutexTensorReal)
  *         MutexLocker lockStereoSample(mutexStereoSample)
  *         MutexLocker lockSingleReal(mutexSingleReal)
  *         MutexLocker lockSingleString(mutexSingleString)
  *         MutexLocker lockSingleVectorReal(mutexSingleVectorReal)
  *         MutexLocker lockSingleVectorString(mutexSingleVectorString)
+ *         MutexLocker lockSingleTensorReal(mutexSingleTensorReal)
  *
  * To release the locks, the order should be reversed!
  *
@@ -112,15 +160,93 @@ class Pool {
   PoolOf(Tensor<Real>) _poolTensorReal;
   PoolOf(StereoSample) _poolStereoSample;
 
+  // names of all the descriptors in the sub-pools. The namespace of a
+  // descriptor is a prefix of its name, so the children of a namespace are a
+  // contiguous range of this set. It can be modified while only holding the
+  // lock of one sub-pool, so it has its own mutex, which is always acquired
+  // last and never held for more than one operation on the set.
+  std::set<std::string> _descriptorIndex;
+  Mutex _mutexIndex;
+
+  // counts the removals of descriptors from the sub-pools, which invalidate
+  // the DescriptorHandles pointing into them. A copy of a Pool starts a new
+  // count, and assigning a Pool replaces all of its descriptors.
+  class RemovalCounter {
+    std::atomic<unsigned int> _count;
+   public:
+    RemovalCounter() : _count(0) {}
+    RemovalCounter(const RemovalCounter&) : _count(0) {}
+    RemovalCounter& operator=(const RemovalCounter&) { ++_count; return *this; }
+    void operator++() { ++_count; }
+    operator unsigned int() const { return _count.load(std::memory_order_relaxed); }
+  };
+  RemovalCounter _removals;
+
+  // unique id of this Pool, never reused by another one (not even by a copy),
+  // which identifies it to the DescriptorHandles
+  uint64_t _id;
+  static uint64_t newId();
+
+  // whether the vector of Reals descriptors created from now on store their
+  // frames in columnar mode (see setColumnarStorage())
+  bool _columnar;
+
+  // buffers holding the frames of the descriptors of _poolVectorReal stored
+  // in columnar mode, one after the other. The frames in _poolVectorReal are
+  // views on these buffers. Protected by mutexVectorReal
+  std::map<std::string, ::essentia::VectorEx<Real> > _columnsVectorReal;
+
   // WARNING: this function assumes that all sub-pools are locked
   ::essentia::VectorEx<std::string> descriptorNamesNoLocking() const;
 
   /**
    * helper function for key validation when adding/setting/merging values to
-   * the pool
+   * the pool. If the key is valid, it is registered in the index of
+   * descriptor names, so it has to be inserted in its sub-pool right after.
+   * WARNING: this function assumes that all sub-pools are locked
    */
    void validateKey(const std::string& name);
 
+  /**
+   * removes the given name, or all the names in the namespace @e name if
+   * @e isNamespace is true, from the index of descriptor names
+   */
+   void unindexKey(const std::string& name, bool isNamespace = false);
+
+  /**
+   * pushes @e count values at the back of @e values, which are the values of
+   * descriptor @e name. The vector of Reals descriptors can be stored in
+   * columnar mode, the other ones are simply appended.
+   * WARNING: this function assumes that the sub-pool of the values is locked
+   */
+  template <typename T>
+  void pushValues(const std::string& name, ::essentia::VectorEx<T>& values,
+                  const T* newValues, size_t count) {
+    if (count > 1) values.reserve(values.size() + count);
+    for (size_t i=0; i<count; ++i) values.push_back(newValues[i]);
+  }
+
+  void pushValues(const std::string& name, ::essentia::VectorEx< ::essentia::VectorEx<Real> >& frames,
+                  const ::essentia::VectorEx<Real>* newFrames, size_t count);
+
+  /**
+   * gives their own storage back to the frames of descriptor @e name if it is
+   * stored in columnar mode, before they get modified in another way than by
+   * pushValues(). Does nothing for the other types.
+   * WARNING: this function assumes that the sub-pool of the values is locked
+   */
+  template <typename T>
+  void detachColumns(const std::string& name, ::essentia::VectorEx<T>& values) {}
+
+  void detachColumns(const std::string& name, ::essentia::VectorEx< ::essentia::VectorEx<Real> >& frames);
+
+  /**
+   * points all the frames of a descriptor stored in columnar mode to their
+   * position in @e columns
+   */
+  static void bindColumns(::essentia::VectorEx< ::essentia::VectorEx<Real> >& frames,
+                          ::essentia::VectorEx<Real>& columns);
+
 
  public:
 
@@ -129,6 +255,44 @@ class Pool {
                 mutexSingleReal, mutexSingleString, mutexSingleVectorReal,
                 mutexSingleVectorString, mutexTensorReal, mutexSingleTensorReal;
 
+  Pool() : _id(newId()), _columnar(false) {}
+
+  // the frames of the descriptors stored in columnar mode need to point to
+  // the copied buffers, so a Pool can't simply be copied member by member
+  Pool(const Pool& p) : _id(newId()), _columnar(false) { *this = p; }
+  Pool& operator=(const Pool& p);
+
+  /**
+   * Sets whether the frames of the vector of Reals descriptors created from
+   * now on should be stored in columnar mode, i.e.: in a single contiguous
+   * buffer per descriptor (rows x cols) instead of in one allocation per
+   * frame. This uses less memory and is faster to go through when there are
+   * many small frames, e.g.: MFCCs or bands energies. The descriptors that
+   * already exist keep the storage mode they were created with.
+   *
+   * The frames are still returned by value<>() and getVectorRealPool() as
+   * vectors of vectors, but these vectors are views on the buffer: copies
+   * of them are only valid until frames are added to the same descriptor,
+   * as the buffer may have to grow and move. Their data should be copied
+   * (e.g.: with assign()) if they need to be kept for longer.
+   *
+   * If frames of different sizes are added to a descriptor, it goes back to
+   * storing each of its frames separately.
+   */
+  void setColumnarStorage(bool columnar);
+
+  /**
+   * @returns whether the vector of Reals descriptors created from now on
+   *          store their frames in columnar mode
+   */
+  bool columnarStorage() const;
+
+  /**
+   * @returns whether the frames of descriptor @e name are stored in columnar
+   *          mode
+   */
+  bool isColumnar(const std::string& name) const;
+
   /**
    * Adds @e value to the Pool under @e name
    * @param name a descriptor name that identifies the collection of data to add
@@ -171,6 +335,25 @@ class Pool {
   /** @copydoc add(const std::string&,const Real&,bool) */
   void add(const std::string& name, const StereoSample& value, bool validityCheck = false);
 
+  /**
+   * Adds @e value to the Pool under the descriptor name of @e handle. This is
+   * the same as add(handle.name(), value, validityCheck), except that the name
+   * is only looked up the first time the handle is used with this Pool.
+   */
+  void add(DescriptorHandle<Real>& handle, const Real& value, bool validityCheck = false);
+
+  /** @copydoc add(DescriptorHandle<Real>&,const Real&,bool) */
+  void add(DescriptorHandle<::essentia::VectorEx<Real> >& handle, const ::essentia::VectorEx<Real>& value, bool validityCheck = false);
+
+  /** @copydoc add(DescriptorHandle<Real>&,const Real&,bool) */
+  void add(DescriptorHandle<std::string>& handle, const std::string& value, bool validityCheck = false);
+
+  /** @copydoc add(DescriptorHandle<Real>&,const Real&,bool) */
+  void add(DescriptorHandle<::essentia::VectorEx<std::string> >& handle, const ::essentia::VectorEx<std::string>& value, bool validityCheck = false);
+
+  /** @copydoc add(DescriptorHandle<Real>&,const Real&,bool) */
+  void add(DescriptorHandle<StereoSample>& handle, const StereoSample& value, bool validityCheck = false);
+
   /**
    * WARNING: this is an utility method that might fail in weird ways if not used
    * correctly. When in doubt, always use the add() method. This is provided for
@@ -597,17 +780,29 @@ inline void Pool::append(const std::string& name, const ::essentia::VectorEx<typ
   }                                                                                   \
                                                                                       \
   GLOBAL_LOCK                                                                         \
-  validateKey(name);                                                                  \
-  _pool##tname[name] = values;                                                        \
+  PoolOf(type)::iterator result = _pool##tname.find(name);                            \
+  if (result == _pool##tname.end()) {                                                 \
+    validateKey(name);                                                                \
+    _pool##tname[name] = values;                                                      \
+    return;                                                                           \
+  }                                                                                   \
+  /* another thread added this descriptor while we were not holding any lock */      \
+  ::essentia::VectorEx<type>& v = result->second;                                              \
+  int vsize = v.size();                                                               \
+  v.resize(vsize + values.size());                                                    \
+  fastcopy(&v[vsize], &values[0], values.size());                                     \
 }
 
 
 SPECIALIZE_APPEND(Real, Real);
-SPECIALIZE_APPEND(::essentia::VectorEx<Real>, VectorReal);
 SPECIALIZE_APPEND(std::string, String);
 SPECIALIZE_APPEND(::essentia::VectorEx<std::string>, VectorString);
 SPECIALIZE_APPEND(StereoSample, StereoSample);
 
+// the frames of vector of Reals descriptors might be stored in columnar mode
+template <>
+void Pool::append(const std::string& name, const ::essentia::VectorEx< ::essentia::VectorEx<Real> >& values);
+
 /// @endcond
 
 } // namespace essentia
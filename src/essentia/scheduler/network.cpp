@@ -18,8 +18,12 @@
  */
 
 #include <stack>
+#include <mutex>
+#include <exception>
 #include "network.h"
+#include "networkprofiler.h"
 #include "graphutils.h"
+#include "../utils/threadpool.h"
 #include "../streaming/streamingalgorithm.h"
 #include "../streaming/streamingalgorithmcomposite.h"
 using namespace std;
@@ -169,7 +173,14 @@ Network* Network::lastCreated = 0;
 Network::Network(Algorithm* generator, bool takeOwnership) : _takeOwnership(takeOwnership),
                                                              _generator(generator),
                                                              _visibleNetworkRoot(0),
-                                                             _executionNetworkRoot(0) {
+                                                             _executionNetworkRoot(0),
+                                                             _numThreads(1),
+                                                             _threadPool(0),
+                                                             _adaptiveBufferSizes(true),
+                                                             _bufferBudget(new BufferMemoryBudget()),
+                                                             _profiling(false),
+                                                             _tracing(false),
+                                                             _profiler(0) {
   lastCreated = this;
 
   // 1- find the simple list of algorithms connected in this network
@@ -184,6 +195,31 @@ Network::Network(Algorithm* generator, bool takeOwnership) : _takeOwnership(take
 Network::~Network() {
   if (lastCreated == this) lastCreated = 0;
   clear();
+  delete _threadPool;
+  delete _profiler;
+}
+
+void Network::setNumThreads(int nThreads) {
+  _numThreads = (nThreads > 0) ? nThreads : ThreadPool::hardwareConcurrency();
+}
+
+void Network::setProfiling(bool enabled, bool trace) {
+  _profiling = enabled;
+  _tracing = enabled && trace;
+}
+
+void Network::printProfile(ostream& out) const {
+  if (!_profiler) {
+    throw EssentiaException("Network: cannot print the profile, profiling was not enabled when running the network");
+  }
+  _profiler->printSummary(out);
+}
+
+void Network::writeTrace(ostream& out) const {
+  if (!_profiler) {
+    throw EssentiaException("Network: cannot write the trace, profiling was not enabled when running the network");
+  }
+  _profiler->writeTrace(out);
 }
 
 void Network::clear() {
@@ -232,6 +268,11 @@ bool algorithmHasProduced(Algorithm* algo, EssentiaMap<SourceBase*, int>& produc
   return hasProduced;
 }
 
+inline AlgorithmStatus Network::processAlgorithm(int index) {
+  if (_profiler) return _profiler->process(index, _toposortedNetwork[index]);
+  return _toposortedNetwork[index]->process();
+}
+
 void Network::run() {
   runPrepare();
   while (runStep());
@@ -255,6 +296,13 @@ void Network::runPrepare() {
   // 4- resize the buffers depending on the requirements of the connected sinks
   checkBufferSizes();
 
+  // 5- compute the dependencies needed to dispatch algorithms on several threads
+  buildParallelSchedule();
+
+  // 6- start a new profile, if asked to
+  delete _profiler;
+  _profiler = _profiling ? new NetworkProfiler(_toposortedNetwork, _tracing) : 0;
+
 #if DEBUGGING_ENABLED
   for (int i=0; i<(int)_toposortedNetwork.size(); i++) _toposortedNetwork[i]->nProcess = 0;
 #endif
@@ -282,7 +330,7 @@ bool Network::runStep() {
 #endif
 
   // first run the generator once
-  gen->process();
+  processAlgorithm(0);
 
   bool endOfStream = gen->shouldStop();
 
@@ -297,6 +345,13 @@ bool Network::runStep() {
   //printBufferFillState();
 #endif
 
+  if (_threadPool) {
+    // dispatch the independent branches of the network to the worker threads
+    runStepParallel(endOfStream);
+    printBufferFillState();
+    return true;
+  }
+
   // then run each algorithm as many times as needed for them to consume everything on their input
   stack<int> runStack;
   runStack.push(1);
@@ -310,7 +365,7 @@ bool Network::runStep() {
       _toposortedNetwork[i]->shouldStop(endOfStream && runStack.empty());
       AlgorithmStatus status;
       do {
-        status = _toposortedNetwork[i]->process();
+        status = processAlgorithm(i);
 
 #if DEBUGGING_ENABLED
         if (status == OK || status == FINISHED) _toposortedNetwork[i]->nProcess++;
@@ -344,6 +399,166 @@ bool Network::runStep() {
   return true;
 }
 
+void Network::buildParallelSchedule() {
+  _parallelChildren.clear();
+
+  if (_numThreads <= 1) {
+    delete _threadPool;
+    _threadPool = 0;
+    return;
+  }
+
+  // map each algorithm to its position in the topologically sorted network,
+  // children always come after their parents in there
+  map<Algorithm*, int> algoIndex;
+  for (int i=(int)_toposortedNetwork.size()-1; i>=0; i--) {
+    algoIndex[_toposortedNetwork[i]] = i;
+  }
+
+  _parallelChildren = ::essentia::VectorEx<::essentia::VectorEx<int> >(_toposortedNetwork.size(),
+                                                                       ::essentia::VectorEx<int>());
+  NodeVector nodes = depthFirstSearch(_executionNetworkRoot);
+  for (int i=0; i<(int)nodes.size(); i++) {
+    int parent = algoIndex[nodes[i]->algorithm()];
+    const NodeVector& children = nodes[i]->children();
+    for (int j=0; j<(int)children.size(); j++) {
+      int child = algoIndex[children[j]->algorithm()];
+      if (child != parent && !contains(_parallelChildren[parent], child)) {
+        _parallelChildren[parent].push_back(child);
+      }
+    }
+  }
+
+  if (!_threadPool || _threadPool->size() != _numThreads) {
+    delete _threadPool;
+    _threadPool = new ThreadPool(_numThreads);
+  }
+}
+
+AlgorithmStatus Network::runAlgorithm(int index, bool endOfStream) {
+  Algorithm* algo = _toposortedNetwork[index];
+  algo->shouldStop(endOfStream);
+
+  AlgorithmStatus status;
+  do {
+    status = processAlgorithm(index);
+
+#if DEBUGGING_ENABLED
+    if (status == OK || status == FINISHED) algo->nProcess++;
+#endif
+  } while (status == OK);
+
+  return status;
+}
+
+void Network::runStepParallel(bool endOfStream) {
+  const int n = (int)_toposortedNetwork.size();
+
+  // algorithms to be run in the current round: all of them but the generator
+  // in the first round, then only those which have been rescheduled because
+  // their output buffers were full, together with everything that follows them
+  ::essentia::VectorEx<int> active(n);
+  for (int i=1; i<n; i++) active[i] = 1;
+
+  mutex stateMutex;
+
+  while (true) {
+    ::essentia::VectorEx<int> pending(n);     // number of active parents not yet run
+    ::essentia::VectorEx<int> tainted(n);     // whether an ancestor has been rescheduled
+    ::essentia::VectorEx<int> rescheduled(n);
+    exception_ptr error;
+
+    for (int i=0; i<n; i++) {
+      if (!active[i]) continue;
+      for (int j=0; j<(int)_parallelChildren[i].size(); j++) {
+        if (active[_parallelChildren[i][j]]) pending[_parallelChildren[i][j]]++;
+      }
+    }
+
+    function<void(int)> runNode = [&](int i) {
+      Algorithm* algo = _toposortedNetwork[i];
+      bool stop;
+      {
+        lock_guard<mutex> lock(stateMutex);
+        // same as in the sequential case: do not propagate the end of stream
+        // while an algorithm we depend upon still has some work to do
+        stop = endOfStream && !tainted[i];
+      }
+
+      AlgorithmStatus status;
+      try {
+#if !THREAD_SAFE_MUTEX
+        if (algo->outputs().empty()) {
+          ForcedMutexLocker lock(_sinkMutex);
+          status = runAlgorithm(i, stop);
+        }
+        else
+#endif
+        {
+          status = runAlgorithm(i, stop);
+        }
+      }
+      catch (...) {
+        lock_guard<mutex> lock(stateMutex);
+        if (!error) error = current_exception();
+        return;
+      }
+
+      ::essentia::VectorEx<int> ready;
+      {
+        lock_guard<mutex> lock(stateMutex);
+        if (status == NO_OUTPUT) {
+          rescheduled[i] = 1;
+          E_DEBUG(EScheduler, "Rescheduling algorithm " << algo->name() <<
+                  " to run later, output buffers temporarily full");
+        }
+        const ::essentia::VectorEx<int>& children = _parallelChildren[i];
+        for (int j=0; j<(int)children.size(); j++) {
+          int child = children[j];
+          if (!active[child]) continue;
+          if (status == NO_OUTPUT || tainted[i]) tainted[child] = 1;
+          if (--pending[child] == 0) ready.push_back(child);
+        }
+      }
+
+      for (int j=0; j<(int)ready.size(); j++) {
+        int child = ready[j];
+        _threadPool->enqueue([&runNode, child]() { runNode(child); });
+      }
+    };
+
+    // collect the roots before dispatching any of them, as the pending counts
+    // start being updated by the worker threads as soon as the first one runs
+    ::essentia::VectorEx<int> roots;
+    for (int i=0; i<n; i++) {
+      if (active[i] && pending[i] == 0) roots.push_back(i);
+    }
+    for (int j=0; j<(int)roots.size(); j++) {
+      int root = roots[j];
+      _threadPool->enqueue([&runNode, root]() { runNode(root); });
+    }
+    _threadPool->wait();
+
+    if (error) rethrow_exception(error);
+
+    // next round: rescheduled algorithms and all their descendants
+    bool anyRescheduled = false;
+    for (int i=0; i<n; i++) active[i] = 0;
+    for (int i=0; i<n; i++) {
+      if (rescheduled[i]) {
+        active[i] = 1;
+        anyRescheduled = true;
+      }
+      if (!active[i]) continue;
+      for (int j=0; j<(int)_parallelChildren[i].size(); j++) {
+        active[_parallelChildren[i][j]] = 1;
+      }
+    }
+
+    if (!anyRescheduled) break;
+  }
+}
+
 Algorithm* Network::findAlgorithm(const std::string& name) {
   NodeVector nodes = depthFirstSearch(_visibleNetworkRoot);
   for (NodeVector::iterator node = nodes.begin(); node != nodes.end(); ++node) {
@@ -948,7 +1163,7 @@ void Network::printBufferFillState() {
          output != algo->outputs().end();
          ++output) {
 
-      BufferInfo buf = output->second->bufferInfo();
+      BufferInfo buf = output->second->allocatedBufferInfo();
       const string& name = output->first;
       int available = output->second->available();
       int used = buf.size - available;
@@ -987,6 +1202,31 @@ bool isExcludedFromInfo(const string& algoname) {
   return false;
 }
 
+/**
+ * Returns the smallest sizes with which the buffer of the given source can be
+ * allocated: its phantom zone has to hold the largest number of tokens
+ * acquired at once by the source or by one of its sinks, and the buffer
+ * should hold a couple of writes and reads, so that it does not need to grow
+ * when the tokens flow regularly.
+ */
+BufferInfo minimalBufferInfo(SourceBase* source, const BufferInfo& maxInfo, bool keepPhantomZone) {
+  int written = max(source->acquireSize(), source->releaseSize());
+  int read = 0;
+  const ::essentia::VectorEx<SinkBase*>& sinks = source->sinks();
+  for (int i=0; i<(int)sinks.size(); i++) {
+    read = max(read, max(sinks[i]->acquireSize(), sinks[i]->releaseSize()));
+  }
+
+  BufferInfo info;
+  info.maxContiguousElements = keepPhantomZone ? maxInfo.maxContiguousElements
+                                               : min(maxInfo.maxContiguousElements, max(written, read));
+  int size = 16;
+  while (size < 2*(written + read) || size <= info.maxContiguousElements) size *= 2;
+  info.size = min(maxInfo.size, size);
+
+  return info;
+}
+
 void Network::checkBufferSizes() {
   // TODO: we should do this on the execution network, right?
   E_DEBUG(ENetwork, "checking buffer sizes");
@@ -1046,12 +1286,67 @@ void Network::checkBufferSizes() {
           }
         }
       }
-      source->setBufferInfo(sbuf);
+      // only reallocate if needed, the allocated sizes are set below
+      BufferInfo current = source->bufferInfo();
+      if (current.size != sbuf.size || current.maxContiguousElements != sbuf.maxContiguousElements) {
+        source->setBufferInfo(sbuf);
+      }
+
+      source->setBufferMemoryBudget(_bufferBudget);
+      if (_adaptiveBufferSizes) {
+        bool concurrentReaders = _numThreads > 1 && sinks.size() > 1;
+        source->setAllocatedBufferInfo(minimalBufferInfo(source, sbuf, concurrentReaders));
+      }
+      else {
+        source->setAllocatedBufferInfo(sbuf);
+      }
     }
   }
+
+  if (_bufferBudget->limit() && _bufferBudget->used() > _bufferBudget->limit()) {
+    E_WARNING("Network: the buffers need at least " << _bufferBudget->used()
+              << " bytes, which exceeds the budget of " << _bufferBudget->limit() << " bytes");
+  }
   E_DEBUG(ENetwork, "checking buffer sizes ok");
 }
 
 
+uint64_t Network::bufferMemory() {
+  uint64_t total = 0;
+  ::essentia::VectorEx<Algorithm*> algos = depthFirstMap(executionNetworkRoot(), returnAlgorithm);
+  for (int i=0; i<(int)algos.size(); i++) {
+    const Algorithm::OutputMap& outputs = algos[i]->outputs();
+    for (Algorithm::OutputMap::const_iterator output = outputs.begin(); output != outputs.end(); ++output) {
+      total += output->second->bufferMemory();
+    }
+  }
+  return total;
+}
+
+void Network::printBufferMemory(ostream& out) {
+  ::essentia::VectorEx<Algorithm*> algos = depthFirstMap(executionNetworkRoot(), returnAlgorithm);
+
+  uint64_t total = 0;
+  out << pad("Buffer", 48) << pad("allocated", 20, ' ', true) << pad("maximum", 20, ' ', true)
+      << pad("memory [bytes]", 16, ' ', true) << "\n";
+  for (int i=0; i<(int)algos.size(); i++) {
+    const Algorithm::OutputMap& outputs = algos[i]->outputs();
+    for (Algorithm::OutputMap::const_iterator output = outputs.begin(); output != outputs.end(); ++output) {
+      SourceBase* source = output->second;
+      BufferInfo allocated = source->allocatedBufferInfo();
+      BufferInfo maximum = source->bufferInfo();
+      string allocatedSizes = (Stringifier() << allocated.size << " + " << allocated.maxContiguousElements).str();
+      string maximumSizes = (Stringifier() << maximum.size << " + " << maximum.maxContiguousElements).str();
+      string memory = (Stringifier() << source->bufferMemory()).str();
+
+      out << pad(source->fullName(), 48) << pad(allocatedSizes, 20, ' ', true)
+          << pad(maximumSizes, 20, ' ', true) << pad(memory, 16, ' ', true) << "\n";
+      total += source->bufferMemory();
+    }
+  }
+  out << pad("Total", 88) << pad((Stringifier() << total).str(), 16, ' ', true) << "\n";
+}
+
+
 } // namespace scheduler
 } // namespace essentia
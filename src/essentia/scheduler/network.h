@@ -23,10 +23,15 @@
 #include <vector>
 #include <set>
 #include <stack>
+#include <memory>
+#include <ostream>
 #include "../streaming/streamingalgorithm.h"
 #include "../essentiautil.h"
 
 namespace essentia {
+
+class ThreadPool;
+
 namespace streaming {
 
 class AlgorithmComposite;
@@ -41,6 +46,8 @@ class SourceBase;
 namespace essentia {
 namespace scheduler {
 
+class NetworkProfiler;
+
 typedef ::essentia::VectorEx<streaming::Algorithm*> AlgoVector;
 typedef std::set<streaming::Algorithm*> AlgoSet;
 
@@ -131,6 +138,96 @@ class Network {
    */
   bool runStep();
 
+  /**
+   * Sets the number of threads used to run the network. With 1 thread (the
+   * default), all the algorithms are run sequentially in topological order
+   * on the calling thread. With more than 1 thread, after each call to the
+   * generator the branches of the execution network which do not depend on
+   * each other are run concurrently on a pool of worker threads, an
+   * algorithm being run as soon as all its parents are done. A value of 0
+   * uses as many threads as the machine has hardware threads.
+   *
+   * Algorithms without outputs (PoolStorage, FileOutput, ...) usually write
+   * into structures shared with other algorithms, so they are never run
+   * concurrently with each other, unless essentia has been compiled with
+   * THREAD_SAFE_MUTEX, in which case the Pool can safely be written to by
+   * several of them at the same time.
+   *
+   * Takes effect at the next call to run() or runPrepare().
+   */
+  void setNumThreads(int nThreads);
+  int numThreads() const { return _numThreads; }
+
+  /**
+   * Sets how the buffers of the network are allocated when preparing it. With
+   * adaptive sizes (the default), a buffer only allocates what the acquire
+   * and release sizes of its source and sinks require, and then grows as
+   * needed up to its configured size (see Source::setBufferType), so that
+   * the memory of the network depends on the data actually flowing through
+   * it rather than on the worst case. Otherwise, buffers are allocated to
+   * their configured sizes.
+   *
+   * When running with several threads, the buffers read by several sinks
+   * keep their whole phantom zone, as their readers may run concurrently.
+   */
+  void setAdaptiveBufferSizes(bool adaptive) { _adaptiveBufferSizes = adaptive; }
+  bool adaptiveBufferSizes() const { return _adaptiveBufferSizes; }
+
+  /**
+   * Sets the maximum memory in bytes that the buffers of the network can
+   * allocate for the storage of their tokens, 0 (the default) meaning no
+   * limit. Buffers stop growing when the limit is reached, in which case
+   * their writers wait for the readers as if the buffers were full. The
+   * sizes required by the acquire sizes are always allocated, even if they
+   * exceed the budget.
+   */
+  void setBufferMemoryBudget(uint64_t bytes) { _bufferBudget->setLimit(bytes); }
+  uint64_t bufferMemoryBudget() const { return _bufferBudget->limit(); }
+
+  /**
+   * Returns the memory in bytes currently allocated by the buffers of the
+   * network for the storage of their tokens.
+   */
+  uint64_t bufferMemory();
+
+  /**
+   * Prints the allocated and configured sizes and the memory of each buffer
+   * of the network, followed by their total.
+   */
+  void printBufferMemory(std::ostream& out);
+
+  /**
+   * Enables the profiling of the algorithms of the network: the number of
+   * calls to their process() method and what they returned, the wall-clock
+   * and CPU time spent in it, and the number of tokens they produced. If
+   * @c trace is true, a timeline of the calls is recorded as well (see
+   * writeTrace). When profiling is disabled (the default), the scheduler
+   * only pays for a test of a pointer per call to process().
+   *
+   * Takes effect at the next call to run() or runPrepare(), which also
+   * clears the previous profile.
+   */
+  void setProfiling(bool enabled, bool trace = false);
+  bool profiling() const { return _profiling; }
+
+  /**
+   * Returns the profile of the current run, or 0 if profiling was not
+   * enabled when preparing it.
+   */
+  const NetworkProfiler* profiler() const { return _profiler; }
+
+  /**
+   * Prints the statistics of each algorithm of the current run, the
+   * algorithms taking the most time first.
+   */
+  void printProfile(std::ostream& out) const;
+
+  /**
+   * Writes the timeline of the current run in the trace event format of
+   * Chrome, which can be opened in chrome://tracing or in Perfetto.
+   */
+  void writeTrace(std::ostream& out) const;
+
   /**
    * Rebuilds the visible and execution network.
    */
@@ -209,6 +306,27 @@ class Network {
   NetworkNode* _executionNetworkRoot;
   ::essentia::VectorEx<streaming::Algorithm*> _toposortedNetwork;
 
+  int _numThreads;
+  ThreadPool* _threadPool;
+
+  bool _adaptiveBufferSizes;
+  std::shared_ptr<streaming::BufferMemoryBudget> _bufferBudget;
+
+  bool _profiling, _tracing;
+  NetworkProfiler* _profiler;
+
+  /**
+   * For each algorithm in @c _toposortedNetwork, the indices of the algorithms
+   * which should be run after it. Only used when running with several threads.
+   */
+  ::essentia::VectorEx<::essentia::VectorEx<int> > _parallelChildren;
+
+  /**
+   * Serializes the algorithms that have no outputs when running with several
+   * threads.
+   */
+  ForcedMutex _sinkMutex;
+
   /**
    * Build the network of visibly connected algorithms (ie: do not enter composite
    * algorithms) and stores its root in @c _visibleNetworkRoot.
@@ -237,6 +355,31 @@ class Network {
   // TODO: rename AlgoSet visibleAlgos() const;
   AlgoSet _algos;
 
+  /**
+   * Compute the dependencies between the indices of the topologically sorted
+   * network and create the thread pool, if running with several threads.
+   */
+  void buildParallelSchedule();
+
+  /**
+   * Call process() on the algorithm at the given index in @c _toposortedNetwork,
+   * through the profiler if there is one.
+   */
+  streaming::AlgorithmStatus processAlgorithm(int index);
+
+  /**
+   * Run the algorithm at the given index in @c _toposortedNetwork until it
+   * can't consume or produce anything anymore, and return the status of its
+   * last call to process().
+   */
+  streaming::AlgorithmStatus runAlgorithm(int index, bool endOfStream);
+
+  /**
+   * Run all the algorithms but the generator using the thread pool, as the
+   * multi-threaded counterpart of the loop in runStep().
+   */
+  void runStepParallel(bool endOfStream);
+
   /**
    * Check that all the algorithms inputs/outputs are connected somewhere, so as
    * to make sure that no buffer is being filled without anybody to empty it,
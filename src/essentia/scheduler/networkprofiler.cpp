@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "networkprofiler.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <thread>
+#include "../stringutil.h"
+#ifdef OS_WIN32
+#include <windows.h>
+#else // OS_WIN32
+#include <time.h>
+#endif // OS_WIN32
+
+using namespace std;
+using namespace essentia::streaming;
+
+namespace essentia {
+namespace scheduler {
+
+namespace {
+
+// CPU time consumed by the calling thread, in seconds
+double threadCpuTime() {
+#ifdef OS_WIN32
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0;
+  uint64_t k = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+  uint64_t u = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+  return (k + u) * 1e-7; // 100 ns units
+#else // OS_WIN32
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif // OS_WIN32
+}
+
+int totalProduced(Algorithm* algo) {
+  int total = 0;
+  for (int i=0; i<(int)algo->outputs().size(); i++) {
+    total += algo->output(i).totalProduced();
+  }
+  return total;
+}
+
+const char* statusName(AlgorithmStatus status) {
+  switch (status) {
+    case OK:        return "OK";
+    case PASS:      return "PASS";
+    case FINISHED:  return "FINISHED";
+    case NO_INPUT:  return "NO_INPUT";
+    case NO_OUTPUT: return "NO_OUTPUT";
+  }
+  return "UNKNOWN";
+}
+
+string jsonEscape(const string& str) {
+  string result;
+  for (int i=0; i<(int)str.size(); i++) {
+    char c = str[i];
+    if (c == '"' || c == '\\') result += '\\';
+    if ((unsigned char)c < 0x20) result += ' ';
+    else result += c;
+  }
+  return result;
+}
+
+string milliseconds(double seconds) {
+  ostringstream s;
+  s << fixed << setprecision(3) << seconds * 1e3;
+  return s.str();
+}
+
+} // namespace
+
+
+NetworkProfiler::NetworkProfiler(const ::essentia::VectorEx<Algorithm*>& algorithms, bool trace) :
+    _trace(trace), _start(chrono::steady_clock::now()),
+    _profiles(algorithms.size()), _events(algorithms.size()) {
+  for (int i=0; i<(int)algorithms.size(); i++) {
+    _profiles[i].name = algorithms[i]->name();
+  }
+}
+
+AlgorithmStatus NetworkProfiler::process(int index, Algorithm* algo) {
+  int producedBefore = totalProduced(algo);
+  // the CPU time is measured inside the wall-clock interval, so that it does
+  // not include reading the wall clock, which dominates for short calls
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  double cpuStart = threadCpuTime();
+
+  AlgorithmStatus status = algo->process();
+
+  double cpuTime = threadCpuTime() - cpuStart;
+  chrono::steady_clock::time_point end = chrono::steady_clock::now();
+  int produced = totalProduced(algo) - producedBefore;
+
+  AlgorithmProfile& profile = _profiles[index];
+  profile.calls++;
+  if (status == OK || status == FINISHED) profile.ok++;
+  else if (status == NO_INPUT) profile.noInput++;
+  else if (status == NO_OUTPUT) profile.noOutput++;
+  profile.wallTime += chrono::duration<double>(end - start).count();
+  profile.cpuTime += cpuTime;
+  // the outputs are reset when the network is, in which case there is no
+  // meaningful difference to take
+  if (produced > 0) profile.tokensProduced += produced;
+
+  if (_trace && status != NO_INPUT) {
+    Event event;
+    event.start = chrono::duration<double, micro>(start - _start).count();
+    event.duration = chrono::duration<double, micro>(end - start).count();
+    event.thread = hash<thread::id>()(this_thread::get_id());
+    event.status = status;
+    event.tokens = max(produced, 0);
+    _events[index].push_back(event);
+  }
+
+  return status;
+}
+
+void NetworkProfiler::printSummary(ostream& out) const {
+  double totalWall = 0, totalCpu = 0;
+  ::essentia::VectorEx<int> order(_profiles.size());
+  for (int i=0; i<(int)_profiles.size(); i++) {
+    order[i] = i;
+    totalWall += _profiles[i].wallTime;
+    totalCpu += _profiles[i].cpuTime;
+  }
+  stable_sort(order.begin(), order.end(), [this](int a, int b) {
+    return _profiles[a].wallTime > _profiles[b].wallTime;
+  });
+
+  out << pad("Algorithm", 40) << pad("calls", 12, ' ', true) << pad("NO_INPUT", 12, ' ', true)
+      << pad("NO_OUTPUT", 12, ' ', true) << pad("wall [ms]", 14, ' ', true)
+      << pad("cpu [ms]", 14, ' ', true) << pad("wall %", 9, ' ', true)
+      << pad("tokens", 14, ' ', true) << "\n";
+
+  for (int j=0; j<(int)order.size(); j++) {
+    const AlgorithmProfile& p = _profiles[order[j]];
+    ostringstream percent;
+    percent << fixed << setprecision(1) << (totalWall > 0 ? 100 * p.wallTime / totalWall : 0.);
+
+    out << pad(p.name, 40)
+        << pad((Stringifier() << p.calls).str(), 12, ' ', true)
+        << pad((Stringifier() << p.noInput).str(), 12, ' ', true)
+        << pad((Stringifier() << p.noOutput).str(), 12, ' ', true)
+        << pad(milliseconds(p.wallTime), 14, ' ', true)
+        << pad(milliseconds(p.cpuTime), 14, ' ', true)
+        << pad(percent.str(), 9, ' ', true)
+        << pad((Stringifier() << p.tokensProduced).str(), 14, ' ', true) << "\n";
+  }
+
+  out << pad("Total", 76) << pad(milliseconds(totalWall), 14, ' ', true)
+      << pad(milliseconds(totalCpu), 14, ' ', true) << "\n";
+}
+
+void NetworkProfiler::writeTrace(ostream& out) const {
+  // the threads are numbered in the order in which they first appear
+  map<size_t, int> threadIds;
+  ios::fmtflags flags = out.flags();
+  streamsize precision = out.precision();
+
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (int i=0; i<(int)_events.size(); i++) {
+    string name = jsonEscape(_profiles[i].name);
+    for (int j=0; j<(int)_events[i].size(); j++) {
+      const Event& e = _events[i][j];
+      map<size_t, int>::iterator tid = threadIds.find(e.thread);
+      if (tid == threadIds.end()) {
+        tid = threadIds.insert(make_pair(e.thread, (int)threadIds.size())).first;
+      }
+
+      out << (first ? "\n" : ",\n");
+      first = false;
+      out << fixed << setprecision(3)
+          << "{\"name\":\"" << name << "\",\"cat\":\"process\",\"ph\":\"X\""
+          << ",\"ts\":" << e.start << ",\"dur\":" << e.duration
+          << ",\"pid\":0,\"tid\":" << tid->second
+          << ",\"args\":{\"status\":\"" << statusName(e.status) << "\",\"tokens\":" << e.tokens << "}}";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+} // namespace scheduler
+} // namespace essentia
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SCHEDULER_NETWORKPROFILER_H
+#define ESSENTIA_SCHEDULER_NETWORKPROFILER_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+#include "../streaming/streamingalgorithm.h"
+
+namespace essentia {
+namespace scheduler {
+
+/**
+ * What the calls to process() of an algorithm of a network have cost, and
+ * what they have produced.
+ */
+struct AlgorithmProfile {
+  std::string name;
+  uint64_t calls;          // total number of calls to process()
+  uint64_t ok;             // calls which returned OK or FINISHED
+  uint64_t noInput;        // calls which returned NO_INPUT
+  uint64_t noOutput;       // calls which returned NO_OUTPUT (and got the algorithm rescheduled)
+  double wallTime;         // in seconds
+  double cpuTime;          // in seconds, of the thread running the algorithm
+  uint64_t tokensProduced; // on all the outputs of the algorithm
+
+  AlgorithmProfile() : calls(0), ok(0), noInput(0), noOutput(0),
+                       wallTime(0), cpuTime(0), tokensProduced(0) {}
+};
+
+
+/**
+ * A NetworkProfiler records the calls to process() of the algorithms of a
+ * Network, in the order of Network::linearExecutionOrder(). It is only
+ * created when profiling is enabled (see Network::setProfiling), so that the
+ * scheduler only pays for a test of a pointer otherwise.
+ *
+ * When tracing, it also records a timeline of the calls, which can be
+ * exported in the trace event format of Chrome (open it in chrome://tracing
+ * or https://ui.perfetto.dev). Calls which returned NO_INPUT are only counted,
+ * as they do no work and are by far the most frequent ones.
+ *
+ * Each algorithm has its own statistics and events, only updated by the
+ * thread running it, so that no locking is needed when the network runs on
+ * several threads.
+ */
+class NetworkProfiler {
+ public:
+  NetworkProfiler(const ::essentia::VectorEx<streaming::Algorithm*>& algorithms, bool trace);
+
+  /**
+   * Calls process() on the algorithm at the given index and records it.
+   */
+  streaming::AlgorithmStatus process(int index, streaming::Algorithm* algo);
+
+  const ::essentia::VectorEx<AlgorithmProfile>& profiles() const { return _profiles; }
+
+  /**
+   * Prints a table with the statistics of each algorithm, the algorithms
+   * taking the most time first.
+   */
+  void printSummary(std::ostream& out) const;
+
+  /**
+   * Writes the recorded timeline as a JSON document in the trace event
+   * format. Writes an empty timeline if tracing was not enabled.
+   */
+  void writeTrace(std::ostream& out) const;
+
+ protected:
+  struct Event {
+    double start;    // in microseconds since the creation of the profiler
+    double duration; // in microseconds
+    size_t thread;
+    streaming::AlgorithmStatus status;
+    int tokens;
+  };
+
+  bool _trace;
+  std::chrono::steady_clock::time_point _start;
+  ::essentia::VectorEx<AlgorithmProfile> _profiles;
+  ::essentia::VectorEx< ::essentia::VectorEx<Event> > _events;
+};
+
+} // namespace scheduler
+} // namespace essentia
+
+#endif // ESSENTIA_SCHEDULER_NETWORKPROFILER_H
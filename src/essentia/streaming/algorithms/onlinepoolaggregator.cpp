@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "onlinepoolaggregator.h"
+#include "../../essentiautil.h"
+#include "../../utils/tnt/tnt.h"
+#include "../../utils/tnt/jama_lu.h"
+using namespace std;
+
+namespace essentia {
+namespace streaming {
+
+namespace {
+
+const char* supportedStats[] =
+  {"min", "max", "median", "mean", "var", "stdev", "skew", "kurt",
+   "dmean", "dvar", "dmean2", "dvar2",
+   "cov", "icov",
+   "copy", "value", "last"};
+
+} // namespace
+
+
+OnlinePoolAggregatorBase::OnlinePoolAggregatorBase(Pool* pool, const string& descriptorName,
+                                                   const ::essentia::VectorEx<string>& stats,
+                                                   bool vectorFrames) :
+  PoolStorageBase(pool, descriptorName), _stats(stats), _vectorFrames(vectorFrames),
+  _finished(false) {
+
+  ::essentia::VectorEx<string> supported = arrayToVector<string>(supportedStats);
+  for (int i=0; i<(int)_stats.size(); i++) {
+    if (!contains(supported, _stats[i])) {
+      throw EssentiaException("OnlinePoolAggregator: unsupported aggregation statistic: '" + _stats[i] + "'");
+    }
+  }
+
+  if ((wants("copy") || wants("last")) && _stats.size() != 1) {
+    throw EssentiaException("OnlinePoolAggregator: the 'copy' and 'last' aggregation statistics "
+                            "are exclusive, they cannot be used with other statistics for the "
+                            "same descriptor");
+  }
+
+  if (!_vectorFrames && (wants("cov") || wants("icov"))) {
+    throw EssentiaException("OnlinePoolAggregator: 'cov' and 'icov' can only be computed for "
+                            "vectors of Real, not for \"" + descriptorName + "\"");
+  }
+
+  _moments = wants("mean") || wants("var") || wants("stdev") || wants("skew") || wants("kurt");
+  _minmax = wants("min") || wants("max");
+  _median = wants("median");
+  _derived = wants("dmean") || wants("dvar");
+  _derived2 = wants("dmean2") || wants("dvar2");
+  _covariance = wants("cov") || wants("icov");
+  _copy = wants("copy");
+  _value = wants("value");
+
+  reset();
+}
+
+bool OnlinePoolAggregatorBase::wants(const char* stat) const {
+  return contains(_stats, string(stat));
+}
+
+void OnlinePoolAggregatorBase::reset() {
+  PoolStorageBase::reset();
+  _nFrames = 0;
+  _differentSizes = false;
+  _finished = false;
+}
+
+void OnlinePoolAggregatorBase::addFrame(const Real* frame, int size) {
+  if (_nFrames == 0) {
+    // the size of the frames is only known now
+    _columnMoments.resize(0);
+    _columnMoments.resize(_moments ? size : 0);
+    _derivedMoments.resize(0);
+    _derivedMoments.resize(_derived ? size : 0);
+    _derived2Moments.resize(0);
+    _derived2Moments.resize(_derived2 ? size : 0);
+    _medians.resize(0);
+    _medians.resize(_median ? size : 0);
+    _cov.setSize(_covariance ? size : 0);
+    if (_minmax) {
+      _min.assign(frame, frame + size);
+      _max.assign(frame, frame + size);
+    }
+    _prev.resize(size);
+    _prev2.resize(size);
+  }
+  else if (size != (int)_prev.size()) {
+    _differentSizes = true;
+  }
+
+  if (_differentSizes) return;
+
+  for (int j=0; j<size; j++) {
+    Real x = frame[j];
+    if (_moments) _columnMoments[j].add(x);
+    if (_median) _medians[j].add(x);
+    if (_minmax) {
+      _min[j] = min(x, _min[j]);
+      _max[j] = max(x, _max[j]);
+    }
+
+    // the absolute values are taken before computing the variance, so that
+    // the mean and the variance of the derivatives are consistent
+    if (_nFrames > 0) {
+      Real diff = x - _prev[j];
+      if (_derived) _derivedMoments[j].add(abs(diff));
+      if (_derived2 && _nFrames > 1) _derived2Moments[j].add(abs(diff - (_prev[j] - _prev2[j])));
+    }
+  }
+  if (_covariance) _cov.add(frame);
+
+  _prev.swap(_prev2);
+  copy(frame, frame + size, _prev.begin());
+  _nFrames++;
+}
+
+void OnlinePoolAggregatorBase::finalProduce() {
+  if (_nFrames == 0) return;
+
+  if (_differentSizes) {
+    E_WARNING("OnlinePoolAggregator: not aggregating \"" << _descriptorName << "\" because it has frames of different sizes");
+    return;
+  }
+
+  int size = (int)_prev.size();
+  ::essentia::VectorEx<Real> values(size);
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > cov, icov;
+
+  if (_covariance) {
+    if (_nFrames < 2) {
+      throw EssentiaException("OnlinePoolAggregator: cannot compute the covariance of \"" +
+                              _descriptorName + "\" which has a single frame");
+    }
+
+    TNT::Array2D<double> covDouble(size, size);
+    cov.resize(size, ::essentia::VectorEx<Real>(size));
+    for (int i=0; i<size; i++) {
+      for (int j=0; j<size; j++) {
+        covDouble[i][j] = _cov.covariance(i, j);
+        cov[i][j] = (Real)covDouble[i][j];
+      }
+    }
+
+    if (wants("icov")) {
+      // same as SingleGaussian: the inverse is computed in double precision
+      JAMA::LU<double> solver(covDouble);
+      if (!solver.isNonsingular()) {
+        throw EssentiaException("OnlinePoolAggregator: cannot compute the inverse covariance of \"" +
+                                _descriptorName + "\" because its covariance matrix is singular");
+      }
+      TNT::Array2D<double> identity(size, size, 0.0);
+      for (int i=0; i<size; i++) identity[i][i] = 1.0;
+      TNT::Array2D<double> inverse = solver.solve(identity);
+
+      icov.resize(size, ::essentia::VectorEx<Real>(size));
+      for (int i=0; i<size; i++) {
+        for (int j=0; j<size; j++) icov[i][j] = (Real)inverse[i][j];
+      }
+    }
+  }
+
+  for (int s=0; s<(int)_stats.size(); s++) {
+    const string& stat = _stats[s];
+    string subkey = _descriptorName + "." + stat;
+
+    if (stat == "copy" || stat == "value") continue;
+
+    if (stat == "last") {
+      if (_vectorFrames) _pool->set(_descriptorName, _prev);
+      else               _pool->set(_descriptorName, _prev[0]);
+      continue;
+    }
+
+    if (stat == "cov" || stat == "icov") {
+      const ::essentia::VectorEx<::essentia::VectorEx<Real> >& matrix = stat == "cov" ? cov : icov;
+      for (int i=0; i<size; i++) _pool->add(subkey, matrix[i]);
+      continue;
+    }
+
+    for (int j=0; j<size; j++) {
+      if      (stat == "mean")   values[j] = _columnMoments[j].mean();
+      else if (stat == "var")    values[j] = _columnMoments[j].variance();
+      else if (stat == "stdev")  values[j] = sqrt(_columnMoments[j].variance());
+      else if (stat == "skew")   values[j] = _columnMoments[j].skewness();
+      else if (stat == "kurt")   values[j] = _columnMoments[j].kurtosis();
+      else if (stat == "min")    values[j] = _min[j];
+      else if (stat == "max")    values[j] = _max[j];
+      else if (stat == "median") values[j] = _medians[j].value();
+      else if (stat == "dmean")  values[j] = _derivedMoments[j].mean();
+      else if (stat == "dvar")   values[j] = _derivedMoments[j].variance();
+      else if (stat == "dmean2") values[j] = _derived2Moments[j].mean();
+      else if (stat == "dvar2")  values[j] = _derived2Moments[j].variance();
+    }
+
+    // same layout as the output of the PoolAggregator algorithm
+    if (_vectorFrames) {
+      for (int j=0; j<size; j++) _pool->add(subkey, values[j]);
+    }
+    else {
+      _pool->set(subkey, values[0]);
+    }
+  }
+}
+
+
+#define CREATE_ONLINE_POOL_AGGREGATOR(type)\
+  if (sameType(sourceType, typeid(type))) {\
+     agg = new OnlinePoolAggregator<type>(&pool, descriptorName, stats);\
+  }
+
+void connectAggregated(SourceBase& source, Pool& pool, const string& descriptorName,
+                       const ::essentia::VectorEx<string>& stats) {
+
+  const type_info& sourceType = source.typeInfo();
+
+  Algorithm* agg = 0;
+
+  CREATE_ONLINE_POOL_AGGREGATOR(Real);
+  CREATE_ONLINE_POOL_AGGREGATOR(::essentia::VectorEx<Real>);
+
+  // convert int to Real
+  if (sameType(sourceType, typeid(int))) agg = new OnlinePoolAggregator<int, Real>(&pool, descriptorName, stats);
+
+  if (!agg) throw EssentiaException("OnlinePoolAggregator doesn't work for type: ", nameOfType(sourceType));
+
+  try {
+    connect(source, agg->input("data"));
+  }
+  catch (EssentiaException& e) {
+    delete agg;
+    std::ostringstream msg;
+    msg << "While connecting " << source.fullName()
+        << " to Pool[" << descriptorName << "]:\n"
+        << e.what();
+    throw EssentiaException(msg);
+  }
+}
+
+} // namespace streaming
+} // namespace essentia
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_ONLINEPOOLAGGREGATOR_H
+#define ESSENTIA_ONLINEPOOLAGGREGATOR_H
+
+#include "poolstorage.h"
+#include "../../utils/runningmoments.h"
+#include "../../utils/p2quantile.h"
+
+namespace essentia {
+namespace streaming {
+
+/**
+ * Aggregates the frames of a descriptor as they come in, and writes the
+ * aggregated values to the Pool at the end of the stream, so that the frames
+ * themselves never have to be stored. The statistics are selected with the
+ * names used by the PoolAggregator algorithm, and are written under the same
+ * names ('<descriptor name>.mean', etc.):
+ *  - the mean, variance, standard deviation, skewness and kurtosis, and those
+ *    of the absolute values of the derivatives, come from running moments;
+ *  - the median is estimated with the P² algorithm, and is exact for up to 5
+ *    frames only;
+ *  - the covariance and inverse covariance are computed from a running
+ *    co-moment matrix.
+ *
+ * 'copy' and 'value' are accepted too, but they add every frame to the Pool,
+ * as a PoolStorage would.
+ */
+class OnlinePoolAggregatorBase : public PoolStorageBase {
+ public:
+  OnlinePoolAggregatorBase(Pool* pool, const std::string& descriptorName,
+                           const ::essentia::VectorEx<std::string>& stats,
+                           bool vectorFrames);
+
+  const ::essentia::VectorEx<std::string>& stats() const { return _stats; }
+
+  void declareParameters() {}
+
+  void reset();
+
+ protected:
+  void addFrame(const Real* frame, int size);
+  void finalProduce();
+
+  bool wants(const char* stat) const;
+
+  ::essentia::VectorEx<std::string> _stats;
+  bool _vectorFrames;
+  bool _moments, _minmax, _median, _derived, _derived2, _covariance;
+  bool _copy, _value;
+
+  int _nFrames;
+  bool _differentSizes;
+  bool _finished;
+
+  ::essentia::VectorEx<util::RunningMoments> _columnMoments;
+  ::essentia::VectorEx<util::RunningMoments> _derivedMoments;
+  ::essentia::VectorEx<util::RunningMoments> _derived2Moments;
+  ::essentia::VectorEx<util::P2Quantile> _medians;
+  util::RunningCovariance _cov;
+  ::essentia::VectorEx<Real> _min, _max;
+  // the last two frames, needed by the derivatives and by 'last'
+  ::essentia::VectorEx<Real> _prev, _prev2;
+};
+
+
+template <typename TokenType, typename FrameType = TokenType>
+class OnlinePoolAggregator : public OnlinePoolAggregatorBase {
+ protected:
+  Sink<TokenType> _data;
+
+ public:
+  OnlinePoolAggregator(Pool* pool, const std::string& descriptorName,
+                       const ::essentia::VectorEx<std::string>& stats) :
+    OnlinePoolAggregatorBase(pool, descriptorName, stats, isVector((FrameType*)0)) {
+
+    setName("OnlinePoolAggregator");
+    declareInput(_data, 1, "data", "the input data");
+  }
+
+  AlgorithmStatus process() {
+    if (_finished) return FINISHED;
+
+    int ntokens = std::min(_data.available(),
+                           _data.buffer().bufferInfo().maxContiguousElements);
+    ntokens = std::max(ntokens, 1);
+
+    if (!_data.acquire(ntokens)) {
+      // all the frames have been aggregated once the end of the stream is reached
+      if (!shouldStop()) return NO_INPUT;
+
+      finalProduce();
+      _finished = true;
+      return FINISHED;
+    }
+
+    const ::essentia::VectorEx<TokenType>& tokens = _data.tokens();
+    for (int i=0; i<ntokens; i++) aggregate(tokens[i]);
+
+    _data.release(ntokens);
+
+    return OK;
+  }
+
+ protected:
+  static bool isVector(const Real*) { return false; }
+  static bool isVector(const ::essentia::VectorEx<Real>*) { return true; }
+
+  void aggregate(Real value) {
+    if (_copy) _pool->add(_descriptorName, value);
+    if (_value) _pool->add(_descriptorName + ".value", value);
+    addFrame(&value, 1);
+  }
+
+  void aggregate(const ::essentia::VectorEx<Real>& frame) {
+    if (_copy) _pool->add(_descriptorName, frame);
+    if (_value) _pool->add(_descriptorName + ".value", frame);
+    addFrame(frame.data(), (int)frame.size());
+  }
+};
+
+
+/**
+ * Connect a source of Real or of vectors of Real to a Pool through an
+ * OnlinePoolAggregator, so that only the given statistics of the frames end
+ * up in the Pool under the given descriptor name, instead of the frames
+ * themselves.
+ */
+void connectAggregated(SourceBase& source, Pool& pool,
+                       const std::string& descriptorName,
+                       const ::essentia::VectorEx<std::string>& stats);
+
+} // namespace streaming
+} // namespace essentia
+
+#endif // ESSENTIA_ONLINEPOOLAGGREGATOR_H
@@ -52,10 +52,13 @@ template <typename TokenType, typename StorageType = TokenType>
 class PoolStorage : public PoolStorageBase {
  protected:
   Sink<TokenType> _descriptor;
+  // single tokens are added through a handle, so that the descriptor name
+  // isn't looked up for each one of them
+  DescriptorHandle<StorageType> _handle;
 
  public:
   PoolStorage(Pool* pool, const std::string& descriptorName, bool setSingle = false) :
-    PoolStorageBase(pool, descriptorName, setSingle) {
+    PoolStorageBase(pool, descriptorName, setSingle), _handle(descriptorName) {
 
     setName("PoolStorage");
     declareInput(_descriptor, 1, "data", "the input data");
@@ -99,18 +102,18 @@ class PoolStorage : public PoolStorageBase {
       for (int i=0; i<(int)value.size();++i)
       _pool->add(_descriptorName, value[i]);
     }
-    else _pool->add(_descriptorName, value);
+    else _pool->add(_handle, value);
   }
 
   void addToPool(const ::essentia::VectorEx<Real>& value) {
     if (_setSingle) _pool->set(_descriptorName, value);
-    else            _pool->add(_descriptorName, value);
+    else            _pool->add(_handle, value);
   }
 
   template <typename T>
   void addToPool(const T& value) {
     if (_setSingle) _pool->set(_descriptorName, value);
-    else            _pool->add(_descriptorName, value);
+    else            _pool->add(_handle, value);
    }
 
   template <typename T>
@@ -136,7 +139,7 @@ class PoolStorage : public PoolStorageBase {
                               " is not supported by Pool.");
     }
     else {
-      _pool->add(_descriptorName, value);
+      _pool->add(_handle, value);
     }
   }
 
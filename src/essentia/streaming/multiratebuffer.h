@@ -20,12 +20,89 @@
 #ifndef ESSENTIA_MULTIRATEBUFFER_H
 #define ESSENTIA_MULTIRATEBUFFER_H
 
+#include <atomic>
+#include <memory>
 #include <vector>
+#include <stdint.h>
 #include "../types.h"
 
 namespace essentia {
 namespace streaming {
 
+/**
+ * Bound on the memory allocated for the storage of a set of buffers, usually
+ * all the buffers of a network (see Network::setBufferMemoryBudget). Buffers
+ * account for the memory they allocate in it, and only grow if the result
+ * fits in the budget. A limit of 0 means no limit, in which case the budget
+ * only keeps track of the memory used.
+ */
+class BufferMemoryBudget {
+ public:
+  BufferMemoryBudget(uint64_t limit = 0) : _limit(limit), _used(0) {}
+
+  uint64_t limit() const { return _limit; }
+  void setLimit(uint64_t limit) { _limit = limit; }
+  uint64_t used() const { return _used; }
+
+  /**
+   * Accounts for the allocation of the given number of bytes if it fits in
+   * the budget, returns false otherwise.
+   */
+  bool allocate(uint64_t bytes) {
+    uint64_t used = _used.load();
+    do {
+      if (_limit && used + bytes > _limit) return false;
+    } while (!_used.compare_exchange_weak(used, used + bytes));
+    return true;
+  }
+
+  /**
+   * Accounts for the allocation of the given number of bytes, even if it
+   * exceeds the budget (for the memory a buffer cannot work without).
+   */
+  void forceAllocate(uint64_t bytes) { _used += bytes; }
+
+  void free(uint64_t bytes) { _used -= bytes; }
+
+ protected:
+  uint64_t _limit;
+  std::atomic<uint64_t> _used;
+};
+
+
+/**
+ * Returns the sizes of the buffers for the given type of usage.
+ */
+inline BufferInfo bufferInfoForUsage(BufferUsage::BufferUsageType type) {
+  BufferInfo buf;
+  switch (type) {
+  case BufferUsage::forSingleFrames:
+    buf.size = 16;
+    buf.maxContiguousElements = 0;
+    break;
+
+  case BufferUsage::forMultipleFrames:
+    buf.size = 262144;
+    buf.maxContiguousElements = 32768;
+    break;
+
+  case BufferUsage::forAudioStream:
+    buf.size = 65536;
+    buf.maxContiguousElements = 4096;
+    break;
+
+  case BufferUsage::forLargeAudioStream:
+    buf.size = 1048576;
+    buf.maxContiguousElements = 262144;
+    break;
+
+  default:
+    throw EssentiaException("Unknown buffer type");
+  }
+  return buf;
+}
+
+
 template <typename T>
 class MultiRateBuffer {
 
@@ -36,6 +113,15 @@ class MultiRateBuffer {
   virtual BufferInfo bufferInfo() const = 0;
   virtual void setBufferInfo(const BufferInfo& info) = 0;
 
+  // sizes for which storage is currently allocated, at most those of
+  // bufferInfo(). The buffer grows as needed, up to bufferInfo()
+  virtual BufferInfo allocatedBufferInfo() const = 0;
+  virtual void setAllocatedBufferInfo(const BufferInfo& info) = 0;
+
+  // memory allocated for the storage of the tokens, in bytes
+  virtual uint64_t bufferMemory() const = 0;
+  virtual void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) = 0;
+
   // add/remove readers to/from the buffer
   // returns the id of the newly attached reader
   virtual ReaderID addReader(bool startFromZero = false) = 0;
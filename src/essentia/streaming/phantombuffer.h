@@ -55,72 +55,83 @@ class Window {
  *
  * NB: we can only guarantee that availableFor* returns a least the size of the phantom buffer, not more
  *     we have to choose the size of the phantom zone carefully, or make it dynamically resizable
+ *
+ * The sizes given by setBufferType() or setBufferInfo() are the maximum sizes
+ * of the buffer, they don't allocate anything. The storage is allocated by
+ * setAllocatedBufferInfo(), which the Network calls when it is prepared, or
+ * else with a small size the first time tokens are acquired. The buffer then
+ * grows (keeping the tokens it holds) whenever a writer or a reader needs
+ * more room, until it reaches its maximum sizes or the limit of its memory
+ * budget, if any.
  */
 template <typename T>
 class PhantomBuffer : public MultiRateBuffer<T> {
 
  public:
 
-  PhantomBuffer(SourceBase* parent, BufferUsage::BufferUsageType type) {
-    _parent = parent;
+  PhantomBuffer(SourceBase* parent, BufferUsage::BufferUsageType type) :
+    _parent(parent), _bufferSize(0), _phantomSize(0) {
     setBufferType(type);
   }
 
   void setBufferType(BufferUsage::BufferUsageType type) {
-    BufferInfo buf;
-    switch (type) {
-    case BufferUsage::forSingleFrames:
-      buf.size = 16;
-      buf.maxContiguousElements = 0;
-      break;
-
-    case BufferUsage::forMultipleFrames:
-      buf.size = 262144;
-      buf.maxContiguousElements = 32768;
-      break;
-
-    case BufferUsage::forAudioStream:
-      buf.size = 65536;
-      buf.maxContiguousElements = 4096;
-      break;
-
-    case BufferUsage::forLargeAudioStream:
-      buf.size = 1048576;
-      buf.maxContiguousElements = 262144;
-      break;
-
-    default:
-      throw EssentiaException("Unknown buffer type");
-    }
-
-    setBufferInfo(buf);
+    setBufferInfo(bufferInfoForUsage(type));
   }
 
   BufferInfo bufferInfo() const {
     BufferInfo info;
-    info.size = _bufferSize;
-    info.maxContiguousElements = _phantomSize;
+    info.size = _maxBufferSize;
+    info.maxContiguousElements = _maxPhantomSize;
     return info;
   }
 
   void setBufferInfo(const BufferInfo& info) {
-    _bufferSize = info.size;
-    _phantomSize = info.maxContiguousElements;
-    _buffer.resize(_bufferSize + _phantomSize);
+    _maxBufferSize = info.size;
+    _maxPhantomSize = info.maxContiguousElements;
+    // only the storage already allocated above the new maximum sizes changes
+    if (!_buffer.empty() && (_bufferSize > _maxBufferSize || _phantomSize > _maxPhantomSize)) {
+      reallocate((std::min)(_bufferSize, _maxBufferSize),
+                 (std::min)(_phantomSize, _maxPhantomSize), true);
+    }
+  }
+
+  BufferInfo allocatedBufferInfo() const {
+    return BufferInfo(_bufferSize, _phantomSize);
+  }
+
+  /**
+   * Only allocates storage for the given sizes (at most those of bufferInfo()),
+   * the buffer then grows as needed. It keeps the tokens it holds, so it may
+   * allocate more than asked for if they do not fit.
+   */
+  void setAllocatedBufferInfo(const BufferInfo& info) {
+    reallocate((std::min)(info.size, _maxBufferSize),
+               (std::min)(info.maxContiguousElements, _maxPhantomSize), true);
+  }
+
+  uint64_t bufferMemory() const {
+    return (uint64_t)(_bufferSize + _phantomSize) * sizeof(T);
+  }
+
+  void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) {
+    if (_budget) _budget->free(bufferMemory());
+    _budget = budget;
+    if (_budget) _budget->forceAllocate(bufferMemory());
   }
 
   PhantomBuffer(SourceBase* parent, int size, int phantomSize) :
     _parent(parent),
     _bufferSize(size),
     _phantomSize(phantomSize),
+    _maxBufferSize(size),
+    _maxPhantomSize(phantomSize),
     _buffer(size + phantomSize) {
     // initialize views and all??
   }
 
-  /**
-   * @todo implement me if necessary
-   */
-  ~PhantomBuffer() {}
+  ~PhantomBuffer() {
+    if (_budget) _budget->free(bufferMemory());
+  }
 
   const ::essentia::VectorEx<T>& readView(ReaderID id) const;
   ::essentia::VectorEx<T>& writeView() { return _writeView; }
@@ -160,9 +171,7 @@ class PhantomBuffer : public MultiRateBuffer<T> {
    *       it takes too much time, as it should be called only very rarely
    */
   void resize(int size, int phantomSize) {
-    _buffer.resize(size+phantomSize);
-    _bufferSize = size;
-    _phantomSize = phantomSize;
+    setBufferInfo(BufferInfo(size, phantomSize));
   }
 
   int totalTokensWritten() const {
@@ -193,6 +202,8 @@ class PhantomBuffer : public MultiRateBuffer<T> {
   SourceBase* _parent;
 
   int _bufferSize, _phantomSize; // bufferSize does not include phantomSize
+  int _maxBufferSize, _maxPhantomSize; // sizes up to which the buffer can grow
+  std::shared_ptr<BufferMemoryBudget> _budget; // budget from which the storage is allocated, if any
   ::essentia::VectorEx<T> _buffer; // the buffer where data is stored
   // bufferSize must be > phantomSize in all cases
 
@@ -224,6 +235,19 @@ class PhantomBuffer : public MultiRateBuffer<T> {
   void relocateReadWindow(ReaderID id);
   void relocateWriteWindow();
 
+  // changes the size of the storage, keeping the tokens that have not been
+  // read by all readers yet. Returns false if it did not fit in the budget,
+  // unless force is true
+  bool reallocate(int size, int phantomSize, bool force);
+
+  // allocates a small storage for the first acquire of requested tokens, if
+  // setAllocatedBufferInfo() has not been called
+  void allocate(int requested);
+
+  // grows the buffer so that requested tokens can be acquired, if possible
+  bool growForWrite(int requested);
+  bool growForRead(int requested);
+
 };
 
 } // namespace streaming
@@ -74,15 +74,23 @@ bool PhantomBuffer<T>::acquireForRead(ReaderID id, int requested) {
   // 1) we're strictly before the phantom zone (from at least 1 token), so no pb
   // 2) we're just at the beginning of the phantom zone, but in that case we
   //    should have been relocated to the beginning of the buffer
-  if (requested > (_phantomSize + 1)) {
+  if (requested > (_maxPhantomSize + 1)) {
     // warning: this could cause a buffer to block, we need to reallocate or throw an exception here
     std::ostringstream msg;
-    msg << "acquireForRead: Requested number of tokens (" << requested << ") > phantom size (" << _phantomSize << ")";
+    msg << "acquireForRead: Requested number of tokens (" << requested << ") > phantom size (" << _maxPhantomSize << ")";
     msg << " in " << _parent->fullName() << " → " << _parent->sinks()[id]->fullName();
     throw EssentiaException(msg);
   }
 
   MutexLocker lock(mutex); NOWARN_UNUSED(lock);
+  if (_buffer.empty()) allocate(requested);
+  if (requested > (_phantomSize + 1) && !growForRead(requested)) {
+    std::ostringstream msg;
+    msg << "acquireForRead: Could not grow the phantom zone to " << requested << " tokens";
+    msg << " in " << _parent->fullName() << " → " << _parent->sinks()[id]->fullName();
+    msg << ", the buffer memory budget is exhausted";
+    throw EssentiaException(msg);
+  }
   if (availableForRead(id) < requested) return false;
 
   _readWindow[id].end = _readWindow[id].begin + requested;
@@ -102,16 +110,19 @@ bool PhantomBuffer<T>::acquireForWrite(int requested) {
 
   //DEBUG_NL("acquire " << requested << " for write... (" << availableForWrite() << " available)");
 
-  if (requested > (_phantomSize + 1)) {
+  if (requested > (_maxPhantomSize + 1)) {
     // warning: this could cause a buffer to block, we need to reallocate or throw an exception here
     std::ostringstream msg;
-    msg << "acquireForWrite: Requested number of tokens (" << requested << ") > phantom size (" << _phantomSize << ")";
+    msg << "acquireForWrite: Requested number of tokens (" << requested << ") > phantom size (" << _maxPhantomSize << ")";
     msg << " in " << _parent->fullName();
     throw EssentiaException(msg);
   }
 
   MutexLocker lock(mutex); NOWARN_UNUSED(lock);
-  if (availableForWrite() < requested) return false;
+  if (_buffer.empty()) allocate(requested);
+  // when the buffer is full, it grows rather than waiting for the readers,
+  // as long as it has not reached its maximum size
+  if (availableForWrite() < requested && !growForWrite(requested)) return false;
 
   _writeWindow.end = _writeWindow.begin + requested;
   updateWriteView();
@@ -201,13 +212,13 @@ template <typename T>
 inline void PhantomBuffer<T>::updateReadView(ReaderID id) {
   const RogueVector<T>& vconst = static_cast<const RogueVector<T>&>(readView(id));
   RogueVector<T>& v = const_cast<RogueVector<T>&>(vconst);
-  v.setData(&_buffer[0] + _readWindow[id].begin);
+  v.setData(_buffer.data() + _readWindow[id].begin);
   v.setSize(_readWindow[id].end - _readWindow[id].begin);
 }
 
 template <typename T>
 inline void PhantomBuffer<T>::updateWriteView() {
-  _writeView.setData(&_buffer[0] + _writeWindow.begin);
+  _writeView.setData(_buffer.data() + _writeWindow.begin);
   _writeView.setSize(_writeWindow.end - _writeWindow.begin);
 }
 
@@ -294,6 +305,104 @@ void PhantomBuffer<T>::relocateReadWindow(ReaderID id) {
   }
 }
 
+/**
+ * Moves the tokens to a buffer of the given size: the tokens that have not
+ * been read by all readers yet are moved to the same position modulo the new
+ * size, so that the totals of tokens read and written by everyone stay the
+ * same, and the phantom zone is copied again from the beginning of the
+ * buffer. The windows are left empty, so this should only be called when no
+ * tokens are acquired, which is the case at the beginning of an acquire.
+ */
+template <typename T>
+bool PhantomBuffer<T>::reallocate(int size, int phantomSize, bool force) {
+  if (size == _bufferSize && phantomSize == _phantomSize && !_buffer.empty()) return true;
+
+  int written = _writeWindow.total(_bufferSize);
+  int oldest = written;
+  for (int i=0; i<(int)_readWindow.size(); i++) {
+    oldest = (std::min)(oldest, _readWindow[i].total(_bufferSize));
+  }
+  // also keep the last token produced
+  if (written > 0) oldest = (std::min)(oldest, written - 1);
+
+  // the tokens still to be read need to fit, and the buffer needs to be
+  // larger than its phantom zone
+  size = (std::max)(size, (std::max)(written - oldest, phantomSize + 1));
+
+  int64_t delta = ((int64_t)(size + phantomSize) - (_bufferSize + _phantomSize)) * (int64_t)sizeof(T);
+  if (_budget) {
+    if (delta > 0) {
+      if (force) _budget->forceAllocate(delta);
+      else if (!_budget->allocate(delta)) return false;
+    }
+    else {
+      _budget->free(-delta);
+    }
+  }
+
+  ::essentia::VectorEx<T> buffer(size + phantomSize);
+  for (int t=oldest; t<written; t++) {
+    std::swap(buffer[t % size], _buffer[t % _bufferSize]);
+  }
+  T* first = &buffer[0];
+  fastcopy(first + size, first, phantomSize);
+  _buffer.swap(buffer);
+
+  std::vector<int> totals(_readWindow.size());
+  for (int i=0; i<(int)_readWindow.size(); i++) totals[i] = _readWindow[i].total(_bufferSize);
+
+  _bufferSize = size;
+  _phantomSize = phantomSize;
+
+  _writeWindow.turn = written / size;
+  _writeWindow.begin = _writeWindow.end = written % size;
+  updateWriteView();
+
+  for (int i=0; i<(int)_readWindow.size(); i++) {
+    _readWindow[i].turn = totals[i] / size;
+    _readWindow[i].begin = _readWindow[i].end = totals[i] % size;
+    updateReadView(i);
+  }
+
+  return true;
+}
+
+template <typename T>
+void PhantomBuffer<T>::allocate(int requested) {
+  int phantomSize = (std::min)(_maxPhantomSize, requested);
+  int size = 16;
+  while (size < 2*requested || size <= phantomSize) size *= 2;
+  reallocate((std::min)(_maxBufferSize, size), phantomSize, true);
+}
+
+template <typename T>
+bool PhantomBuffer<T>::growForWrite(int requested) {
+  int phantomSize = _phantomSize;
+  if (requested > phantomSize + 1) {
+    phantomSize = (std::min)(_maxPhantomSize, (std::max)(2*phantomSize, requested));
+  }
+
+  // tokens that still have to be read by at least one reader
+  int pending = _bufferSize - availableForWrite(false);
+  int size = _bufferSize;
+  if (pending + requested > size || phantomSize >= size) {
+    size = (std::max)(2*size, (std::max)(pending + requested, phantomSize + 1));
+    size = (std::max)(_bufferSize, (std::min)(_maxBufferSize, size));
+  }
+
+  if (size == _bufferSize && phantomSize == _phantomSize) return false;
+  if (!reallocate(size, phantomSize, false)) return false;
+
+  return availableForWrite() >= requested;
+}
+
+template <typename T>
+bool PhantomBuffer<T>::growForRead(int requested) {
+  int phantomSize = (std::min)(_maxPhantomSize, (std::max)(2*_phantomSize, requested));
+  int size = (std::max)(_bufferSize, (std::min)(_maxBufferSize, 2*phantomSize));
+  return reallocate(size, phantomSize, false);
+}
+
 template <typename T>
 void PhantomBuffer<T>::reset() {
   // we don't need to clear the buffer, because when new data is written to the
@@ -63,6 +63,7 @@ class Sink : public SinkBase {
 
   virtual const void* getTokens() const { return &tokens(); }
   virtual const void* getFirstToken() const { return &firstToken(); }
+  virtual const void* getToken(int i) const { return &tokens()[i]; }
 
   inline void acquire() { StreamConnector::acquire(); }
 
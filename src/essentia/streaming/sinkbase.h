@@ -85,6 +85,9 @@ class SinkBase : public Connector {
   // should return a TokenType*
   virtual const void* getFirstToken() const = 0;
 
+  // should return a TokenType*, pointing to the i-th acquired token
+  virtual const void* getToken(int i) const = 0;
+
  protected:
   // methods for standard connections
 
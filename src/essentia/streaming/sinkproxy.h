@@ -227,6 +227,11 @@ class SinkProxy : public SinkProxyBase {
                             ": you need to call getFirstToken() on the Sink which is proxied by it");
   }
 
+  virtual const void* getToken(int i) const {
+    throw EssentiaException("Cannot get token for SinkProxy ", fullName(),
+                            ": you need to call getToken() on the Sink which is proxied by it");
+  }
+
 
   virtual int available() const {
     return buffer().availableForRead(_id);
@@ -62,6 +62,24 @@ class Source : public SourceBase {
     _buffer->setBufferInfo(info);
   }
 
+  virtual BufferInfo allocatedBufferInfo() const {
+    return _buffer->allocatedBufferInfo();
+  }
+
+  virtual void setAllocatedBufferInfo(const BufferInfo& info) {
+    _buffer->setAllocatedBufferInfo(info);
+  }
+
+  virtual uint64_t bufferMemory() const {
+    return _buffer->bufferMemory();
+  }
+
+  virtual void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) {
+    _buffer->setBufferMemoryBudget(budget);
+  }
+
+  virtual void setConcurrentBuffer(bool concurrent, int waitTime = 0);
+
   int totalProduced() const { return _buffer->totalTokensWritten(); }
 
   ReaderID addReader() {
@@ -79,6 +97,7 @@ class Source : public SourceBase {
 
   virtual void* getTokens() { return &tokens(); }
   virtual void* getFirstToken() { return &firstToken(); }
+  virtual void* getToken(int i) { return &tokens()[i]; }
 
   inline void acquire() { StreamConnector::acquire(); }
 
@@ -136,6 +155,7 @@ const T& lastTokenProduced(const SourceBase& source) {
 // NB: Implementation needs to go into the header as it is a template class we are defining
 
 #include "phantombuffer.h"
+#include "spmcphantombuffer.h"
 
 
 namespace essentia {
@@ -153,6 +173,35 @@ Source<TokenType>::Source(const std::string& name) :
   SourceBase(name),
   _buffer(new PhantomBuffer<TokenType>(this, BufferUsage::forSingleFrames)) {}
 
+template <typename TokenType>
+void Source<TokenType>::setConcurrentBuffer(bool concurrent, int waitTime) {
+  SPMCPhantomBuffer<TokenType>* spmc = dynamic_cast<SPMCPhantomBuffer<TokenType>*>(_buffer);
+  if (spmc) spmc->setWaitTime(waitTime);
+  if ((spmc != 0) == concurrent) return;
+
+  if (_buffer->totalTokensWritten() > 0) {
+    throw EssentiaException("Cannot change the type of the buffer of ", fullName(),
+                            " after it has produced tokens");
+  }
+
+  // the new buffer has the same sizes and readers (with the same IDs, so
+  // that the sinks connected to us keep working)
+  MultiRateBuffer<TokenType>* buffer;
+  if (concurrent) {
+    spmc = new SPMCPhantomBuffer<TokenType>(this, _buffer->bufferInfo());
+    spmc->setWaitTime(waitTime);
+    buffer = spmc;
+  }
+  else {
+    buffer = new PhantomBuffer<TokenType>(this, BufferUsage::forSingleFrames);
+    buffer->setBufferInfo(_buffer->bufferInfo());
+  }
+  for (int i=0; i<_buffer->numberReaders(); i++) buffer->addReader();
+
+  delete _buffer;
+  _buffer = buffer;
+}
+
 } // namespace streaming
 } // namespace essentia
 
@@ -20,6 +20,7 @@
 #ifndef ESSENTIA_SOURCEBASE_H
 #define ESSENTIA_SOURCEBASE_H
 
+#include <memory>
 #include "../types.h"
 #include "../connector.h"
 
@@ -31,6 +32,7 @@ class SourceProxyBase;
   //template <typename T> class SourceProxy;
 class SinkBase;
 class Algorithm;
+class BufferMemoryBudget;
 
 void connect(SourceBase& source, SinkBase& sink);
 void disconnect(SourceBase& source, SinkBase& sink);
@@ -83,6 +85,9 @@ class SourceBase : public Connector {
   // should return a TokenType*
   virtual void* getFirstToken() = 0;
 
+  // should return a TokenType*, pointing to the i-th acquired token
+  virtual void* getToken(int i) = 0;
+
   bool isProxied() const { return _sproxy != 0; }
 
   /**
@@ -113,6 +118,34 @@ class SourceBase : public Connector {
   virtual BufferInfo bufferInfo() const = 0;
   virtual void setBufferInfo(const BufferInfo& info) = 0;
 
+  /**
+   * The buffer only allocates storage for the sizes returned by
+   * allocatedBufferInfo(), and grows as needed up to those of bufferInfo().
+   * Nothing is allocated until setAllocatedBufferInfo() is called or tokens
+   * are acquired for the first time.
+   */
+  virtual BufferInfo allocatedBufferInfo() const = 0;
+  virtual void setAllocatedBufferInfo(const BufferInfo& info) = 0;
+
+  /**
+   * Memory allocated by the buffer for the storage of the tokens, in bytes.
+   * This does not include the memory the tokens themselves may own (e.g. the
+   * samples of a frame).
+   */
+  virtual uint64_t bufferMemory() const = 0;
+  virtual void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) = 0;
+
+  /**
+   * Replaces the buffer with a lock-free one (see SPMCPhantomBuffer) if
+   * @c concurrent is true, so that the algorithm producing the tokens and the
+   * ones consuming them can run on different threads, or with a regular
+   * PhantomBuffer otherwise. An acquire on the lock-free buffer waits for
+   * @c waitTime microseconds for tokens or free space before failing (a
+   * negative value meaning to wait forever). This can only be done before
+   * any token has been produced.
+   */
+  virtual void setConcurrentBuffer(bool concurrent, int waitTime = 0) = 0;
+
  protected:
   // made those protected so that only our friend streaming::{dis}connect() functions can access these
   // @todo this function should probably be protected by a mutex (?)
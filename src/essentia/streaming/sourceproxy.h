@@ -80,6 +80,26 @@ class SourceProxyBase : public SourceBase {
     _proxiedSource->setBufferInfo(info);
   }
 
+  virtual BufferInfo allocatedBufferInfo() const {
+    return _proxiedSource->allocatedBufferInfo();
+  }
+
+  virtual void setAllocatedBufferInfo(const BufferInfo& info) {
+    _proxiedSource->setAllocatedBufferInfo(info);
+  }
+
+  virtual uint64_t bufferMemory() const {
+    return _proxiedSource->bufferMemory();
+  }
+
+  virtual void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) {
+    _proxiedSource->setBufferMemoryBudget(budget);
+  }
+
+  virtual void setConcurrentBuffer(bool concurrent, int waitTime = 0) {
+    _proxiedSource->setConcurrentBuffer(concurrent, waitTime);
+  }
+
 
   //---- StreamConnector interface hijacking for proxies ----------------------------------------//
 
@@ -220,6 +240,11 @@ class SourceProxy : public SourceProxyBase {
                             ": you need to call getFirstToken() on the Source which is proxied by it");
   }
 
+  virtual void* getToken(int i) {
+    throw EssentiaException("Cannot get token for SourceProxy ", fullName(),
+                            ": you need to call getToken() on the Source which is proxied by it");
+  }
+
 
   virtual int available() const {
     return typedBuffer().availableForWrite(false);
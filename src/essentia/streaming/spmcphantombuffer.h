@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SPMCPHANTOMBUFFER_H
+#define ESSENTIA_SPMCPHANTOMBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "multiratebuffer.h"
+#include "../roguevector.h"
+#include "../essentiautil.h"
+
+
+namespace essentia {
+namespace streaming {
+
+/**
+ * The SPMCPhantomBuffer class is a lock-free implementation of the
+ * MultiRateBuffer interface, for a writer and readers which run on different
+ * threads (single producer, multiple consumers).
+ *
+ * It has the same layout as the PhantomBuffer: a phantom zone at the end of
+ * the buffer replicates its beginning, so that any number of tokens up to the
+ * phantom size + 1 can be acquired on a contiguous zone in memory. Instead of
+ * windows protected by a mutex, the writer and each reader publish the total
+ * number of tokens they have released in an atomic counter of their own. A
+ * writer only waits for the slowest reader, and readers never wait for each
+ * other.
+ *
+ * The writer (acquireForWrite, releaseForWrite, writeView) may run on one
+ * thread, and each reader (acquireForRead, releaseForRead, readView with its
+ * ID) on another one. Configuring the buffer (setBufferInfo, addReader,
+ * removeReader, reset) must not happen while it is in use.
+ *
+ * When there are not enough tokens (for a reader) or not enough free space
+ * (for the writer), an acquire waits for them for the time given by
+ * setWaitTime(), first spinning, then yielding and sleeping for increasing
+ * durations, before returning false. The default is not to wait, as the
+ * PhantomBuffer does, which is what the scheduler of a network expects.
+ *
+ * As it cannot grow while being used, the storage for its maximum sizes is
+ * always allocated.
+ */
+template <typename T>
+class SPMCPhantomBuffer : public MultiRateBuffer<T> {
+
+ public:
+
+  SPMCPhantomBuffer(SourceBase* parent, BufferUsage::BufferUsageType type);
+  SPMCPhantomBuffer(SourceBase* parent, const BufferInfo& info);
+  ~SPMCPhantomBuffer();
+
+  void setBufferType(BufferUsage::BufferUsageType type);
+
+  BufferInfo bufferInfo() const { return BufferInfo(_bufferSize, _phantomSize); }
+  void setBufferInfo(const BufferInfo& info);
+
+  BufferInfo allocatedBufferInfo() const { return bufferInfo(); }
+  void setAllocatedBufferInfo(const BufferInfo&) {}
+
+  uint64_t bufferMemory() const {
+    return (uint64_t)(_bufferSize + _phantomSize) * sizeof(T);
+  }
+
+  void setBufferMemoryBudget(const std::shared_ptr<BufferMemoryBudget>& budget) {
+    if (_budget) _budget->free(bufferMemory());
+    _budget = budget;
+    if (_budget) _budget->forceAllocate(bufferMemory());
+  }
+
+  /**
+   * Sets the time, in microseconds, that an acquire waits for tokens or free
+   * space before giving up. 0 means not to wait, a negative value to wait
+   * until they are available.
+   */
+  void setWaitTime(int microseconds) { _waitTime = microseconds; }
+  int waitTime() const { return _waitTime; }
+
+  const ::essentia::VectorEx<T>& readView(ReaderID id) const { return _readers[id]->view; }
+  ::essentia::VectorEx<T>& writeView() { return _writeView; }
+
+  bool acquireForRead(ReaderID id, int requested);
+  bool acquireForWrite(int requested);
+
+  void releaseForWrite(int released);
+  void releaseForRead(ReaderID id, int released);
+
+  ReaderID addReader(bool startFromZero = false);
+  void removeReader(ReaderID id);
+
+  int numberReaders() const { return _readers.size(); }
+
+  int availableForRead(ReaderID id) const;
+  int availableForWrite(bool contiguous=true) const;
+
+  int totalTokensWritten() const {
+    return (int)_written.value.load(std::memory_order_acquire);
+  }
+
+  int totalTokensRead(ReaderID id) const {
+    return (int)_readers[id]->read.load(std::memory_order_acquire);
+  }
+
+  const T& lastTokenProduced() const;
+
+  void resize(int size, int phantomSize) {
+    setBufferInfo(BufferInfo(size, phantomSize));
+  }
+
+  void reset();
+
+ protected:
+  // a counter on its own cache line, so that the writer and the readers do
+  // not slow each other down when they update theirs
+  struct Counter {
+    std::atomic<int64_t> value;
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+    Counter() : value(0) {}
+  };
+
+  struct Reader {
+    std::atomic<int64_t> read; // published by the reader
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+    int acquired;
+    RogueVector<T> view;
+    Reader(int64_t total) : read(total), acquired(0) {}
+  };
+
+  SourceBase* _parent;
+
+  int _bufferSize, _phantomSize; // bufferSize does not include phantomSize
+  std::shared_ptr<BufferMemoryBudget> _budget;
+  ::essentia::VectorEx<T> _buffer;
+
+  Counter _written;   // published by the writer
+  int64_t _writeTotal; // only accessed by the writer, same as _written
+  int _writeAcquired;
+  RogueVector<T> _writeView;
+
+  std::vector<std::unique_ptr<Reader> > _readers;
+
+  int _waitTime;
+
+  int availableForRead(const Reader& reader) const;
+  int64_t oldestRead() const;
+
+  // calls ready() with a backoff until it returns true or the wait time has
+  // elapsed, returns its last result
+  template <typename Predicate>
+  bool waitFor(Predicate ready) const;
+
+  void checkRequested(int requested, const char* method) const;
+};
+
+} // namespace streaming
+} // namespace essentia
+
+#include "spmcphantombuffer_impl.h"
+
+#endif // ESSENTIA_SPMCPHANTOMBUFFER_H
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SPMCPHANTOMBUFFER_IMPL_H
+#define ESSENTIA_SPMCPHANTOMBUFFER_IMPL_H
+
+#include <chrono>
+#include <thread>
+#include "streamingalgorithm.h"
+
+namespace essentia {
+namespace streaming {
+
+template <typename T>
+SPMCPhantomBuffer<T>::SPMCPhantomBuffer(SourceBase* parent, BufferUsage::BufferUsageType type) :
+  _parent(parent), _bufferSize(0), _phantomSize(0),
+  _writeTotal(0), _writeAcquired(0), _waitTime(0) {
+  setBufferType(type);
+}
+
+template <typename T>
+SPMCPhantomBuffer<T>::SPMCPhantomBuffer(SourceBase* parent, const BufferInfo& info) :
+  _parent(parent), _bufferSize(0), _phantomSize(0),
+  _writeTotal(0), _writeAcquired(0), _waitTime(0) {
+  setBufferInfo(info);
+}
+
+template <typename T>
+SPMCPhantomBuffer<T>::~SPMCPhantomBuffer() {
+  if (_budget) _budget->free(bufferMemory());
+}
+
+template <typename T>
+void SPMCPhantomBuffer<T>::setBufferType(BufferUsage::BufferUsageType type) {
+  setBufferInfo(bufferInfoForUsage(type));
+}
+
+/**
+ * Changes the size of the storage, keeping the tokens that have not been read
+ * by all readers yet (and the last token produced) at the same position
+ * modulo the new size, so that the totals of tokens read and written stay the
+ * same.
+ */
+template <typename T>
+void SPMCPhantomBuffer<T>::setBufferInfo(const BufferInfo& info) {
+  int size = info.size;
+  int phantomSize = info.maxContiguousElements;
+  if (size == _bufferSize && phantomSize == _phantomSize && !_buffer.empty()) return;
+
+  int64_t written = _writeTotal;
+  int64_t oldest = oldestRead();
+  if (written > 0) oldest = (std::min)(oldest, written - 1);
+
+  if (size <= phantomSize || size < written - oldest) {
+    std::ostringstream msg;
+    msg << "SPMCPhantomBuffer: cannot resize the buffer of " << _parent->fullName()
+        << " to " << size << " tokens with a phantom zone of " << phantomSize << " tokens";
+    throw EssentiaException(msg);
+  }
+
+  int64_t delta = ((int64_t)(size + phantomSize) - (_bufferSize + _phantomSize)) * (int64_t)sizeof(T);
+  if (_budget) {
+    if (delta > 0) _budget->forceAllocate(delta);
+    else _budget->free(-delta);
+  }
+
+  ::essentia::VectorEx<T> buffer(size + phantomSize);
+  for (int64_t t=oldest; t<written; t++) {
+    std::swap(buffer[t % size], _buffer[t % _bufferSize]);
+  }
+  T* first = &buffer[0];
+  fastcopy(first + size, first, phantomSize);
+  _buffer.swap(buffer);
+
+  _bufferSize = size;
+  _phantomSize = phantomSize;
+
+  _writeAcquired = 0;
+  _writeView.setData(&_buffer[0] + _writeTotal % _bufferSize);
+  _writeView.setSize(0);
+
+  for (int i=0; i<(int)_readers.size(); i++) {
+    Reader& reader = *_readers[i];
+    reader.acquired = 0;
+    reader.view.setData(&_buffer[0] + reader.read.load() % _bufferSize);
+    reader.view.setSize(0);
+  }
+}
+
+
+template <typename T>
+ReaderID SPMCPhantomBuffer<T>::addReader(bool startFromZero) {
+  Reader* reader = new Reader(startFromZero ? 0 : _writeTotal);
+  reader->view.setData(&_buffer[0] + reader->read.load() % _bufferSize);
+  _readers.push_back(std::unique_ptr<Reader>(reader));
+  return _readers.size() - 1;
+}
+
+template <typename T>
+void SPMCPhantomBuffer<T>::removeReader(ReaderID id) {
+  _readers.erase(_readers.begin() + id);
+}
+
+
+template <typename T>
+void SPMCPhantomBuffer<T>::checkRequested(int requested, const char* method) const {
+  // as for the PhantomBuffer, phantomSize + 1 tokens starting anywhere in the
+  // main zone always fit before the end of the phantom zone
+  if (requested > _phantomSize + 1) {
+    std::ostringstream msg;
+    msg << method << ": Requested number of tokens (" << requested << ") > phantom size ("
+        << _phantomSize << ") in " << _parent->fullName();
+    throw EssentiaException(msg);
+  }
+}
+
+template <typename T>
+template <typename Predicate>
+bool SPMCPhantomBuffer<T>::waitFor(Predicate ready) const {
+  if (ready()) return true;
+  if (_waitTime == 0) return false;
+
+  // spin first, as the other side is usually about to release tokens, then
+  // give the CPU away for increasingly long periods
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  int sleepTime = 1;
+  for (int i=0; ; i++) {
+    if (i >= 128) {
+      std::this_thread::sleep_for(std::chrono::microseconds(sleepTime));
+      sleepTime = (std::min)(2*sleepTime, 1000);
+    }
+    else if (i >= 64) {
+      std::this_thread::yield();
+    }
+
+    if (ready()) return true;
+
+    if (_waitTime > 0 &&
+        std::chrono::steady_clock::now() - start >= std::chrono::microseconds(_waitTime)) {
+      return false;
+    }
+  }
+}
+
+
+template <typename T>
+bool SPMCPhantomBuffer<T>::acquireForRead(ReaderID id, int requested) {
+  checkRequested(requested, "acquireForRead");
+
+  Reader& reader = *_readers[id];
+  if (!waitFor([&]() { return availableForRead(reader) >= requested; })) return false;
+
+  reader.acquired = requested;
+  reader.view.setData(&_buffer[0] + reader.read.load(std::memory_order_relaxed) % _bufferSize);
+  reader.view.setSize(requested);
+
+  return true;
+}
+
+template <typename T>
+void SPMCPhantomBuffer<T>::releaseForRead(ReaderID id, int released) {
+  Reader& reader = *_readers[id];
+
+  if (released > reader.acquired) {
+    std::ostringstream msg;
+    msg << _parent->fullName() << ": releasing too many tokens (read access): "
+        << released << " instead of " << reader.acquired << " max allowed";
+    throw EssentiaException(msg);
+  }
+
+  // the tokens read are only handed back to the writer once we are done with
+  // them, hence the release order
+  int64_t read = reader.read.load(std::memory_order_relaxed) + released;
+  reader.read.store(read, std::memory_order_release);
+
+  reader.acquired -= released;
+  reader.view.setData(&_buffer[0] + read % _bufferSize);
+  reader.view.setSize(reader.acquired);
+}
+
+template <typename T>
+bool SPMCPhantomBuffer<T>::acquireForWrite(int requested) {
+  checkRequested(requested, "acquireForWrite");
+
+  if (!waitFor([&]() { return availableForWrite() >= requested; })) return false;
+
+  _writeAcquired = requested;
+  _writeView.setData(&_buffer[0] + _writeTotal % _bufferSize);
+  _writeView.setSize(requested);
+
+  return true;
+}
+
+template <typename T>
+void SPMCPhantomBuffer<T>::releaseForWrite(int released) {
+  if (released > _writeAcquired) {
+    std::ostringstream msg;
+    msg << _parent->fullName() << ": releasing too many tokens (write access): "
+        << released << " instead of " << _writeAcquired << " max allowed";
+    throw EssentiaException(msg);
+  }
+
+  int begin = _writeTotal % _bufferSize;
+  int end = begin + released;
+
+  // replicate from the beginning to the phantom zone if necessary
+  if (begin < _phantomSize) {
+    T* first = &_buffer[begin];
+    fastcopy(first + _bufferSize, first, (std::min)(end, _phantomSize) - begin);
+  }
+  // replicate from the phantom zone to the beginning if necessary
+  if (end > _bufferSize) {
+    int beginIdx = (std::max)(begin, _bufferSize);
+    T* first = &_buffer[beginIdx];
+    fastcopy(first - _bufferSize, first, end - beginIdx);
+  }
+
+  // the tokens (and their replicas) are written before being made visible to
+  // the readers
+  _writeTotal += released;
+  _written.value.store(_writeTotal, std::memory_order_release);
+
+  _writeAcquired -= released;
+  _writeView.setData(&_buffer[0] + _writeTotal % _bufferSize);
+  _writeView.setSize(_writeAcquired);
+}
+
+
+template <typename T>
+int64_t SPMCPhantomBuffer<T>::oldestRead() const {
+  int64_t oldest = _written.value.load(std::memory_order_acquire);
+  for (int i=0; i<(int)_readers.size(); i++) {
+    oldest = (std::min)(oldest, _readers[i]->read.load(std::memory_order_acquire));
+  }
+  return oldest;
+}
+
+template <typename T>
+int SPMCPhantomBuffer<T>::availableForRead(const Reader& reader) const {
+  int64_t read = reader.read.load(std::memory_order_acquire);
+  int64_t theoretical = _written.value.load(std::memory_order_acquire) - read;
+  int contiguous = _bufferSize + _phantomSize - read % _bufferSize;
+  return (int)(std::min)(theoretical, (int64_t)contiguous);
+}
+
+template <typename T>
+int SPMCPhantomBuffer<T>::availableForRead(ReaderID id) const {
+  return availableForRead(*_readers[id]);
+}
+
+template <typename T>
+int SPMCPhantomBuffer<T>::availableForWrite(bool contiguous) const {
+  int64_t written = _written.value.load(std::memory_order_acquire);
+  int theoretical = (int)(oldestRead() + _bufferSize - written);
+  if (!contiguous) return theoretical;
+
+  int ncontiguous = _bufferSize + _phantomSize - written % _bufferSize;
+  return (std::min)(theoretical, ncontiguous);
+}
+
+
+template <typename T>
+const T& SPMCPhantomBuffer<T>::lastTokenProduced() const {
+  int64_t written = _written.value.load(std::memory_order_acquire);
+  if (written == 0) {
+    throw EssentiaException("Tried to call ::lastTokenProduced() on ", _parent->fullName(),
+                            " which hasn't produced any token yet");
+  }
+  return _buffer[(written - 1) % _bufferSize];
+}
+
+template <typename T>
+void SPMCPhantomBuffer<T>::reset() {
+  _writeTotal = 0;
+  _writeAcquired = 0;
+  _written.value.store(0);
+  _writeView.setData(&_buffer[0]);
+  _writeView.setSize(0);
+
+  for (int i=0; i<(int)_readers.size(); i++) {
+    Reader& reader = *_readers[i];
+    reader.read.store(0);
+    reader.acquired = 0;
+    reader.view.setData(&_buffer[0]);
+    reader.view.setSize(0);
+  }
+}
+
+} // namespace streaming
+} // namespace essentia
+
+#endif // ESSENTIA_SPMCPHANTOMBUFFER_IMPL_H
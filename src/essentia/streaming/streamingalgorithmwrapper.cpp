@@ -49,6 +49,60 @@ void StreamingAlgorithmWrapper::declareAlgorithm(const std::string& name) {
   _name = name;
 }
 
+void StreamingAlgorithmWrapper::setBatchSize(int n) {
+  if (n < 1) {
+    throw EssentiaException("StreamingAlgorithmWrapper::setBatchSize: the batch size must be at least 1 (", name(), ")");
+  }
+  if (n > 1) {
+    bool tokens = !_inputs.empty();
+    for (NumeralTypeMap::const_iterator it = _inputType.begin(); it != _inputType.end(); ++it) {
+      if (it->second != TOKEN) tokens = false;
+    }
+    for (NumeralTypeMap::const_iterator it = _outputType.begin(); it != _outputType.end(); ++it) {
+      if (it->second != TOKEN) tokens = false;
+    }
+    if (!tokens) {
+      throw EssentiaException("StreamingAlgorithmWrapper::setBatchSize: only algorithms with TOKEN inputs and outputs can process several tokens at once (", name(), ")");
+    }
+  }
+
+  _batchSize = n;
+
+  // the network resizes the buffers according to the acquire sizes
+  setConnectorsSize(n);
+
+  _batchInputs.clear();
+  for (InputMap::const_iterator input = _inputs.begin(); input!=_inputs.end(); ++input) {
+    _batchInputs.push_back(make_pair(&_algorithm->input(input->first), input->second));
+  }
+
+  _batchOutputs.clear();
+  for (OutputMap::const_iterator output = _outputs.begin(); output!=_outputs.end(); ++output) {
+    _batchOutputs.push_back(make_pair(&_algorithm->output(output->first), output->second));
+
+    // make room for a whole batch in our own buffers now, rather than having
+    // the network complain about their size and resize them
+    BufferInfo buf = output->second->bufferInfo();
+    if (buf.maxContiguousElements + 1 < n) {
+      buf.maxContiguousElements = n;
+      buf.size = 8 * n;
+      output->second->setBufferInfo(buf);
+    }
+  }
+}
+
+void StreamingAlgorithmWrapper::setConnectorsSize(int n) {
+  for (InputMap::const_iterator input = _inputs.begin(); input!=_inputs.end(); ++input) {
+    input->second->setAcquireSize(n);
+    input->second->setReleaseSize(n);
+  }
+
+  for (OutputMap::const_iterator output = _outputs.begin(); output!=_outputs.end(); ++output) {
+    output->second->setAcquireSize(n);
+    output->second->setReleaseSize(n);
+  }
+}
+
 void StreamingAlgorithmWrapper::declareInput(SinkBase& sink, NumeralType type, const std::string& name) {
   declareInput(sink, type, 1, name);
 }
@@ -151,6 +205,8 @@ void StreamingAlgorithmWrapper::synchronizeOutput(const std::string& name) {
  */
 AlgorithmStatus StreamingAlgorithmWrapper::process() {
 
+  if (_batchSize > 1) return processBatch();
+
   EXEC_DEBUG("acquiring data");
   AlgorithmStatus status = acquireData();
   EXEC_DEBUG("done acquiring data locks");
@@ -247,5 +303,50 @@ AlgorithmStatus StreamingAlgorithmWrapper::process() {
 }
 
 
+AlgorithmStatus StreamingAlgorithmWrapper::processBatch() {
+  // only process full batches, except at the end of the stream where we take
+  // whatever is left
+  int n = _batchSize;
+  if (shouldStop()) {
+    for (InputMap::const_iterator it = inputs().begin(); it != inputs().end(); ++it) {
+      n = min(n, it->second->available());
+    }
+    if (n == 0) return NO_INPUT;
+    if (n < _batchSize) setConnectorsSize(n);
+  }
+
+  EXEC_DEBUG("acquiring " << n << " tokens");
+  AlgorithmStatus status = acquireData();
+
+  if (status == OK) {
+    // bind to the first tokens, this also checks the types once per batch
+    synchronizeIO();
+
+    EXEC_DEBUG("computing");
+    if (_algorithm->supportsBatch()) {
+      _algorithm->computeBatch(n);
+    }
+    else {
+      for (int i=0; i<n; i++) {
+        for (int j=0; j<(int)_batchInputs.size(); j++) {
+          _batchInputs[j].first->setSinkToken(*_batchInputs[j].second, i);
+        }
+        for (int j=0; j<(int)_batchOutputs.size(); j++) {
+          _batchOutputs[j].first->setSourceToken(*_batchOutputs[j].second, i);
+        }
+        _algorithm->compute();
+      }
+    }
+    EXEC_DEBUG("done computing, releasing data");
+
+    releaseData();
+  }
+
+  if (n < _batchSize) setConnectorsSize(_batchSize);
+
+  return status;
+}
+
+
 } // namespace streaming
 } // namespace essentia
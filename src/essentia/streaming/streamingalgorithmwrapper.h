@@ -21,7 +21,7 @@
 #define ESSENTIA_STREAMINGALGORITHMWRAPPER_H
 
 #include "streamingalgorithm.h"
-#include "algorithm.h"
+#include "../algorithm.h"
 
 namespace essentia {
 namespace streaming {
@@ -41,9 +41,18 @@ class StreamingAlgorithmWrapper : public Algorithm {
   standard::Algorithm* _algorithm;
   int _streamSize;
 
+  // batch mode: the inputs and outputs of the wrapped algorithm paired with
+  // ours, so that they can be bound to each token of a batch in turn
+  int _batchSize;
+  ::essentia::VectorEx<std::pair<standard::InputBase*, SinkBase*> > _batchInputs;
+  ::essentia::VectorEx<std::pair<standard::OutputBase*, SourceBase*> > _batchOutputs;
+
+  void setConnectorsSize(int n);
+  AlgorithmStatus processBatch();
+
  public:
 
-  StreamingAlgorithmWrapper() : _algorithm(0) {}
+  StreamingAlgorithmWrapper() : _algorithm(0), _batchSize(1) {}
   ~StreamingAlgorithmWrapper();
 
   void declareInput(SinkBase& sink, NumeralType type, const std::string& name);
@@ -62,6 +71,19 @@ class StreamingAlgorithmWrapper : public Algorithm {
 
   void declareAlgorithm(const std::string& name);
 
+  /**
+   * Makes the wrapper acquire and process up to n tokens per call to
+   * process() instead of a single one, which amortizes the cost of the
+   * scheduling and of the acquire/release bookkeeping over n frames. The
+   * wrapped algorithm computes them all at once if it supportsBatch(), or one
+   * by one otherwise.
+   * This only applies to algorithms with TOKEN inputs and outputs, and has to
+   * be set before the network is initialized, as its buffers are sized so
+   * that they can hold a whole batch contiguously.
+   */
+  void setBatchSize(int n);
+  int batchSize() const { return _batchSize; }
+
   void configure(const ParameterMap& params) {
     _algorithm->configure(params);
     this->setParameters(params);
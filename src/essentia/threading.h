@@ -20,6 +20,12 @@
 #ifndef ESSENTIA_THREADING_H
 #define ESSENTIA_THREADING_H
 
+#include "config.h"
+
+#if THREAD_SAFE_MUTEX
+#   include <atomic>
+#   include <thread>
+#endif // THREAD_SAFE_MUTEX
 
 #ifdef OS_WIN32
 #   include <windows.h>
@@ -42,6 +48,55 @@ typedef tbb::spin_mutex::scoped_lock ForcedMutexLocker;
 // to call the algorithms in a multithreaded way.
 // If not, it can be replaced with a no-op mutex for performance reasons.
 
+#if THREAD_SAFE_MUTEX
+
+// The critical sections protected by this mutex (Pool accesses, buffer window
+// updates) are very short, so a spin lock is cheaper than a kernel mutex here.
+// We only spin on a plain load so that waiting threads don't keep stealing the
+// cache line from the owner, and yield to let it finish if it has been preempted.
+
+class Mutex {
+ protected:
+  std::atomic<bool> _locked;
+ public:
+  Mutex() : _locked(false) {}
+  // a copy of a mutex is a new, unlocked mutex, so that objects containing
+  // one (such as the Pool) can still be copied
+  Mutex(const Mutex&) : _locked(false) {}
+  Mutex& operator=(const Mutex&) { return *this; }
+
+  void lock() {
+    while (_locked.exchange(true, std::memory_order_acquire)) {
+      while (_locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+    }
+  }
+
+  void unlock() { _locked.store(false, std::memory_order_release); }
+};
+
+class MutexLocker {
+ protected:
+  Mutex* _mutex;
+ public:
+  MutexLocker(Mutex& mutex) : _mutex(&mutex) { _mutex->lock(); }
+  ~MutexLocker() { release(); }
+
+  void release() {
+    if (_mutex) {
+      _mutex->unlock();
+      _mutex = 0;
+    }
+  }
+
+  void acquire(Mutex& mutex) {
+    release();
+    _mutex = &mutex;
+    _mutex->lock();
+  }
+};
+
+#else // THREAD_SAFE_MUTEX
+
 class Mutex {
  public:
   void lock() {}
@@ -55,6 +110,8 @@ class MutexLocker {
   void acquire(Mutex&) {}
 };
 
+#endif // THREAD_SAFE_MUTEX
+
 
 // the ForcedMutex is a real Mutex, that should always lock properly
 // (ex: in FFTW, the plan creation/destruction needs to be protected no matter what)
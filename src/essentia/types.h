@@ -24,12 +24,19 @@
 
 #include <map>
 #include <vector>
+#include <complex>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
 #include <cctype>
 #include <cassert>
 #include <sstream>
 #include <typeinfo>
 #include <string.h>
 #include "config.h"
+#ifdef OS_WIN32
+#include <malloc.h> // _aligned_malloc
+#endif
 #include <unsupported/Eigen/CXX11/Tensor>
 
 
@@ -84,294 +91,229 @@ public:
   void swap(array_view<T>& t) { std::swap(ptr_, t.ptr_); std::swap(len_, t.len_); }
 };
 
-template <typename T, typename VEC_T>
-class VectorExT {
-public:
-  template <class VEC_ITERATOR>
-  struct Iterator {   
-    typedef T value_type;
-    typedef value_type& reference;
-		typedef value_type* pointer;
-		typedef std::bidirectional_iterator_tag iterator_category;
-		typedef std::ptrdiff_t difference_type;
-
-    VEC_ITERATOR itr;
-    T* view_pos = nullptr;
-
-    Iterator() = default;
-    Iterator(const Iterator& t) {
-      itr = t.itr;
-      view_pos = t.view_pos;
-    }
+/**
+ * Alignment (in bytes) of the data owned by the vectors of floating-point or
+ * complex values. This is enough for the widest SIMD registers and is a cache
+ * line, so that these vectors can be handed directly to FFTW (whose plans
+ * require the arrays to be aligned like the ones they were planned on) or to
+ * the SIMD kernels without having to be copied first.
+ */
+#define ESSENTIA_VECTOR_ALIGNMENT 64
 
-    template <class Y>
-    Iterator(const Y& t) {
-      itr = t.itr;
-      view_pos = t.view_pos;
-    }
+/**
+ * If set, called by the AlignedAllocator with the size in bytes of each of its
+ * allocations, so that they can be counted along with those made with
+ * operator new (see utils/allocationcounter.h).
+ */
+extern ESSENTIA_API void (*alignedAllocationHook)(size_t bytes);
 
-		reference operator *() {
-			return view_pos ? *view_pos : (reference)*itr;
-		}
-
-		value_type& operator *() const {
-			return view_pos ? *view_pos : (value_type&)*itr;
-		}
-
-		pointer operator ->() {
-      return view_pos ? view_pos : (pointer)&(*itr);
-		}
-
-		value_type *operator ->() const {
-      return view_pos ? view_pos : (value_type *)&(*itr);
-		}
-
-		Iterator operator ++() {
-      if (view_pos)
-        ++view_pos;
-      else
-        ++itr;
-			return *this;
-		}
-  
-    Iterator operator ++(int) {
-      Iterator old = *this;
-      if (view_pos)
-        ++view_pos;
-      else
-        ++itr;
-			return old;
-		}
-    
-		Iterator operator --() {
-      if (view_pos)
-        --view_pos;
-      else
-        --itr;
-			return *this;
-		}
-
-		bool operator ==(const Iterator &rhs) const {
-			return (view_pos == rhs.view_pos && itr == rhs.itr);
-		}
-
-		bool operator !=(const Iterator &rhs) const {
-			return !(view_pos == rhs.view_pos && itr == rhs.itr);
-		}
-
-    difference_type operator-(const Iterator& rhs) const {
-      if (view_pos)
-        return view_pos - rhs.view_pos;
-      return itr - rhs.itr;
-    }
+/**
+ * Stateless allocator returning memory aligned on Alignment bytes.
+ */
+template <typename T, size_t Alignment = ESSENTIA_VECTOR_ALIGNMENT>
+struct AlignedAllocator {
+  typedef T value_type;
 
-    Iterator operator + (int d) const {
-      Iterator newitr;
-      if (view_pos)
-        newitr.view_pos = view_pos + d;
-      else
-        newitr.itr = itr + d;
-      return newitr;
-    }
+  template <typename U>
+  struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+  AlignedAllocator() noexcept {}
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n == 0) return nullptr;
+    if (alignedAllocationHook) alignedAllocationHook(n*sizeof(T));
+    void* p = nullptr;
+#ifdef OS_WIN32
+    p = _aligned_malloc(n*sizeof(T), Alignment);
+#else
+    if (posix_memalign(&p, Alignment, n*sizeof(T)) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return (T*)p;
+  }
 
-    Iterator operator - (int d) const {
-      Iterator newitr;
-      if (view_pos)
-        newitr.view_pos = view_pos - d;
-      else
-        newitr.itr = itr - d;
-      return newitr;
-    }
+  void deallocate(T* p, size_t) noexcept {
+#ifdef OS_WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+  }
+};
 
-    bool operator < (const Iterator& rhs) const {
-      return view_pos ? view_pos < rhs.view_pos : itr < rhs.itr;
-    }
-  };
+template <typename T, typename U, size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return true; }
+template <typename T, typename U, size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return false; }
+
+/**
+ * Allocation policy of the storage of VectorEx: aligned for the types which
+ * are processed numerically (Real, double and their complex counterparts),
+ * the default allocator for all the others.
+ */
+template <typename T>
+struct VectorExAllocator { typedef std::allocator<T> type; };
+template <>
+struct VectorExAllocator<float> { typedef AlignedAllocator<float> type; };
+template <>
+struct VectorExAllocator<double> { typedef AlignedAllocator<double> type; };
+template <>
+struct VectorExAllocator<std::complex<float> > { typedef AlignedAllocator<std::complex<float> > type; };
+template <>
+struct VectorExAllocator<std::complex<double> > { typedef AlignedAllocator<std::complex<double> > type; };
 
-  typedef Iterator<typename ::std::vector<T>::iterator> iterator;
-  typedef Iterator<typename ::std::vector<T>::const_iterator> const_iterator;
+/**
+ * VectorExT is a vector which either owns its data, in which case it is stored
+ * in an std::vector, or is a view on some external data (see
+ * setReferenceData()), which is how RogueVector avoids copies.
+ *
+ * In both cases, view_ points to the current data, so that element access,
+ * size() and iterators (which are plain pointers) don't need to check which
+ * of the two is used and can be vectorized. The methods modifying an owned
+ * vector have to call syncView() after touching vec_, and the ones resizing
+ * a view turn it into an owned vector first.
+ *
+ * The owned data is allocated following VectorExAllocator.
+ */
+template <typename T, typename VEC_T>
+class VectorExT {
+public:
+  typedef T* iterator;
+  typedef const T* const_iterator;
   typedef size_t size_type;
   typedef T value_type;
+  typedef ::std::vector<VEC_T, typename VectorExAllocator<VEC_T>::type> storage_type;
 
   VectorExT() {}
-  VectorExT(size_t size) : vec_(size) {}
-  VectorExT(std::initializer_list<T> _Ilist) : vec_(_Ilist) {}
+  VectorExT(size_t size) : vec_(size) { syncView(); }
+  VectorExT(std::initializer_list<T> _Ilist) : vec_(_Ilist.begin(), _Ilist.end()) { syncView(); }
   template <class X, class Y>
-  VectorExT(const X& first, const Y& last) : vec_(first, last) {}
-  VectorExT(const VectorExT& t) : vec_(t.vec_) {}
+  VectorExT(const X& first, const Y& last) : vec_(first, last) { syncView(); }
+
+  // copying a view gives another view on the same data
+  VectorExT(const VectorExT& t) {
+    copyFrom(t);
+  }
 
+  VectorExT(VectorExT&& t) noexcept {
+    moveFrom(t);
+  }
+
+  VectorExT& operator=(const VectorExT& t) {
+    if (this != &t) copyFrom(t);
+    return *this;
+  }
+
+  VectorExT& operator=(VectorExT&& t) noexcept {
+    if (this != &t) moveFrom(t);
+    return *this;
+  }
 
   void setReferenceData(T* data, size_t size) {
+    // release the storage, so that vec_.data() can't be mistaken for a view
+    storage_type().swap(vec_);
     view_ = array_view<T>(data, size);
-    vec_.clear();
   }
 
   void push_back(const T& v) {
     make_vector().push_back(v);
+    syncView();
   }
 
   void pop_back() {
-    if (view_.size())
+    if (isView())
       view_ = array_view<T>(view_.data(), view_.size() - 1);
-    else
+    else {
       vec_.pop_back();
+      syncView();
+    }
   }
 
-  T* data() {
-    return (view_.size()) ? view_.data() : (T*)vec_.data();
-  }
+  T* data() { return view_.data(); }
+  const T* data() const { return view_.data(); }
 
-  const T* data() const {
-    return (view_.size()) ? view_.data() : (const T*)vec_.data();
-  }
+  size_t size() const { return view_.size(); }
 
-  size_t size() const {
-    return (view_.size()) ? view_.size() : vec_.size();
-  }
+  T& operator[](size_t i) { return view_[i]; }
+  const T& operator[](size_t i) const { return view_[i]; }
 
-  T& operator[](size_t i) {
-    return (view_.size()) ? view_[i] : (T&)vec_[i];
-  }
-
-  const T& operator[](size_t i) const {
-    return (view_.size()) ? view_[i] : (const T&)vec_[i];
-  }
-
-  T& at(size_t i) {
-    return (view_.size()) ? view_[i] : (T&)vec_[i];
-  }
-
-  const T& at(size_t i) const {
-    return (view_.size()) ? view_[i] : (const T&)vec_[i];
-  }
+  T& at(size_t i) { return view_[i]; }
+  const T& at(size_t i) const { return view_[i]; }
 
   void resize(size_t new_size) {
-    if (new_size <= view_.size()) {
+    if (isView() && new_size <= view_.size()) {
       view_ = array_view<T>(view_.data(), new_size);
     } else {
       make_vector().resize(new_size);
+      syncView();
     }
   }
   
   void resize (size_type n, const value_type& val) {
     clear();
     vec_.resize(n, val);
+    syncView();
   }
 
   bool empty() const {
-    return view_.size() == 0 && vec_.empty();
+    return view_.size() == 0;
   }
 
   void clear() {
-    view_.clear();
     vec_.clear();
+    syncView();
   }
 
-  iterator begin() {
-    iterator it;
-    it.view_pos = view_.begin();
-    it.itr = vec_.begin();
-    return it;
-  }
-
-  iterator end() {
-    iterator it;
-    it.view_pos = view_.size() ? view_.end() : nullptr;
-    it.itr = vec_.end();
-    return it;
-  }
-
-  const_iterator begin() const {
-    const_iterator it;
-    it.view_pos = view_.size() ? view_.begin() : nullptr;
-    it.itr = vec_.begin();
-    return it;
-  }
+  iterator begin() { return view_.begin(); }
+  iterator end() { return view_.end(); }
+  const_iterator begin() const { return view_.begin(); }
+  const_iterator end() const { return view_.end(); }
 
-  const_iterator end() const {
-    const_iterator it;
-    it.view_pos = view_.size() ? view_.end() : nullptr;
-    it.itr = vec_.end();
-    return it;
-  }
+  T& front() { return view_[0]; }
+  const T& front() const { return view_[0]; }
 
-  T& front() {
-    return *begin();
-  }
-  
-  const T& front() const {
-    return *begin();
-  }
-
-  T& back() {
-    return (view_.size()) ? *(view_.begin() + view_.size() - 1) : (const T&)vec_.back();
-  }
-  
-  const T& back() const {
-    return (view_.size()) ? *(view_.begin() + view_.size() - 1) : (const T&)vec_.back();
-  }
+  T& back() { return view_[view_.size() - 1]; }
+  const T& back() const { return view_[view_.size() - 1]; }
 
   iterator erase(iterator it) {
-    if (view_.size()) {
-      assert(it.view_pos);
-      vec_.reserve(view_.size() - 1);
-      vec_.assign(view_.begin(), it.view_pos);
-      if (it.view_pos != view_.end())
-          vec_.insert(vec_.end(), it.view_pos + 1, view_.end());
-      it.itr = vec_.begin() + (it.view_pos - view_.begin());
-      it.view_pos = nullptr;
-      view_.clear();
-    } else {
-      assert(!it.view_pos);
-      it.itr = vec_.erase(it.itr);
-    }
-    return it;
+    size_t pos = it - begin();
+    make_vector().erase(vec_.begin() + pos);
+    syncView();
+    return begin() + pos;
   }
 
   iterator erase(iterator first, iterator last) {
-    iterator it;
-    if (view_.size()) {
-      assert(first.view_pos && last.view_pos);
-      vec_.reserve(view_.size() - (last - first));
-      vec_.assign(view_.begin(), first.view_pos);
-      if (last.view_pos != view_.end())
-          vec_.insert(vec_.end(), last.view_pos + 1, view_.end());
-      it.itr = vec_.begin() + (first.view_pos - view_.begin());
-      it.view_pos = nullptr;
-      view_.clear();
-    } else {
-      assert(!first.view_pos && !last.view_pos);
-      it.itr = vec_.erase(first.itr, last.itr);
-    }
-    return it;
+    size_t pos = first - begin();
+    size_t n = last - first;
+    make_vector().erase(vec_.begin() + pos, vec_.begin() + pos + n);
+    syncView();
+    return begin() + pos;
   }
 
   void reserve(size_t sz) {
+    if (isView()) return;
     vec_.reserve(sz);
+    syncView();
   }
 
   void assign(std::initializer_list<value_type> il) {
-    make_vector().assign(il);
+    make_vector().assign(il.begin(), il.end());
+    syncView();
   }
 
   template <class X, class Y>
   void assign(const X& first, const Y& last) {
     make_vector().assign(first, last);
+    syncView();
   }
 
   template <class X, class Y>
   void insert(iterator position, const X& first, const Y& last) {
-    if (view_.size()) {
-      assert(position.view_pos);
-      vec_.assign(view_.begin(), position.view_pos);
-      vec_.insert(vec_.end(), first, last);
-      if (position.view_pos != view_.end())
-        vec_.insert(vec_.end(), position.view_pos + 1, view_.end());
-      view_.clear();
-    } else {
-      assert(!position.view_pos);
-      vec_.insert(position.itr, first, last);
-    }
+    size_t pos = position - begin();
+    make_vector().insert(vec_.begin() + pos, first, last);
+    syncView();
   }
 
   void insert(iterator position, const value_type& val) {
@@ -379,21 +321,50 @@ public:
   }
 
   void swap(VectorExT<T, VEC_T>& t) {
+    // the std::vector storage doesn't move on swap, so the views stay valid
     vec_.swap(t.vec_);
     view_.swap(t.view_);
   }
 
 private:
-  ::std::vector<T>& make_vector() {
-    if (view_.size()) {
+  bool isView() const {
+    return view_.data() != (T*)vec_.data();
+  }
+
+  void syncView() {
+    view_ = array_view<T>((T*)vec_.data(), vec_.size());
+  }
+
+  // turns a view into an owned vector holding a copy of its data
+  storage_type& make_vector() {
+    if (isView()) {
       vec_.assign(view_.begin(), view_.end());
+      syncView();
     }
-    view_.clear();
     return vec_;
   }
 
+  void copyFrom(const VectorExT& t) {
+    if (t.isView()) {
+      storage_type().swap(vec_);
+      view_ = t.view_;
+    }
+    else {
+      vec_ = t.vec_;
+      syncView();
+    }
+  }
+
+  void moveFrom(VectorExT& t) {
+    bool view = t.isView();
+    vec_ = std::move(t.vec_);
+    view_ = view ? t.view_ : array_view<T>((T*)vec_.data(), vec_.size());
+    t.vec_.clear();
+    t.syncView();
+  }
+
 private:
-  ::std::vector<VEC_T> vec_;
+  storage_type vec_;
   array_view<T> view_;
 };
 
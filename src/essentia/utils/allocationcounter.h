@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_ALLOCATIONCOUNTER_H
+#define ESSENTIA_ALLOCATIONCOUNTER_H
+
+/**
+ * Counts the memory allocations made by a program: the calls to the global
+ * operator new, which this header replaces, and the allocations of the
+ * aligned storage of the vectors of Real (see AlignedAllocator).
+ *
+ * It is meant for the benchmarks and the tests checking that algorithms do
+ * not allocate memory once they have been configured, and must be included
+ * in exactly one source file of the program. On Windows, the allocations made
+ * with operator new inside the essentia DLL are not counted.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdint.h>
+#include "../types.h"
+
+namespace essentia {
+
+struct AllocationCount {
+  uint64_t allocations;
+  uint64_t bytes;
+
+  AllocationCount operator-(const AllocationCount& other) const {
+    AllocationCount result;
+    result.allocations = allocations - other.allocations;
+    result.bytes = bytes - other.bytes;
+    return result;
+  }
+};
+
+inline std::atomic<uint64_t>& allocationCounter() {
+  static std::atomic<uint64_t> counter(0);
+  return counter;
+}
+
+inline std::atomic<uint64_t>& allocatedBytesCounter() {
+  static std::atomic<uint64_t> counter(0);
+  return counter;
+}
+
+inline void countAllocation(size_t bytes) {
+  allocationCounter().fetch_add(1, std::memory_order_relaxed);
+  allocatedBytesCounter().fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of allocations made by all the threads of the program
+ * since it started. Take the difference between two calls to count the
+ * allocations made by a piece of code.
+ */
+inline AllocationCount allocationCount() {
+  AllocationCount count;
+  count.allocations = allocationCounter().load(std::memory_order_relaxed);
+  count.bytes = allocatedBytesCounter().load(std::memory_order_relaxed);
+  return count;
+}
+
+/**
+ * Returns whether the allocations are actually counted, i.e. whether the
+ * operator new of this header is the one used by the program (it is not if
+ * another one replaces it, e.g. in some instrumented builds), so that the
+ * tests relying on the counts can be skipped instead of checking nothing.
+ */
+inline bool allocationCountingEnabled() {
+  uint64_t before = allocationCounter().load(std::memory_order_relaxed);
+  void* volatile p = ::operator new(1);
+  ::operator delete(p);
+  return allocationCounter().load(std::memory_order_relaxed) != before;
+}
+
+namespace {
+
+struct AlignedAllocationHookInstaller {
+  AlignedAllocationHookInstaller() { alignedAllocationHook = &countAllocation; }
+} alignedAllocationHookInstaller;
+
+} // namespace
+
+} // namespace essentia
+
+
+void* operator new(size_t size) {
+  essentia::countAllocation(size);
+  void* p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size) {
+  essentia::countAllocation(size);
+  void* p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  essentia::countAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  essentia::countAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+#endif // ESSENTIA_ALLOCATIONCOUNTER_H
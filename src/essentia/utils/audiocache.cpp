@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "audiocache.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include "essentia.h"
+#ifndef OS_WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else // OS_WIN32
+#include <direct.h>
+#include <process.h>
+#endif // OS_WIN32
+
+using namespace std;
+
+namespace essentia {
+
+namespace {
+
+const char MAGIC[8] = { 'E', 'S', 'S', 'P', 'C', 'M', 0, 0 };
+const uint32_t VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const size_t HEADER_SIZE = 128;
+const size_t CODEC_SIZE = 32;
+const size_t MD5_SIZE = 32;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t frames;
+  float sampleRate;
+  int32_t channels;
+  int32_t bitRate;
+  char codec[CODEC_SIZE];
+  char md5[MD5_SIZE];
+};
+
+std::atomic<uint64_t> cacheHits(0);
+std::atomic<uint64_t> cacheMisses(0);
+std::atomic<uint64_t> cacheBytesRead(0);
+std::atomic<uint64_t> cacheBytesWritten(0);
+std::atomic<unsigned int> tmpCounter(0);
+
+// splitmix64 finalizer, used to mix each 8-byte word of the file
+inline uint64_t mix(uint64_t x) {
+  x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+string hex64(uint64_t x) {
+  ostringstream s;
+  s << hex << setw(16) << setfill('0') << x;
+  return s.str();
+}
+
+void copyString(char* dst, size_t size, const string& src) {
+  memset(dst, 0, size);
+  memcpy(dst, src.data(), min(size, src.size()));
+}
+
+string readString(const char* src, size_t size) {
+  return string(src, strnlen(src, size));
+}
+
+} // namespace
+
+
+AudioCacheStatistics audioCacheStatistics() {
+  AudioCacheStatistics stats;
+  stats.hits = cacheHits;
+  stats.misses = cacheMisses;
+  stats.bytesRead = cacheBytesRead;
+  stats.bytesWritten = cacheBytesWritten;
+  return stats;
+}
+
+void resetAudioCacheStatistics() {
+  cacheHits = 0;
+  cacheMisses = 0;
+  cacheBytesRead = 0;
+  cacheBytesWritten = 0;
+}
+
+
+string audioCacheDirectory(const string& parameter) {
+  if (!parameter.empty()) return parameter;
+  const char* env = getenv("ESSENTIA_AUDIO_CACHE");
+  return env ? string(env) : string();
+}
+
+
+string audioCachePath(const string& directory, const string& filename, int audioStream) {
+  ifstream file(filename.c_str(), ios::in | ios::binary);
+  // let the loader report why it cannot open the file
+  if (!file.good()) return string();
+
+  // the hash also covers the version of the format of the entries and the
+  // decoded stream, so that entries decoded differently never collide
+  uint64_t h = mix(0x9e3779b97f4a7c15ULL ^ VERSION) ^ mix(audioStream + 1);
+  uint64_t size = 0;
+
+  ::essentia::VectorEx<uint64_t> block(1 << 17);
+  while (file) {
+    file.read((char*)block.data(), block.size()*sizeof(uint64_t));
+    size_t n = file.gcount();
+    if (n == 0) break;
+
+    // zero the end of the last (incomplete) word
+    if (n % sizeof(uint64_t)) {
+      memset((char*)block.data() + n, 0, sizeof(uint64_t) - n % sizeof(uint64_t));
+    }
+    size_t nwords = (n + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    for (size_t i=0; i<nwords; i++) {
+      h = (h ^ mix(block[i])) * 0x100000001b3ULL;
+      h ^= h >> 29;
+    }
+    size += n;
+  }
+  h = mix(h ^ size);
+
+  string path = directory;
+  if (!path.empty() && path[path.size()-1] != '/') path += '/';
+  ostringstream name;
+  name << hex64(h) << "-" << hex << size << "-" << dec << audioStream << ".pcm";
+  return path + name.str();
+}
+
+
+AudioCacheEntry::AudioCacheEntry() : _samples(0), _data(0), _size(0) {}
+
+AudioCacheEntry::~AudioCacheEntry() {
+  close();
+}
+
+void AudioCacheEntry::close() {
+#ifndef OS_WIN32
+  if (_data) munmap(_data, _size);
+#endif // OS_WIN32
+  _data = 0;
+  _size = 0;
+  _samples = 0;
+  _buffer.clear();
+  _info = AudioCacheInfo();
+}
+
+bool AudioCacheEntry::open(const string& path) {
+  close();
+
+  const char* data = 0;
+  size_t size = 0;
+
+#ifndef OS_WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < HEADER_SIZE) {
+    ::close(fd);
+    return false;
+  }
+
+  _size = st.st_size;
+  _data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (_data == MAP_FAILED) {
+    _data = 0;
+    _size = 0;
+    return false;
+  }
+  data = (const char*)_data;
+  size = _size;
+
+#else // OS_WIN32
+  ifstream file(path.c_str(), ios::in | ios::binary | ios::ate);
+  if (!file.good()) return false;
+  size = file.tellg();
+  if (size < HEADER_SIZE) return false;
+  _buffer.resize((size + sizeof(float) - 1) / sizeof(float));
+  file.seekg(0);
+  file.read((char*)_buffer.data(), size);
+  if (!file.good()) {
+    _buffer.clear();
+    return false;
+  }
+  data = (const char*)_buffer.data();
+#endif // OS_WIN32
+
+  Header header;
+  memcpy(&header, data, sizeof(Header));
+
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != VERSION ||
+      header.byteOrder != BYTE_ORDER_MARK ||
+      header.channels <= 0 ||
+      size != HEADER_SIZE + header.frames*header.channels*sizeof(float)) {
+    close();
+    return false;
+  }
+
+  _info.frames = header.frames;
+  _info.sampleRate = header.sampleRate;
+  _info.channels = header.channels;
+  _info.bitRate = header.bitRate;
+  _info.codec = readString(header.codec, CODEC_SIZE);
+  _info.md5 = readString(header.md5, MD5_SIZE);
+  _samples = (const float*)(data + HEADER_SIZE);
+
+  return true;
+}
+
+
+AudioCacheWriter::AudioCacheWriter(const string& path, int channels) :
+    _path(path), _channels(channels), _frames(0) {
+
+  // create the cache directory if needed (but not its parents)
+  size_t slash = path.rfind('/');
+  if (slash != string::npos && slash > 0) {
+#ifndef OS_WIN32
+    mkdir(path.substr(0, slash).c_str(), 0777);
+#else // OS_WIN32
+    _mkdir(path.substr(0, slash).c_str());
+#endif // OS_WIN32
+  }
+
+  ostringstream tmp;
+  tmp << path << ".tmp." << getpid() << "." << tmpCounter++;
+  _tmpPath = tmp.str();
+
+  _file.open(_tmpPath.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!_file.good()) {
+    throw EssentiaException("AudioCache: could not create file ", _tmpPath);
+  }
+
+  // the header is written on commit, once the number of frames is known
+  char header[HEADER_SIZE] = { 0 };
+  _file.write(header, HEADER_SIZE);
+}
+
+AudioCacheWriter::~AudioCacheWriter() {
+  if (_file.is_open()) {
+    _file.close();
+    remove(_tmpPath.c_str());
+  }
+}
+
+void AudioCacheWriter::append(const float* samples, uint64_t nframes) {
+  _file.write((const char*)samples, nframes*_channels*sizeof(float));
+  _frames += nframes;
+}
+
+void AudioCacheWriter::commit(const AudioCacheInfo& info) {
+  if (info.channels != _channels) {
+    throw EssentiaException("AudioCache: number of channels changed while writing ", _path);
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.frames = _frames;
+  header.sampleRate = info.sampleRate;
+  header.channels = _channels;
+  header.bitRate = info.bitRate;
+  copyString(header.codec, CODEC_SIZE, info.codec);
+  copyString(header.md5, MD5_SIZE, info.md5);
+
+  _file.seekp(0);
+  _file.write((const char*)&header, sizeof(Header));
+  _file.close();
+
+  // a failed write leaves no entry, the file will just be decoded again
+  if (_file.fail() || rename(_tmpPath.c_str(), _path.c_str()) != 0) {
+    remove(_tmpPath.c_str());
+    E_WARNING("AudioCache: could not write cache entry " << _path);
+    return;
+  }
+
+  cacheBytesWritten += _frames*_channels*sizeof(float);
+}
+
+
+void audioCacheHit(uint64_t bytesRead) {
+  cacheHits++;
+  cacheBytesRead += bytesRead;
+}
+
+void audioCacheMiss() {
+  cacheMisses++;
+}
+
+} // namespace essentia
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_AUDIOCACHE_H
+#define ESSENTIA_AUDIOCACHE_H
+
+#include <fstream>
+#include <string>
+#include <stdint.h>
+#include "types.h"
+
+namespace essentia {
+
+/**
+ * On-disk cache of decoded audio, used by the AudioLoader so that a file
+ * analyzed several times is only decoded once.
+ *
+ * An entry holds the decoded samples of one audio stream of a file, as
+ * interleaved 32-bit floats at the original sampling rate of the file (that
+ * is, the output of the AudioLoader before any downmixing or resampling).
+ * Entries are named after a hash of the content of the file and of the
+ * decoding settings, so that renaming or moving a file keeps its entry valid
+ * and modifying it invalidates it.
+ *
+ * An entry file is a 128-byte header followed by the samples:
+ *  - char[8]   magic: "ESSPCM" followed by two 0 bytes
+ *  - uint32    version of the format (1)
+ *  - uint32    0x01020304, written in the byte order of the machine that
+ *              wrote the file
+ *  - uint64    number of frames (samples per channel)
+ *  - float     sampling rate
+ *  - int32     number of channels
+ *  - int32     bit rate
+ *  - char[32]  codec name, padded with 0 bytes
+ *  - char[32]  MD5 checksum of the undecoded audio payload, in hex
+ *  - padding with 0 bytes up to 128 bytes
+ *
+ * Entries are written to a temporary file which is renamed once complete, so
+ * that several processes can share a cache directory.
+ */
+struct AudioCacheInfo {
+  Real sampleRate;
+  int channels;
+  int bitRate;
+  std::string codec;
+  std::string md5;
+  uint64_t frames;
+
+  AudioCacheInfo() : sampleRate(0), channels(0), bitRate(0), frames(0) {}
+};
+
+/**
+ * Number of files loaded from the cache (hits) and decoded because they were
+ * not in it (misses) by all the AudioLoaders of the process, and the number of
+ * bytes of samples read from and written to it.
+ */
+struct AudioCacheStatistics {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t bytesRead;
+  uint64_t bytesWritten;
+};
+
+AudioCacheStatistics audioCacheStatistics();
+void resetAudioCacheStatistics();
+
+// called by the AudioLoader when it is done loading a file
+void audioCacheHit(uint64_t bytesRead);
+void audioCacheMiss();
+
+/**
+ * Returns the cache directory to use for the given value of the
+ * "cacheDirectory" parameter of the loaders: the parameter itself if it is not
+ * empty, the ESSENTIA_AUDIO_CACHE environment variable otherwise. An empty
+ * string means that caching is disabled.
+ */
+std::string audioCacheDirectory(const std::string& parameter);
+
+/**
+ * Returns the path of the entry for the given stream of the given file, or an
+ * empty string if the file cannot be read. The content of the file is read to
+ * compute its hash.
+ */
+std::string audioCachePath(const std::string& directory,
+                           const std::string& filename, int audioStream);
+
+
+/**
+ * Read-only view over an entry of the cache. On POSIX systems the entry is
+ * memory-mapped, so opening it is cheap and any range of frames can be
+ * accessed directly.
+ */
+class AudioCacheEntry {
+ public:
+  AudioCacheEntry();
+  ~AudioCacheEntry();
+
+  /**
+   * Opens the entry at the given path, returns false if it does not exist or
+   * is not a valid entry.
+   */
+  bool open(const std::string& path);
+  void close();
+  bool isOpen() const { return _samples != 0; }
+
+  const AudioCacheInfo& info() const { return _info; }
+
+  /**
+   * Returns the interleaved samples of the entry, starting at the given frame.
+   */
+  const float* frames(uint64_t start = 0) const { return _samples + start*_info.channels; }
+
+ protected:
+  AudioCacheInfo _info;
+  const float* _samples;
+  void* _data;
+  size_t _size;
+  ::essentia::VectorEx<float> _buffer; // holds the entry when it cannot be mapped
+
+  // not copyable
+  AudioCacheEntry(const AudioCacheEntry&);
+  AudioCacheEntry& operator=(const AudioCacheEntry&);
+};
+
+
+/**
+ * Writes an entry of the cache. Frames are appended as they are decoded, and
+ * the entry only becomes visible to readers once commit() is called. If the
+ * writer is destroyed before that, the partial entry is removed.
+ */
+class AudioCacheWriter {
+ public:
+  AudioCacheWriter(const std::string& path, int channels);
+  ~AudioCacheWriter();
+
+  void append(const float* samples, uint64_t nframes);
+  void commit(const AudioCacheInfo& info);
+
+ protected:
+  std::string _path;
+  std::string _tmpPath;
+  std::ofstream _file;
+  int _channels;
+  uint64_t _frames;
+
+  // not copyable
+  AudioCacheWriter(const AudioCacheWriter&);
+  AudioCacheWriter& operator=(const AudioCacheWriter&);
+};
+
+} // namespace essentia
+
+#endif // ESSENTIA_AUDIOCACHE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <chrono>
+#include "batchextractor.h"
+#include "threadpool.h"
+#include "../algorithmfactory.h"
+using namespace std;
+
+namespace essentia {
+
+BatchExtractor::BatchExtractor(const string& extractorName,
+                               const ParameterMap& parameters,
+                               int nThreads) : _extractorName(extractorName),
+                                               _parameters(parameters),
+                                               _processed(0), _failed(0), _elapsed(0) {
+  _nThreads = (nThreads > 0) ? nThreads : ThreadPool::hardwareConcurrency();
+  _threadPool = new ThreadPool(_nThreads);
+}
+
+BatchExtractor::~BatchExtractor() {
+  delete _threadPool;
+  for (int i=0; i<(int)_extractors.size(); i++) delete _extractors[i];
+}
+
+standard::Algorithm* BatchExtractor::acquireExtractor() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    if (!_idle.empty()) {
+      standard::Algorithm* extractor = _idle.back();
+      _idle.pop_back();
+      return extractor;
+    }
+  }
+
+  // no instance available, create a new one. This happens at most once per
+  // thread, and outside of the lock as configuring an extractor can be slow
+  standard::Algorithm* extractor = standard::AlgorithmFactory::create(_extractorName);
+  try {
+    extractor->configure(_parameters);
+  }
+  catch (...) {
+    delete extractor;
+    throw;
+  }
+
+  lock_guard<mutex> lock(_mutex);
+  _extractors.push_back(extractor);
+  return extractor;
+}
+
+void BatchExtractor::releaseExtractor(standard::Algorithm* extractor) {
+  lock_guard<mutex> lock(_mutex);
+  _idle.push_back(extractor);
+}
+
+void BatchExtractor::processFile(const string& filename, const ResultCallback& callback) {
+  Result result;
+  result.filename = filename;
+  result.ok = true;
+
+  standard::Algorithm* extractor = 0;
+  try {
+    extractor = acquireExtractor();
+    extractor->input("filename").set(filename);
+    extractor->output("results").set(result.results);
+    extractor->output("resultsFrames").set(result.resultsFrames);
+    extractor->compute();
+  }
+  catch (exception& e) {
+    result.ok = false;
+    result.error = e.what();
+    result.results.clear();
+    result.resultsFrames.clear();
+  }
+  if (extractor) {
+    extractor->reset();
+    releaseExtractor(extractor);
+  }
+
+  lock_guard<mutex> lock(_callbackMutex);
+  _processed++;
+  if (!result.ok) _failed++;
+  if (callback) callback(result);
+}
+
+void BatchExtractor::process(const ::essentia::VectorEx<string>& filenames,
+                             const ResultCallback& callback) {
+  _processed = 0;
+  _failed = 0;
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+  for (int i=0; i<(int)filenames.size(); i++) {
+    const string& filename = filenames[i];
+    _threadPool->enqueue([this, &filename, &callback]() {
+      try {
+        processFile(filename, callback);
+      }
+      catch (exception& e) {
+        // only the callback can throw here, there is nobody to report it to
+        E_WARNING("BatchExtractor: error while handling the results of " << filename << ": " << e.what());
+      }
+    });
+  }
+  _threadPool->wait();
+
+  _elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double BatchExtractor::throughput() const {
+  return (_elapsed > 0) ? _processed / _elapsed : 0;
+}
+
+} // namespace essentia
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_BATCHEXTRACTOR_H
+#define ESSENTIA_BATCHEXTRACTOR_H
+
+#include <string>
+#include <mutex>
+#include <functional>
+#include "../algorithm.h"
+#include "../pool.h"
+
+namespace essentia {
+
+class ThreadPool;
+
+/**
+ * The BatchExtractor runs a file-level extractor (MusicExtractor by default,
+ * or any standard algorithm with a "filename" input and "results" and
+ * "resultsFrames" Pool outputs, such as FreesoundExtractor) over a list of
+ * audio files, using several threads.
+ *
+ * There are at most as many instances of the extractor as there are threads.
+ * They are created and configured only once, when first needed, and are then
+ * reused for all the following files (and calls to process()). This saves
+ * the cost of loading the profile and models, and of creating the
+ * algorithms, for each file.
+ *
+ * Results are handed to a callback as soon as each file is done, so they can
+ * be written out (or discarded) without having to keep all of them in memory.
+ *
+ * essentia::init() must have been called before using this class.
+ */
+class ESSENTIA_API BatchExtractor {
+ public:
+
+  /**
+   * The results of the extractor for one file. If the extraction failed,
+   * @c error contains the message of the exception that was thrown and the
+   * pools are empty.
+   */
+  struct Result {
+    std::string filename;
+    Pool results;
+    Pool resultsFrames;
+    bool ok;
+    std::string error;
+  };
+
+  /**
+   * Called once per file, in the order in which files finish. Calls are
+   * serialized, so the callback doesn't need to be thread-safe itself.
+   */
+  typedef std::function<void(const Result&)> ResultCallback;
+
+  /**
+   * @param extractorName the name of the standard algorithm to use
+   * @param parameters the parameters used to configure each instance of it,
+   *                   e.g.: the "profile" for the MusicExtractor
+   * @param nThreads the number of files processed concurrently, 0 to use
+   *                 as many as there are hardware threads
+   */
+  BatchExtractor(const std::string& extractorName = "MusicExtractor",
+                 const ParameterMap& parameters = ParameterMap(),
+                 int nThreads = 0);
+  ~BatchExtractor();
+
+  int numThreads() const { return _nThreads; }
+
+  /**
+   * Processes all the given files and returns when they are all done. Errors
+   * in one file do not stop the processing of the others, they are reported
+   * through the callback instead.
+   */
+  void process(const ::essentia::VectorEx<std::string>& filenames,
+               const ResultCallback& callback);
+
+  /**
+   * Statistics of the last call to process().
+   */
+  int processedFiles() const { return _processed; }
+  int failedFiles() const { return _failed; }
+  double elapsedTime() const { return _elapsed; }  // in seconds
+  double throughput() const;                        // in files per second
+
+ protected:
+  standard::Algorithm* acquireExtractor();
+  void releaseExtractor(standard::Algorithm* extractor);
+  void processFile(const std::string& filename, const ResultCallback& callback);
+
+  std::string _extractorName;
+  ParameterMap _parameters;
+  int _nThreads;
+
+  ThreadPool* _threadPool;
+
+  ::essentia::VectorEx<standard::Algorithm*> _extractors; // all the instances
+  ::essentia::VectorEx<standard::Algorithm*> _idle;       // those not in use
+  std::mutex _mutex;
+  std::mutex _callbackMutex;
+
+  int _processed;
+  int _failed;
+  double _elapsed;
+};
+
+} // namespace essentia
+
+#endif // ESSENTIA_BATCHEXTRACTOR_H
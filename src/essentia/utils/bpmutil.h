@@ -161,7 +161,7 @@ inline
 
   hist(&dticks[0], nticks-1, &dist[0], &distx[0], nbins);
 
-  int maxidx = max_element(dist.begin(), dist.end()) - dist.begin();
+  int maxidx = std::max_element(dist.begin(), dist.end()) - dist.begin();
   Real maxbinCenter = distx[maxidx];
 
   // find the longest sequence of beats which has a fixed period of the previously
@@ -281,7 +281,7 @@ inline
 
   hist(&dticks[0], dticks.size(), &dist[0], &distx[0], nbins);
 
-  int maxidx = max_element(dist.begin(), dist.end()) - dist.begin();
+  int maxidx = std::max_element(dist.begin(), dist.end()) - dist.begin();
   Real maxbinCenter = distx[maxidx];
 
   // find the longest sequence of beats which has a fixed period of the previously
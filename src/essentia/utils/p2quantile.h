@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_P2QUANTILE_H
+#define ESSENTIA_P2QUANTILE_H
+
+#include <algorithm>
+#include "types.h"
+
+namespace essentia {
+namespace util {
+
+/**
+ * Estimation of a quantile of a sequence of values, without storing them,
+ * using the P² algorithm: five markers track the minimum, the maximum, the
+ * quantile and two points halfway towards it, and their heights are adjusted
+ * with a piecewise-parabolic interpolation as the values come in. It uses a
+ * constant amount of memory whatever the number of values.
+ *
+ * The quantile is exact for up to 5 values, interpolating linearly between
+ * the two closest ones (which, for the median, averages the two middle values
+ * of an even number of them, as median() in essentiamath.h does).
+ *
+ * References:
+ *   [1] R. Jain and I. Chlamtac, "The P² algorithm for dynamic calculation of
+ *   quantiles and histograms without storing observations," Communications
+ *   of the ACM, vol. 28, no. 10, pp. 1076-1085, 1985.
+ */
+class P2Quantile {
+ public:
+  P2Quantile(double p = 0.5) { setQuantile(p); }
+
+  void setQuantile(double p) {
+    if (p < 0 || p > 1) {
+      throw EssentiaException("P2Quantile: the quantile has to be in [0, 1]");
+    }
+    _p = p;
+    reset();
+  }
+
+  double quantile() const { return _p; }
+
+  void reset() {
+    _count = 0;
+  }
+
+  size_t count() const { return _count; }
+
+  void add(double x) {
+    if (_count < 5) {
+      _q[_count++] = x;
+      if (_count == 5) initMarkers();
+      return;
+    }
+    _count++;
+
+    // find the cell of x, extending the extreme markers if needed
+    int k;
+    if (x < _q[0]) {
+      _q[0] = x;
+      k = 0;
+    }
+    else if (x >= _q[4]) {
+      _q[4] = x;
+      k = 3;
+    }
+    else {
+      k = 0;
+      while (x >= _q[k+1]) k++;
+    }
+
+    for (int i=k+1; i<5; i++) _n[i]++;
+    for (int i=0; i<5; i++) _desired[i] += _increment[i];
+
+    // adjust the heights of the middle markers that are off their position
+    for (int i=1; i<4; i++) {
+      double d = _desired[i] - _n[i];
+      if ((d >= 1 && _n[i+1] - _n[i] > 1) || (d <= -1 && _n[i-1] - _n[i] < -1)) {
+        int s = d > 0 ? 1 : -1;
+        double q = parabolic(i, s);
+        if (_q[i-1] < q && q < _q[i+1]) _q[i] = q;
+        else _q[i] += s * (_q[i+s] - _q[i]) / (_n[i+s] - _n[i]);
+        _n[i] += s;
+      }
+    }
+  }
+
+  /**
+   * Returns the estimated quantile, or 0 if no value has been added yet.
+   */
+  double value() const {
+    if (_count == 0) return 0.0;
+    if (_count > 5) return _q[2];
+
+    double sorted[5];
+    std::copy(_q, _q + _count, sorted);
+    std::sort(sorted, sorted + _count);
+    double pos = _p * (_count - 1);
+    int i = (int)pos;
+    if (i >= (int)_count - 1) return sorted[_count - 1];
+    return sorted[i] + (pos - i) * (sorted[i+1] - sorted[i]);
+  }
+
+ protected:
+  void initMarkers() {
+    std::sort(_q, _q + 5);
+    for (int i=0; i<5; i++) _n[i] = i;
+    _desired[0] = 0;
+    _desired[1] = 2*_p;
+    _desired[2] = 4*_p;
+    _desired[3] = 2 + 2*_p;
+    _desired[4] = 4;
+    _increment[0] = 0;
+    _increment[1] = _p/2;
+    _increment[2] = _p;
+    _increment[3] = (1 + _p)/2;
+    _increment[4] = 1;
+  }
+
+  double parabolic(int i, int s) const {
+    return _q[i] + s / double(_n[i+1] - _n[i-1]) *
+      ((_n[i] - _n[i-1] + s) * (_q[i+1] - _q[i]) / double(_n[i+1] - _n[i]) +
+       (_n[i+1] - _n[i] - s) * (_q[i] - _q[i-1]) / double(_n[i] - _n[i-1]));
+  }
+
+  double _p;
+  size_t _count;
+  // marker heights (the first values until there are 5 of them), positions,
+  // desired positions and increments of the desired positions
+  double _q[5];
+  long _n[5];
+  double _desired[5];
+  double _increment[5];
+};
+
+} // namespace util
+} // namespace essentia
+
+#endif // ESSENTIA_P2QUANTILE_H
@@ -0,0 +1,435 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "poolbinary.h"
+#include <fstream>
+#include <cstring>
+#ifndef OS_WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace essentia {
+
+namespace {
+
+const char magic[8] = { 'E', 'S', 'S', 'P', 'O', 'O', 'L', '\0' };
+const uint32_t formatVersion = 1;
+const uint32_t byteOrderMark = 0x01020304;
+
+// keeps track of the position in the stream to pad the records
+class BinaryWriter {
+ public:
+  BinaryWriter(ostream& out) : _out(out), _pos(0) {}
+
+  void bytes(const void* data, size_t size) {
+    _out.write((const char*)data, size);
+    _pos += size;
+  }
+
+  void u32(uint32_t x) { bytes(&x, sizeof(x)); }
+  void u64(uint64_t x) { bytes(&x, sizeof(x)); }
+  void reals(const Real* x, size_t n) { if (n) bytes(x, n*sizeof(Real)); }
+
+  void str(const string& s) {
+    u64(s.size());
+    bytes(s.data(), s.size());
+  }
+
+  void strings(const ::essentia::VectorEx<string>& v) {
+    u64(v.size());
+    for (size_t i=0; i<v.size(); i++) str(v[i]);
+  }
+
+  void pad() {
+    static const char zeros[8] = { 0 };
+    if (_pos % 8) bytes(zeros, 8 - _pos % 8);
+  }
+
+  void header(PoolBinary::DescriptorType type, const string& name) {
+    u32(type);
+    u32(name.size());
+    bytes(name.data(), name.size());
+    pad();
+  }
+
+  void tensor(const Tensor<Real>& t) {
+    for (int i=0; i<TENSORRANK; i++) u64(t.dimension(i));
+    reals(t.data(), t.size());
+    pad();
+  }
+
+ protected:
+  ostream& _out;
+  uint64_t _pos;
+};
+
+// reads values in place from the buffer, checking that they are inside of it
+class BinaryReader {
+ public:
+  BinaryReader(const char* data, size_t size) : _data(data), _size(size), _pos(0) {}
+
+  uint64_t remaining() const { return _size - _pos; }
+
+  void truncated() const {
+    throw EssentiaException("PoolBinary: unexpected end of data, the file is truncated or corrupted");
+  }
+
+  const char* bytes(uint64_t size) {
+    if (size > remaining()) truncated();
+    const char* result = _data + _pos;
+    _pos += size;
+    return result;
+  }
+
+  uint32_t u32() { uint32_t x; memcpy(&x, bytes(sizeof(x)), sizeof(x)); return x; }
+  uint64_t u64() { uint64_t x; memcpy(&x, bytes(sizeof(x)), sizeof(x)); return x; }
+
+  // the arrays are aligned in the file, but not necessarily in the buffer
+  void reals(Real* x, uint64_t n) {
+    if (n > remaining() / sizeof(Real)) truncated();
+    if (n) memcpy(x, bytes(n*sizeof(Real)), n*sizeof(Real));
+  }
+
+  string str() {
+    uint64_t size = u64();
+    return string(bytes(size), size);
+  }
+
+  ::essentia::VectorEx<string> strings() {
+    ::essentia::VectorEx<string> v(count(sizeof(uint64_t)));
+    for (size_t i=0; i<v.size(); i++) v[i] = str();
+    return v;
+  }
+
+  // a number of items of at least minSize bytes each, which is checked
+  // against the remaining data before anything is allocated for them
+  uint64_t count(uint64_t minSize) {
+    uint64_t n = u64();
+    if (minSize && n > remaining() / minSize) truncated();
+    return n;
+  }
+
+  void pad() {
+    if (_pos % 8) bytes(8 - _pos % 8);
+  }
+
+  Tensor<Real> tensor() {
+    uint64_t dims[TENSORRANK];
+    uint64_t total = 1;
+    for (int i=0; i<TENSORRANK; i++) {
+      dims[i] = u64();
+      if (dims[i] && total > remaining() / sizeof(Real) / dims[i]) truncated();
+      total *= dims[i];
+    }
+    Tensor<Real> t((long)dims[0], (long)dims[1], (long)dims[2], (long)dims[3]);
+    reals(t.data(), total);
+    pad();
+    return t;
+  }
+
+ protected:
+  const char* _data;
+  uint64_t _size;
+  uint64_t _pos;
+};
+
+} // namespace
+
+
+void writePoolBinary(const Pool& pool, ostream& out) {
+  BinaryWriter w(out);
+
+  uint64_t count = pool.getSingleRealPool().size() + pool.getRealPool().size() +
+    pool.getSingleVectorRealPool().size() + pool.getVectorRealPool().size() +
+    pool.getSingleStringPool().size() + pool.getStringPool().size() +
+    pool.getSingleVectorStringPool().size() + pool.getVectorStringPool().size() +
+    pool.getArray2DRealPool().size() + pool.getStereoSamplePool().size() +
+    pool.getSingleTensorRealPool().size() + pool.getTensorRealPool().size();
+
+  w.bytes(magic, sizeof(magic));
+  w.u32(formatVersion);
+  w.u32(byteOrderMark);
+  w.u64(count);
+
+  for (map<string, Real>::const_iterator it = pool.getSingleRealPool().begin();
+       it != pool.getSingleRealPool().end(); ++it) {
+    w.header(PoolBinary::SINGLE_REAL, it->first);
+    w.reals(&it->second, 1);
+    w.pad();
+  }
+
+  for (PoolOf(Real)::const_iterator it = pool.getRealPool().begin();
+       it != pool.getRealPool().end(); ++it) {
+    w.header(PoolBinary::REAL, it->first);
+    w.u64(it->second.size());
+    w.reals(it->second.data(), it->second.size());
+    w.pad();
+  }
+
+  for (map<string, ::essentia::VectorEx<Real> >::const_iterator it = pool.getSingleVectorRealPool().begin();
+       it != pool.getSingleVectorRealPool().end(); ++it) {
+    w.header(PoolBinary::SINGLE_VECTOR_REAL, it->first);
+    w.u64(it->second.size());
+    w.reals(it->second.data(), it->second.size());
+    w.pad();
+  }
+
+  for (PoolOf(::essentia::VectorEx<Real>)::const_iterator it = pool.getVectorRealPool().begin();
+       it != pool.getVectorRealPool().end(); ++it) {
+    const ::essentia::VectorEx<::essentia::VectorEx<Real> >& frames = it->second;
+    w.header(PoolBinary::VECTOR_REAL, it->first);
+    w.u64(frames.size());
+    for (size_t i=0; i<frames.size(); i++) w.u64(frames[i].size());
+    for (size_t i=0; i<frames.size(); i++) w.reals(frames[i].data(), frames[i].size());
+    w.pad();
+  }
+
+  for (map<string, string>::const_iterator it = pool.getSingleStringPool().begin();
+       it != pool.getSingleStringPool().end(); ++it) {
+    w.header(PoolBinary::SINGLE_STRING, it->first);
+    w.str(it->second);
+    w.pad();
+  }
+
+  for (PoolOf(string)::const_iterator it = pool.getStringPool().begin();
+       it != pool.getStringPool().end(); ++it) {
+    w.header(PoolBinary::STRING, it->first);
+    w.strings(it->second);
+    w.pad();
+  }
+
+  for (map<string, ::essentia::VectorEx<string> >::const_iterator it = pool.getSingleVectorStringPool().begin();
+       it != pool.getSingleVectorStringPool().end(); ++it) {
+    w.header(PoolBinary::SINGLE_VECTOR_STRING, it->first);
+    w.strings(it->second);
+    w.pad();
+  }
+
+  for (PoolOf(::essentia::VectorEx<string>)::const_iterator it = pool.getVectorStringPool().begin();
+       it != pool.getVectorStringPool().end(); ++it) {
+    w.header(PoolBinary::VECTOR_STRING, it->first);
+    w.u64(it->second.size());
+    for (size_t i=0; i<it->second.size(); i++) w.strings(it->second[i]);
+    w.pad();
+  }
+
+  for (PoolOf(TNT::Array2D<Real>)::const_iterator it = pool.getArray2DRealPool().begin();
+       it != pool.getArray2DRealPool().end(); ++it) {
+    w.header(PoolBinary::ARRAY2D_REAL, it->first);
+    w.u64(it->second.size());
+    for (size_t i=0; i<it->second.size(); i++) {
+      const TNT::Array2D<Real>& m = it->second[i];
+      w.u64(m.dim1());
+      w.u64(m.dim2());
+      for (int row=0; row<m.dim1(); row++) w.reals(m[row], m.dim2());
+      w.pad();
+    }
+  }
+
+  for (PoolOf(StereoSample)::const_iterator it = pool.getStereoSamplePool().begin();
+       it != pool.getStereoSamplePool().end(); ++it) {
+    const ::essentia::VectorEx<StereoSample>& samples = it->second;
+    w.header(PoolBinary::STEREO_SAMPLE, it->first);
+    w.u64(samples.size());
+    for (size_t i=0; i<samples.size(); i++) {
+      w.reals(&samples[i].left(), 1);
+      w.reals(&samples[i].right(), 1);
+    }
+    w.pad();
+  }
+
+  for (map<string, Tensor<Real> >::const_iterator it = pool.getSingleTensorRealPool().begin();
+       it != pool.getSingleTensorRealPool().end(); ++it) {
+    w.header(PoolBinary::SINGLE_TENSOR_REAL, it->first);
+    w.tensor(it->second);
+  }
+
+  for (PoolOf(Tensor<Real>)::const_iterator it = pool.getTensorRealPool().begin();
+       it != pool.getTensorRealPool().end(); ++it) {
+    w.header(PoolBinary::TENSOR_REAL, it->first);
+    w.u64(it->second.size());
+    for (size_t i=0; i<it->second.size(); i++) w.tensor(it->second[i]);
+  }
+
+  if (!out.good()) {
+    throw EssentiaException("PoolBinary: error while writing the pool");
+  }
+}
+
+
+void readPoolBinary(const char* data, size_t size, Pool& pool) {
+  BinaryReader r(data, size);
+
+  if (memcmp(r.bytes(sizeof(magic)), magic, sizeof(magic)) != 0) {
+    throw EssentiaException("PoolBinary: not a binary pool file");
+  }
+  uint32_t version = r.u32();
+  if (version != formatVersion) {
+    throw EssentiaException("PoolBinary: unsupported version of the format: ", version);
+  }
+  if (r.u32() != byteOrderMark) {
+    throw EssentiaException("PoolBinary: the file was written on a machine with a different byte order");
+  }
+
+  uint64_t count = r.u64();
+  for (uint64_t d=0; d<count; d++) {
+    uint32_t type = r.u32();
+    uint32_t nameSize = r.u32();
+    string name(r.bytes(nameSize), nameSize);
+    r.pad();
+
+    switch (type) {
+
+    case PoolBinary::SINGLE_REAL: {
+      Real value;
+      r.reals(&value, 1);
+      pool.set(name, value);
+      break;
+    }
+
+    case PoolBinary::REAL:
+    case PoolBinary::SINGLE_VECTOR_REAL: {
+      ::essentia::VectorEx<Real> values(r.count(sizeof(Real)));
+      r.reals(values.data(), values.size());
+      if (type == PoolBinary::REAL) pool.append(name, values);
+      else pool.set(name, values);
+      break;
+    }
+
+    case PoolBinary::VECTOR_REAL: {
+      ::essentia::VectorEx<::essentia::VectorEx<Real> > frames(r.count(sizeof(uint64_t)));
+      ::essentia::VectorEx<uint64_t> sizes(frames.size());
+      for (size_t i=0; i<frames.size(); i++) sizes[i] = r.u64();
+      for (size_t i=0; i<frames.size(); i++) {
+        if (sizes[i] > r.remaining() / sizeof(Real)) r.truncated();
+        frames[i].resize(sizes[i]);
+        r.reals(frames[i].data(), sizes[i]);
+      }
+      pool.append(name, frames);
+      break;
+    }
+
+    case PoolBinary::SINGLE_STRING:
+      pool.set(name, r.str());
+      break;
+
+    case PoolBinary::STRING:
+      pool.append(name, r.strings());
+      break;
+
+    case PoolBinary::SINGLE_VECTOR_STRING:
+      pool.set(name, r.strings());
+      break;
+
+    case PoolBinary::VECTOR_STRING: {
+      ::essentia::VectorEx<::essentia::VectorEx<string> > frames(r.count(sizeof(uint64_t)));
+      for (size_t i=0; i<frames.size(); i++) frames[i] = r.strings();
+      pool.append(name, frames);
+      break;
+    }
+
+    case PoolBinary::ARRAY2D_REAL: {
+      uint64_t n = r.count(2*sizeof(uint64_t));
+      for (uint64_t i=0; i<n; i++) {
+        uint64_t dim1 = r.u64(), dim2 = r.u64();
+        if (dim1 && dim2 > r.remaining() / sizeof(Real) / dim1) r.truncated();
+        TNT::Array2D<Real> m((int)dim1, (int)dim2);
+        for (uint64_t row=0; row<dim1; row++) r.reals(m[row], dim2);
+        r.pad();
+        pool.add(name, m);
+      }
+      break;
+    }
+
+    case PoolBinary::STEREO_SAMPLE: {
+      ::essentia::VectorEx<StereoSample> samples(r.count(2*sizeof(Real)));
+      for (size_t i=0; i<samples.size(); i++) {
+        r.reals(&samples[i].left(), 1);
+        r.reals(&samples[i].right(), 1);
+      }
+      pool.append(name, samples);
+      break;
+    }
+
+    case PoolBinary::SINGLE_TENSOR_REAL:
+      pool.set(name, r.tensor());
+      break;
+
+    case PoolBinary::TENSOR_REAL: {
+      uint64_t n = r.count(TENSORRANK*sizeof(uint64_t));
+      for (uint64_t i=0; i<n; i++) pool.add(name, r.tensor());
+      break;
+    }
+
+    default:
+      throw EssentiaException("PoolBinary: unknown type of descriptor for '" + name + "'");
+    }
+
+    r.pad();
+  }
+}
+
+
+void readPoolBinary(const string& filename, Pool& pool) {
+#ifndef OS_WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) throw EssentiaException("PoolBinary: could not open file ", filename);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw EssentiaException("PoolBinary: could not get the size of file ", filename);
+  }
+
+  size_t size = st.st_size;
+  if (size == 0) {
+    close(fd);
+    throw EssentiaException("PoolBinary: empty file ", filename);
+  }
+
+  void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) throw EssentiaException("PoolBinary: could not map file ", filename);
+
+  // the file is parsed in a single sequential pass
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  try {
+    readPoolBinary((const char*)data, size, pool);
+  }
+  catch (...) {
+    munmap(data, size);
+    throw;
+  }
+  munmap(data, size);
+
+#else // OS_WIN32
+  ifstream file(filename.c_str(), ios::in | ios::binary);
+  if (!file.good()) throw EssentiaException("PoolBinary: could not open file ", filename);
+  string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  readPoolBinary(data.data(), data.size(), pool);
+#endif // OS_WIN32
+}
+
+} // namespace essentia
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_POOLBINARY_H
+#define ESSENTIA_POOLBINARY_H
+
+#include <ostream>
+#include "pool.h"
+
+namespace essentia {
+
+/**
+ * Binary serialization of a Pool. Its values are written as they are laid
+ * out in memory, so that writing and reading a file is mostly copying whole
+ * arrays of floats, and so that these arrays can be used in place in a
+ * memory-mapped file (the python module essentia.poolbinary does that).
+ *
+ * The file starts with a header:
+ *  - char[8]  magic: "ESSPOOL" followed by a 0 byte
+ *  - uint32   version of the format (1)
+ *  - uint32   0x01020304, written in the byte order of the machine that
+ *             wrote the file, which is also the one of all other numbers
+ *  - uint64   number of descriptors
+ *
+ * followed by one record per descriptor:
+ *  - uint32   type of the descriptor (one of the PoolBinary::DescriptorType values)
+ *  - uint32   size of the name, followed by the full (dotted) name
+ *  - the values of the descriptor
+ *
+ * Reals are 32-bit floats, sizes are uint64, and a string is its size
+ * followed by its bytes. The name and the values of a record are padded with
+ * zeros to a multiple of 8 bytes, and so are the values of each matrix or
+ * tensor inside them, so that all arrays of floats are 8-byte aligned. The
+ * values are, depending on the type:
+ *  - SINGLE_REAL:          float
+ *  - REAL:                 size n, float[n]
+ *  - SINGLE_VECTOR_REAL:   size n, float[n]
+ *  - VECTOR_REAL:          number of frames n, size[n] of each frame, then
+ *                          the floats of all the frames one after the other
+ *  - SINGLE_STRING:        string
+ *  - STRING:               size n, string[n]
+ *  - SINGLE_VECTOR_STRING: size n, string[n]
+ *  - VECTOR_STRING:        number of frames n, then for each frame its size
+ *                          followed by its strings
+ *  - ARRAY2D_REAL:         number of matrices, then for each one its two
+ *                          dimensions followed by its floats in row-major order
+ *  - STEREO_SAMPLE:        size n, float[2*n] (left and right channels
+ *                          interleaved)
+ *  - SINGLE_TENSOR_REAL:   4 dimensions, then the floats in row-major order
+ *  - TENSOR_REAL:          number of tensors, then for each one as for
+ *                          SINGLE_TENSOR_REAL
+ */
+namespace PoolBinary {
+
+enum DescriptorType {
+  SINGLE_REAL = 1,
+  REAL,
+  SINGLE_VECTOR_REAL,
+  VECTOR_REAL,
+  SINGLE_STRING,
+  STRING,
+  SINGLE_VECTOR_STRING,
+  VECTOR_STRING,
+  ARRAY2D_REAL,
+  STEREO_SAMPLE,
+  SINGLE_TENSOR_REAL,
+  TENSOR_REAL
+};
+
+} // namespace PoolBinary
+
+/**
+ * Writes all the descriptors of the pool to the given stream, which should
+ * have been opened in binary mode.
+ */
+void writePoolBinary(const Pool& pool, std::ostream& out);
+
+/**
+ * Adds the descriptors stored in the given memory buffer to the pool.
+ * Throws an EssentiaException if the buffer doesn't contain a valid file.
+ */
+void readPoolBinary(const char* data, size_t size, Pool& pool);
+
+/**
+ * Adds the descriptors stored in the given file to the pool. The file is
+ * memory-mapped when the platform allows it, instead of being read.
+ */
+void readPoolBinary(const std::string& filename, Pool& pool);
+
+} // namespace essentia
+
+#endif // ESSENTIA_POOLBINARY_H
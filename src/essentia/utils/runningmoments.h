@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_RUNNINGMOMENTS_H
+#define ESSENTIA_RUNNINGMOMENTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "types.h"
+
+namespace essentia {
+namespace util {
+
+/**
+ * Mean, variance, skewness and kurtosis of a sequence of values, computed in
+ * a single pass without storing the values. The central moments are updated
+ * with each new value using Welford's algorithm, extended to the 3rd and 4th
+ * moments (Terriberry), and are accumulated in double precision.
+ *
+ * The statistics are the population ones, as returned by the variance(),
+ * skewness() and kurtosis() functions of essentiamath.h, including their
+ * values for a constant sequence (0 for the skewness, -3 for the kurtosis).
+ */
+class RunningMoments {
+ public:
+  RunningMoments() { reset(); }
+
+  void reset() {
+    _n = 0;
+    _mean = _m2 = _m3 = _m4 = 0.0;
+  }
+
+  void add(double x) {
+    double n1 = (double)_n;
+    _n++;
+    double n = (double)_n;
+    double delta = x - _mean;
+    double deltaN = delta / n;
+    double deltaN2 = deltaN * deltaN;
+    double term1 = delta * deltaN * n1;
+
+    _mean += deltaN;
+    // the higher moments have to be updated first, as they use the old ones
+    _m4 += term1 * deltaN2 * (n*n - 3*n + 3) + 6 * deltaN2 * _m2 - 4 * deltaN * _m3;
+    _m3 += term1 * deltaN * (n - 2) - 3 * deltaN * _m2;
+    _m2 += term1;
+  }
+
+  /**
+   * Merges the moments of another sequence into these ones, as if all its
+   * values had been added here (Chan et al.).
+   */
+  void merge(const RunningMoments& other) {
+    if (other._n == 0) return;
+    if (_n == 0) {
+      *this = other;
+      return;
+    }
+
+    double na = (double)_n, nb = (double)other._n;
+    double n = na + nb;
+    double delta = other._mean - _mean;
+    double delta2 = delta * delta;
+    double delta3 = delta2 * delta;
+    double delta4 = delta2 * delta2;
+
+    double m2 = _m2 + other._m2 + delta2 * na * nb / n;
+    double m3 = _m3 + other._m3 + delta3 * na * nb * (na - nb) / (n*n)
+              + 3 * delta * (na * other._m2 - nb * _m2) / n;
+    double m4 = _m4 + other._m4 + delta4 * na * nb * (na*na - na*nb + nb*nb) / (n*n*n)
+              + 6 * delta2 * (na*na * other._m2 + nb*nb * _m2) / (n*n)
+              + 4 * delta * (na * other._m3 - nb * _m3) / n;
+
+    _mean = (na * _mean + nb * other._mean) / n;
+    _m2 = m2;
+    _m3 = m3;
+    _m4 = m4;
+    _n += other._n;
+  }
+
+  size_t count() const { return _n; }
+
+  double mean() const { return _mean; }
+
+  double variance() const { return _n > 0 ? _m2 / _n : 0.0; }
+
+  double skewness() const {
+    if (_m2 == 0.0) return 0.0;
+    return std::sqrt((double)_n) * _m3 / std::pow(_m2, 1.5);
+  }
+
+  double kurtosis() const {
+    if (_m2 == 0.0) return -3.0;
+    return (double)_n * _m4 / (_m2 * _m2) - 3.0;
+  }
+
+ protected:
+  size_t _n;
+  double _mean, _m2, _m3, _m4;
+};
+
+/**
+ * Mean and covariance matrix of a sequence of frames of the same size,
+ * computed in a single pass without storing the frames. The co-moments are
+ * updated with each new frame (the multivariate version of Welford's
+ * algorithm), which only needs the lower triangle of the matrix.
+ *
+ * The covariance is the unbiased one (divided by n-1), as estimated by the
+ * SingleGaussian algorithm.
+ */
+class RunningCovariance {
+ public:
+  RunningCovariance(int size = 0) { setSize(size); }
+
+  void setSize(int size) {
+    _size = size;
+    _mean.resize(size);
+    _delta.resize(size);
+    _comoments.resize(size*(size+1)/2);
+    reset();
+  }
+
+  int size() const { return _size; }
+
+  void reset() {
+    _n = 0;
+    std::fill(_mean.begin(), _mean.end(), 0.0);
+    std::fill(_comoments.begin(), _comoments.end(), 0.0);
+  }
+
+  size_t count() const { return _n; }
+
+  void add(const Real* x) {
+    _n++;
+    for (int i=0; i<_size; i++) {
+      _delta[i] = x[i] - _mean[i];
+      _mean[i] += _delta[i] / _n;
+    }
+    // C += (x - old mean) (x - new mean)^T, row by row in the lower triangle
+    double* c = _comoments.data();
+    for (int i=0; i<_size; i++) {
+      for (int j=0; j<=i; j++) {
+        *c++ += _delta[i] * (x[j] - _mean[j]);
+      }
+    }
+  }
+
+  double mean(int i) const { return _mean[i]; }
+
+  double covariance(int i, int j) const {
+    if (i < j) std::swap(i, j);
+    return _n > 1 ? _comoments[i*(i+1)/2 + j] / (_n - 1) : 0.0;
+  }
+
+ protected:
+  int _size;
+  size_t _n;
+  ::essentia::VectorEx<double> _mean;
+  ::essentia::VectorEx<double> _delta;
+  ::essentia::VectorEx<double> _comoments;
+};
+
+} // namespace util
+} // namespace essentia
+
+#endif // ESSENTIA_RUNNINGMOMENTS_H
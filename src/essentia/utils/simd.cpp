@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include "simd.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define ESSENTIA_HAVE_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+// the AVX2 kernels are compiled with function-level target attributes, so that
+// the library doesn't have to be built with -mavx2 and still runs on older CPUs
+#if ESSENTIA_HAVE_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ESSENTIA_HAVE_AVX2 1
+#  include <immintrin.h>
+#  define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+using namespace std;
+
+namespace essentia {
+namespace simd {
+
+namespace {
+
+struct Kernels {
+  void (*multiply)(const Real*, const Real*, Real*, int);
+  void (*square)(const Real*, Real*, int);
+  void (*magnitude)(const complex<Real>*, Real*, int);
+  void (*power)(const complex<Real>*, Real*, int);
+  Real (*dot)(const Real*, const Real*, int);
+};
+
+
+// scalar versions, also used for the remaining elements of the vector ones
+
+void multiplyScalar(const Real* a, const Real* b, Real* out, int n) {
+  for (int i=0; i<n; i++) out[i] = a[i] * b[i];
+}
+
+void squareScalar(const Real* a, Real* out, int n) {
+  for (int i=0; i<n; i++) out[i] = a[i] * a[i];
+}
+
+void magnitudeScalar(const complex<Real>* in, Real* out, int n) {
+  for (int i=0; i<n; i++) {
+    out[i] = sqrt(in[i].real()*in[i].real() + in[i].imag()*in[i].imag());
+  }
+}
+
+void powerScalar(const complex<Real>* in, Real* out, int n) {
+  for (int i=0; i<n; i++) {
+    out[i] = in[i].real()*in[i].real() + in[i].imag()*in[i].imag();
+  }
+}
+
+Real dotScalar(const Real* a, const Real* b, int n) {
+  Real result = 0;
+  for (int i=0; i<n; i++) result += a[i] * b[i];
+  return result;
+}
+
+const Kernels scalarKernels = {
+  multiplyScalar, squareScalar, magnitudeScalar, powerScalar, dotScalar
+};
+
+
+#if ESSENTIA_HAVE_SSE2
+
+void multiplySSE2(const Real* a, const Real* b, Real* out, int n) {
+  int i = 0;
+  for (; i+4<=n; i+=4) {
+    _mm_storeu_ps(out+i, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
+  }
+  multiplyScalar(a+i, b+i, out+i, n-i);
+}
+
+void squareSSE2(const Real* a, Real* out, int n) {
+  int i = 0;
+  for (; i+4<=n; i+=4) {
+    __m128 x = _mm_loadu_ps(a+i);
+    _mm_storeu_ps(out+i, _mm_mul_ps(x, x));
+  }
+  squareScalar(a+i, out+i, n-i);
+}
+
+// squared modulus of the 4 complex numbers starting at in
+inline __m128 power4SSE2(const complex<Real>* in) {
+  const float* p = reinterpret_cast<const float*>(in);
+  __m128 x = _mm_loadu_ps(p);   // re0 im0 re1 im1
+  __m128 y = _mm_loadu_ps(p+4); // re2 im2 re3 im3
+  x = _mm_mul_ps(x, x);
+  y = _mm_mul_ps(y, y);
+  return _mm_add_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)),
+                    _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+void magnitudeSSE2(const complex<Real>* in, Real* out, int n) {
+  int i = 0;
+  for (; i+4<=n; i+=4) _mm_storeu_ps(out+i, _mm_sqrt_ps(power4SSE2(in+i)));
+  magnitudeScalar(in+i, out+i, n-i);
+}
+
+void powerSSE2(const complex<Real>* in, Real* out, int n) {
+  int i = 0;
+  for (; i+4<=n; i+=4) _mm_storeu_ps(out+i, power4SSE2(in+i));
+  powerScalar(in+i, out+i, n-i);
+}
+
+Real dotSSE2(const Real* a, const Real* b, int n) {
+  __m128 sum = _mm_setzero_ps();
+  int i = 0;
+  for (; i+4<=n; i+=4) {
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, sum);
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) + dotScalar(a+i, b+i, n-i);
+}
+
+const Kernels sse2Kernels = {
+  multiplySSE2, squareSSE2, magnitudeSSE2, powerSSE2, dotSSE2
+};
+
+#endif // ESSENTIA_HAVE_SSE2
+
+
+#if ESSENTIA_HAVE_AVX2
+
+AVX2_TARGET void multiplyAVX2(const Real* a, const Real* b, Real* out, int n) {
+  int i = 0;
+  for (; i+8<=n; i+=8) {
+    _mm256_storeu_ps(out+i, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
+  }
+  multiplySSE2(a+i, b+i, out+i, n-i);
+}
+
+AVX2_TARGET void squareAVX2(const Real* a, Real* out, int n) {
+  int i = 0;
+  for (; i+8<=n; i+=8) {
+    __m256 x = _mm256_loadu_ps(a+i);
+    _mm256_storeu_ps(out+i, _mm256_mul_ps(x, x));
+  }
+  squareSSE2(a+i, out+i, n-i);
+}
+
+// squared modulus of the 8 complex numbers starting at in
+AVX2_TARGET inline __m256 power8AVX2(const complex<Real>* in) {
+  const float* p = reinterpret_cast<const float*>(in);
+  __m256 x = _mm256_loadu_ps(p);   // c0 c1 | c2 c3
+  __m256 y = _mm256_loadu_ps(p+8); // c4 c5 | c6 c7
+  x = _mm256_mul_ps(x, x);
+  y = _mm256_mul_ps(y, y);
+  // shuffles work within 128-bit lanes, this gives c0 c1 c4 c5 | c2 c3 c6 c7...
+  __m256 sum = _mm256_add_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)),
+                             _mm256_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+  // ...which needs to be put back in order
+  return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+AVX2_TARGET void magnitudeAVX2(const complex<Real>* in, Real* out, int n) {
+  int i = 0;
+  for (; i+8<=n; i+=8) _mm256_storeu_ps(out+i, _mm256_sqrt_ps(power8AVX2(in+i)));
+  magnitudeSSE2(in+i, out+i, n-i);
+}
+
+AVX2_TARGET void powerAVX2(const complex<Real>* in, Real* out, int n) {
+  int i = 0;
+  for (; i+8<=n; i+=8) _mm256_storeu_ps(out+i, power8AVX2(in+i));
+  powerSSE2(in+i, out+i, n-i);
+}
+
+AVX2_TARGET Real dotAVX2(const Real* a, const Real* b, int n) {
+  __m256 sum = _mm256_setzero_ps();
+  int i = 0;
+  for (; i+8<=n; i+=8) {
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
+  }
+  __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  float partial[4];
+  _mm_storeu_ps(partial, sum4);
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) + dotScalar(a+i, b+i, n-i);
+}
+
+const Kernels avx2Kernels = {
+  multiplyAVX2, squareAVX2, magnitudeAVX2, powerAVX2, dotAVX2
+};
+
+#endif // ESSENTIA_HAVE_AVX2
+
+
+Level detectLevel() {
+#if ESSENTIA_HAVE_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return AVX2;
+#endif
+#if ESSENTIA_HAVE_SSE2
+  return SSE2;
+#else
+  return SCALAR;
+#endif
+}
+
+const Kernels& kernelsForLevel(Level level) {
+  switch (level) {
+#if ESSENTIA_HAVE_AVX2
+    case AVX2: return avx2Kernels;
+#endif
+#if ESSENTIA_HAVE_SSE2
+    case SSE2: return sse2Kernels;
+#endif
+    default: return scalarKernels;
+  }
+}
+
+Level& currentLevel() {
+  static Level level = supportedLevel();
+  return level;
+}
+
+const Kernels*& currentKernels() {
+  static const Kernels* kernels = &kernelsForLevel(currentLevel());
+  return kernels;
+}
+
+} // namespace
+
+
+Level supportedLevel() {
+  static const Level level = detectLevel();
+  return level;
+}
+
+Level level() {
+  return currentLevel();
+}
+
+void setLevel(Level level) {
+  if (level > supportedLevel()) level = supportedLevel();
+  currentLevel() = level;
+  currentKernels() = &kernelsForLevel(level);
+}
+
+const char* levelName(Level level) {
+  switch (level) {
+    case AVX2: return "avx2";
+    case SSE2: return "sse2";
+    default: return "scalar";
+  }
+}
+
+void multiply(const Real* a, const Real* b, Real* out, int n) {
+  currentKernels()->multiply(a, b, out, n);
+}
+
+void square(const Real* a, Real* out, int n) {
+  currentKernels()->square(a, out, n);
+}
+
+void magnitude(const complex<Real>* in, Real* out, int n) {
+  currentKernels()->magnitude(in, out, n);
+}
+
+void power(const complex<Real>* in, Real* out, int n) {
+  currentKernels()->power(in, out, n);
+}
+
+Real dot(const Real* a, const Real* b, int n) {
+  return currentKernels()->dot(a, b, n);
+}
+
+} // namespace simd
+} // namespace essentia
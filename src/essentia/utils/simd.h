@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SIMD_H
+#define ESSENTIA_SIMD_H
+
+#include <complex>
+#include "../types.h"
+
+namespace essentia {
+namespace simd {
+
+/**
+ * Vectorized kernels for the inner loops of the spectral front-end
+ * (windowing, magnitude/power spectrum, filterbanks and DCT).
+ *
+ * The implementation is chosen at runtime, the first time a kernel is called,
+ * as the best one supported by the CPU: AVX2, SSE2 or plain C++. The scalar
+ * version gives the exact same results as the loops it replaces. The vector
+ * ones sum in a different order in dot(), so its results can differ in the
+ * last bits.
+ */
+enum Level {
+  SCALAR = 0,
+  SSE2 = 1,
+  AVX2 = 2
+};
+
+/**
+ * Returns the best level supported by the CPU and the compiler.
+ */
+ESSENTIA_API Level supportedLevel();
+
+/**
+ * Returns the level currently in use.
+ */
+ESSENTIA_API Level level();
+
+/**
+ * Forces the kernels to use a lower level than the supported one, for testing
+ * or benchmarking (higher levels are clamped to the supported one). This is
+ * not thread-safe and should only be called while no algorithm is running.
+ */
+ESSENTIA_API void setLevel(Level level);
+
+ESSENTIA_API const char* levelName(Level level);
+
+/**
+ * out[i] = a[i] * b[i]. out may be the same array as a or b.
+ */
+ESSENTIA_API void multiply(const Real* a, const Real* b, Real* out, int n);
+
+/**
+ * out[i] = a[i] * a[i]. out may be the same array as a.
+ */
+ESSENTIA_API void square(const Real* a, Real* out, int n);
+
+/**
+ * out[i] = |in[i]|
+ */
+ESSENTIA_API void magnitude(const std::complex<Real>* in, Real* out, int n);
+
+/**
+ * out[i] = |in[i]|^2
+ */
+ESSENTIA_API void power(const std::complex<Real>* in, Real* out, int n);
+
+/**
+ * Returns the sum of a[i] * b[i].
+ */
+ESSENTIA_API Real dot(const Real* a, const Real* b, int n);
+
+} // namespace simd
+} // namespace essentia
+
+#endif // ESSENTIA_SIMD_H
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SLIDINGMEDIAN_H
+#define ESSENTIA_SLIDINGMEDIAN_H
+
+#include <set>
+#include "types.h"
+
+namespace essentia {
+namespace util {
+
+/**
+ * Median of the last @c size values pushed into it, for odd sizes. The values
+ * of the window are kept sorted in a multiset, along with an iterator to the
+ * middle one, so that sliding the window by one value costs O(log size)
+ * instead of the O(size log size) of sorting the whole window again.
+ */
+class SlidingMedian {
+ public:
+  SlidingMedian(int size = 1) { setSize(size); }
+
+  void setSize(int size) {
+    if (size < 1 || size % 2 != 1) {
+      throw EssentiaException("SlidingMedian: the window size has to be odd");
+    }
+    _size = size;
+    _history.resize(size);
+    reset();
+  }
+
+  int size() const { return _size; }
+
+  void reset() {
+    _values.clear();
+    _oldest = 0;
+  }
+
+  /**
+   * Whether @c size values have been pushed since the last reset, i.e. whether
+   * the median is defined.
+   */
+  bool full() const { return (int)_values.size() == _size; }
+
+  /**
+   * Adds a value to the window, removing the oldest one if it was full.
+   */
+  void push(Real value) {
+    if (!full()) {
+      _values.insert(value);
+      _history[_values.size()-1] = value;
+      if (full()) {
+        _mid = _values.begin();
+        std::advance(_mid, _size/2);
+      }
+      return;
+    }
+
+    Real oldest = _history[_oldest];
+    _history[_oldest] = value;
+    if (++_oldest == _size) _oldest = 0;
+
+    // equal values are inserted after the existing ones, so the middle only
+    // moves when the new value goes before it or the removed one is not after
+    // it. The removed value is found with lower_bound, which can't be the new
+    // middle then
+    _values.insert(value);
+    if (value < *_mid) --_mid;
+    if (oldest <= *_mid) ++_mid;
+    _values.erase(_values.lower_bound(oldest));
+  }
+
+  /**
+   * The median of the window, only valid when full().
+   */
+  Real median() const { return *_mid; }
+
+ protected:
+  int _size;
+  std::multiset<Real> _values;
+  std::multiset<Real>::const_iterator _mid;
+  ::essentia::VectorEx<Real> _history; // ring buffer of the values, in the order they were pushed
+  int _oldest;
+};
+
+} // namespace util
+} // namespace essentia
+
+#endif // ESSENTIA_SLIDINGMEDIAN_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_SPSCRING_H
+#define ESSENTIA_SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include "types.h"
+
+namespace essentia {
+namespace util {
+
+/**
+ * Lock-free ring of slots shared by one producer thread and one consumer
+ * thread. The slots are allocated once and reused, so that a producer can fill
+ * a slot in place (e.g. a buffer that keeps its capacity) without allocating
+ * in the steady state.
+ *
+ * The producer gets the next free slot with back(), fills it and publishes it
+ * with push(). The consumer gets the oldest published slot with front(), and
+ * gives it back to the producer with pop(). back() and front() return 0 when
+ * the ring is full or empty, respectively: waiting is left to the caller.
+ */
+template <typename T>
+class SPSCRing {
+ public:
+  SPSCRing(size_t capacity) : _slots(capacity + 1), _head(0), _tail(0) {}
+
+  size_t capacity() const { return _slots.size() - 1; }
+
+  // producer side
+
+  T* back() {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (next(tail) == _head.load(std::memory_order_acquire)) return 0;
+    return &_slots[tail];
+  }
+
+  void push() {
+    _tail.store(next(_tail.load(std::memory_order_relaxed)), std::memory_order_release);
+  }
+
+  // consumer side
+
+  T* front() {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire)) return 0;
+    return &_slots[head];
+  }
+
+  void pop() {
+    _head.store(next(_head.load(std::memory_order_relaxed)), std::memory_order_release);
+  }
+
+  /**
+   * Empties the ring. Neither the producer nor the consumer must be using it
+   * while this is called.
+   */
+  void clear() {
+    _head.store(0);
+    _tail.store(0);
+  }
+
+ protected:
+  size_t next(size_t i) const { return i+1 == _slots.size() ? 0 : i+1; }
+
+  ::essentia::VectorEx<T> _slots;
+
+  // head and tail are written by different threads, keep them on separate
+  // cache lines
+  std::atomic<size_t> _head; // next slot to be read
+  char _padding[64];
+  std::atomic<size_t> _tail; // next slot to be written
+};
+
+} // namespace util
+} // namespace essentia
+
+#endif // ESSENTIA_SPSCRING_H
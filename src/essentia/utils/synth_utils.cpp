@@ -123,7 +123,7 @@ void initializeFFT(::essentia::VectorEx<std::complex<Real> >&fft, int sizeFFT)
 
 
 // originally in class SineModelSynth::
-void genSpecSines(::essentia::VectorEx<Real> iploc, ::essentia::VectorEx<Real> ipmag, ::essentia::VectorEx<Real> ipphase, ::essentia::VectorEx<std::complex<Real> > &outfft, const int fftSize)
+void genSpecSines(const ::essentia::VectorEx<Real>& iploc, const ::essentia::VectorEx<Real>& ipmag, const ::essentia::VectorEx<Real>& ipphase, ::essentia::VectorEx<std::complex<Real> > &outfft, const int fftSize)
 {
 	int n_peaks = iploc.size(); // num of peaks
 
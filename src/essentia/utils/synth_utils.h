@@ -30,7 +30,7 @@ namespace essentia{
 void scaleAudioVector(::essentia::VectorEx<Real> &buffer, const Real scale);
 //void mixAudioVectors(const ::essentia::VectorEx<Real> ina, const ::essentia::VectorEx<Real> inb, const Real gaina, const Real gainb, ::essentia::VectorEx<Real> &out);
 void cleaningSineTracks(::essentia::VectorEx< ::essentia::VectorEx<Real> >&freqsTotal, const int minFrames);
-void genSpecSines(::essentia::VectorEx<Real> iploc, ::essentia::VectorEx<Real> ipmag, ::essentia::VectorEx<Real> ipphase, ::essentia::VectorEx<std::complex<Real> > &outfft, const int fftSize);
+void genSpecSines(const ::essentia::VectorEx<Real>& iploc, const ::essentia::VectorEx<Real>& ipmag, const ::essentia::VectorEx<Real>& ipphase, ::essentia::VectorEx<std::complex<Real> > &outfft, const int fftSize);
 void initializeFFT(::essentia::VectorEx<std::complex<Real> >&fft, int sizeFFT);
 
 } // namespace essentia
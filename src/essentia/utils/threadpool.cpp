@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "threadpool.h"
+using namespace std;
+
+namespace essentia {
+
+int ThreadPool::hardwareConcurrency() {
+  int n = (int)thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+ThreadPool::ThreadPool(int nThreads) : _running(0), _stop(false) {
+  if (nThreads <= 0) nThreads = hardwareConcurrency();
+
+  for (int i=0; i<nThreads; i++) {
+    _workers.push_back(new thread(&ThreadPool::workerLoop, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    unique_lock<mutex> lock(_mutex);
+    _stop = true;
+  }
+  _taskAvailable.notify_all();
+
+  for (int i=0; i<(int)_workers.size(); i++) {
+    _workers[i]->join();
+    delete _workers[i];
+  }
+}
+
+void ThreadPool::enqueue(const Task& task) {
+  {
+    unique_lock<mutex> lock(_mutex);
+    _tasks.push_back(task);
+  }
+  _taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  unique_lock<mutex> lock(_mutex);
+  _allDone.wait(lock, [this] { return _tasks.empty() && _running == 0; });
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    Task task;
+    {
+      unique_lock<mutex> lock(_mutex);
+      _taskAvailable.wait(lock, [this] { return _stop || !_tasks.empty(); });
+      if (_stop && _tasks.empty()) return;
+
+      task = _tasks.front();
+      _tasks.pop_front();
+      _running++;
+    }
+
+    // tasks are responsible for catching their own exceptions, the pool
+    // has no way of reporting them to the caller
+    task();
+
+    {
+      unique_lock<mutex> lock(_mutex);
+      _running--;
+      if (_tasks.empty() && _running == 0) _allDone.notify_all();
+    }
+  }
+}
+
+} // namespace essentia
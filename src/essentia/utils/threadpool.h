@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#ifndef ESSENTIA_THREADPOOL_H
+#define ESSENTIA_THREADPOOL_H
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+#include "types.h"
+
+namespace essentia {
+
+/**
+ * A ThreadPool is a fixed set of worker threads that execute the tasks that
+ * are queued into it in FIFO order.
+ *
+ * Tasks can enqueue other tasks themselves, which is what the parallel
+ * scheduler in the Network uses to dispatch the children of an algorithm
+ * as soon as all their parents have run. The wait() method blocks until the
+ * queue is empty and no task is currently running.
+ */
+class ESSENTIA_API ThreadPool {
+ public:
+  typedef std::function<void()> Task;
+
+  /**
+   * Creates a pool with the given number of worker threads. If @c nThreads
+   * is 0 or less, it uses the number of hardware threads of the machine.
+   */
+  ThreadPool(int nThreads = 0);
+  ~ThreadPool();
+
+  int size() const { return (int)_workers.size(); }
+
+  /**
+   * Queues a task for execution by one of the workers. This method is
+   * thread-safe and can be called from within a running task.
+   */
+  void enqueue(const Task& task);
+
+  /**
+   * Blocks until all queued tasks have been executed.
+   */
+  void wait();
+
+  /**
+   * Returns the number of hardware threads available, or 1 if it can't be
+   * determined.
+   */
+  static int hardwareConcurrency();
+
+ protected:
+  void workerLoop();
+
+  ::essentia::VectorEx<std::thread*> _workers;
+  std::deque<Task> _tasks;
+  int _running;
+  bool _stop;
+
+  std::mutex _mutex;
+  std::condition_variable _taskAvailable;
+  std::condition_variable _allDone;
+};
+
+} // namespace essentia
+
+#endif // ESSENTIA_THREADPOOL_H
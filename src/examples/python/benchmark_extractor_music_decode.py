@@ -0,0 +1,41 @@
+from __future__ import print_function
+from essentia.standard import MusicExtractor, EasyLoader
+from argparse import ArgumentParser
+import time
+
+
+# Measures the wall-clock time of MusicExtractor for an audio file when the
+# audio is decoded again for the second analysis pass (the default) and when
+# it is decoded only once and kept in memory (decodeOnce=True). The time to
+# decode the file once is given as a reference for the expected saving.
+
+def best_time(function, repetitions):
+    best = None
+    for _ in range(repetitions):
+        start = time.time()
+        function()
+        elapsed = time.time() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Benchmarks MusicExtractor with and without single-pass decoding")
+    parser.add_argument('audio_file', help='audio file to analyze')
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='number of runs per configuration (the fastest one is kept)')
+    args = parser.parse_args()
+
+    loader = EasyLoader(filename=args.audio_file, sampleRate=44100)
+    decode = best_time(loader, args.repetitions)
+
+    timings = []
+    for decode_once in [False, True]:
+        extractor = MusicExtractor(decodeOnce=decode_once)
+        timings.append(best_time(lambda: extractor(args.audio_file), args.repetitions))
+
+    print('%-24s %12.3f' % ('decode (s)', decode))
+    print('%-24s %12.3f' % ('decodeOnce=False (s)', timings[0]))
+    print('%-24s %12.3f' % ('decodeOnce=True (s)', timings[1]))
+    print('%-24s %12.3f' % ('saved (s)', timings[0] - timings[1]))
+    print('%-24s %12.2f' % ('speedup', timings[0] / timings[1]))
@@ -0,0 +1,48 @@
+from __future__ import print_function
+from essentia.standard import MusicExtractor, EasyLoader
+from argparse import ArgumentParser
+import time
+
+
+# Measures the wall-clock time of MusicExtractor for an audio file when the
+# audio is decoded by the loaders on the thread running the analysis network
+# (the default) and when it is decoded ahead on a separate thread
+# (decodeAhead=True), so that decoding overlaps with the analysis. The time to
+# decode the file is given as a reference: the saving per decoding pass cannot
+# exceed it. The same comparison can be made with streaming_extractor_music by
+# setting the 'decodeAhead' option in a profile.
+
+def best_time(function, repetitions):
+    best = None
+    for _ in range(repetitions):
+        start = time.time()
+        function()
+        elapsed = time.time() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Benchmarks MusicExtractor with and without decoding ahead on a separate thread")
+    parser.add_argument('audio_file', help='audio file to analyze')
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='number of runs per configuration (the fastest one is kept)')
+    parser.add_argument('--decode-once', action='store_true',
+                        help='decode the file only once in both configurations (see decodeOnce)')
+    args = parser.parse_args()
+
+    loader = EasyLoader(filename=args.audio_file, sampleRate=44100)
+    decode = best_time(loader, args.repetitions)
+
+    timings = []
+    for decode_ahead in [False, True]:
+        extractor = MusicExtractor(decodeAhead=decode_ahead, decodeOnce=args.decode_once)
+        timings.append(best_time(lambda: extractor(args.audio_file), args.repetitions))
+
+    passes = 1 if args.decode_once else 2
+    print('%-24s %12.3f' % ('decode (s)', decode))
+    print('%-24s %12.3f' % ('decodeAhead=False (s)', timings[0]))
+    print('%-24s %12.3f' % ('decodeAhead=True (s)', timings[1]))
+    print('%-24s %12.3f' % ('saved (s)', timings[0] - timings[1]))
+    print('%-24s %12.2f' % ('overlapped decoding (%)', 100. * (timings[0] - timings[1]) / (passes * decode)))
+    print('%-24s %12.2f' % ('speedup', timings[0] / timings[1]))
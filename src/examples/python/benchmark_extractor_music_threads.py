@@ -0,0 +1,36 @@
+from __future__ import print_function
+from essentia.standard import MusicExtractor
+from argparse import ArgumentParser
+import time
+
+
+# Measures the wall-clock time of MusicExtractor for an audio file when its
+# streaming networks are run with a different number of scheduler threads.
+
+def time_extraction(audio_file, threads, repetitions):
+    extractor = MusicExtractor(schedulerThreads=threads)
+    best = None
+    for _ in range(repetitions):
+        start = time.time()
+        extractor(audio_file)
+        elapsed = time.time() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Benchmarks MusicExtractor with a multi-threaded network scheduler")
+    parser.add_argument('audio_file', help='audio file to analyze')
+    parser.add_argument('-t', '--threads', nargs='+', type=int, default=[1, 2, 4, 8],
+                        help='numbers of scheduler threads to try')
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='number of runs per configuration (the fastest one is kept)')
+    args = parser.parse_args()
+
+    reference = None
+    print('%8s %12s %8s' % ('threads', 'time (s)', 'speedup'))
+    for threads in args.threads:
+        elapsed = time_extraction(args.audio_file, threads, args.repetitions)
+        if reference is None:
+            reference = elapsed
+        print('%8d %12.3f %8.2f' % (threads, elapsed, reference / elapsed))
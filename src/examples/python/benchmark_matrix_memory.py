@@ -0,0 +1,42 @@
+from __future__ import print_function
+from essentia.standard import CrossSimilarityMatrix
+from argparse import ArgumentParser
+import numpy as np
+import resource
+
+
+# Measures the peak memory used to return a large 2D output (a cross-similarity
+# matrix) from an essentia.standard algorithm. The rows of the C++ output are
+# copied into the returned numpy array, which is allocated at once, so the peak
+# is about two copies of the matrix. The rows are freed as they are copied,
+# though, so only the numpy array is left once the result is returned.
+#
+# The peak resident set size never decreases, so only one computation is done
+# per run of this script.
+
+def peak_rss_mb():
+    # ru_maxrss is in kilobytes on linux
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024.
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Measures the peak memory of returning a large matrix to python")
+    parser.add_argument('-n', '--frames', type=int, default=4000,
+                        help='number of frames of the query and reference features (the output is frames x frames)')
+    parser.add_argument('-d', '--dimension', type=int, default=12,
+                        help='dimension of the feature frames')
+    args = parser.parse_args()
+
+    rng = np.random.RandomState(0)
+    query = rng.uniform(0, 1, (args.frames, args.dimension)).astype(np.float32)
+    reference = rng.uniform(0, 1, (args.frames, args.dimension)).astype(np.float32)
+    csm = CrossSimilarityMatrix()
+
+    before = peak_rss_mb()
+    result = csm(query, reference)
+    after = peak_rss_mb()
+
+    output_mb = result.nbytes / 1024. / 1024.
+    print('output size:     %10.1f MB' % output_mb)
+    print('peak increase:   %10.1f MB' % (after - before))
+    print('copies at peak:  %10.2f' % ((after - before) / output_mb))
@@ -0,0 +1,61 @@
+from __future__ import print_function
+from essentia.standard import FrameGenerator, Windowing, Spectrum, MFCC
+from concurrent.futures import ThreadPoolExecutor
+from argparse import ArgumentParser
+import numpy as np
+import time
+
+
+# Measures the throughput of an essentia.standard MFCC extraction when running
+# it from several python threads at once. The GIL is released while algorithms
+# compute, so the throughput should scale with the number of threads as long as
+# the frames are large enough for the python overhead to be negligible.
+
+def extract_mfcc(audio, frame_size, hop_size):
+    # algorithm instances are not shared between threads
+    window = Windowing(type='hann')
+    spectrum = Spectrum()
+    mfcc = MFCC(inputSize=frame_size // 2 + 1)
+    n_frames = 0
+    for frame in FrameGenerator(audio, frameSize=frame_size, hopSize=hop_size):
+        mfcc(spectrum(window(frame)))
+        n_frames += 1
+    return n_frames
+
+
+def time_extraction(signals, threads, frame_size, hop_size, repetitions):
+    best = None
+    with ThreadPoolExecutor(max_workers=threads) as executor:
+        for _ in range(repetitions):
+            start = time.time()
+            n_frames = sum(executor.map(lambda audio: extract_mfcc(audio, frame_size, hop_size), signals))
+            elapsed = time.time() - start
+            best = elapsed if best is None else min(best, elapsed)
+    return best, n_frames
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Benchmarks essentia.standard MFCC extraction from several python threads")
+    parser.add_argument('-t', '--threads', nargs='+', type=int, default=[1, 2, 4, 8],
+                        help='numbers of python threads to try')
+    parser.add_argument('-n', '--signals', type=int, default=16,
+                        help='number of signals to analyze in each run')
+    parser.add_argument('-d', '--duration', type=float, default=30.,
+                        help='duration of each signal in seconds')
+    parser.add_argument('--frame-size', type=int, default=2048)
+    parser.add_argument('--hop-size', type=int, default=1024)
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='number of runs per configuration (the fastest one is kept)')
+    args = parser.parse_args()
+
+    rng = np.random.RandomState(0)
+    signals = [rng.uniform(-1, 1, int(args.duration * 44100)).astype(np.float32)
+               for _ in range(args.signals)]
+
+    reference = None
+    print('%8s %12s %12s %8s' % ('threads', 'time (s)', 'frames/s', 'speedup'))
+    for threads in args.threads:
+        elapsed, n_frames = time_extraction(signals, threads, args.frame_size, args.hop_size, args.repetitions)
+        if reference is None:
+            reference = elapsed
+        print('%8d %12.3f %12.0f %8.2f' % (threads, elapsed, n_frames / elapsed, reference / elapsed))
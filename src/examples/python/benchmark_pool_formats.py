@@ -0,0 +1,64 @@
+from __future__ import print_function
+from essentia import Pool, poolbinary
+from essentia.standard import YamlOutput, YamlInput, PoolBinaryOutput, PoolBinaryInput
+from argparse import ArgumentParser
+import numpy as np
+import tempfile
+import time
+import os
+
+
+# Compares the size of the files written by YamlOutput (in YAML and JSON) and
+# by PoolBinaryOutput for a pool of frame-level descriptors, and the time taken
+# to write and to load them. The binary file is loaded both into a Pool with
+# PoolBinaryInput and as memory-mapped numpy arrays with essentia.poolbinary.
+
+def make_pool(frames, dimension, descriptors):
+    rng = np.random.RandomState(0)
+    pool = Pool()
+    for d in range(descriptors):
+        name = 'lowlevel.descriptor%d' % d
+        for frame in rng.uniform(0, 1, (frames, dimension)).astype(np.float32):
+            pool.add(name, frame)
+        pool.set(name + '_mean', float(d))
+    return pool
+
+
+def timed(f):
+    start = time.time()
+    f()
+    return time.time() - start
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Compares the YAML, JSON and binary Pool file formats")
+    parser.add_argument('-n', '--frames', type=int, default=20000,
+                        help='number of frames of each descriptor')
+    parser.add_argument('-d', '--dimension', type=int, default=13,
+                        help='dimension of the frames')
+    parser.add_argument('-k', '--descriptors', type=int, default=4,
+                        help='number of frame-level descriptors')
+    args = parser.parse_args()
+
+    pool = make_pool(args.frames, args.dimension, args.descriptors)
+    tmpdir = tempfile.mkdtemp()
+
+    print('%-10s %12s %12s %12s' % ('format', 'size (MB)', 'write (s)', 'load (s)'))
+
+    for fmt in ('yaml', 'json'):
+        filename = os.path.join(tmpdir, 'pool.' + fmt)
+        write = timed(lambda: YamlOutput(filename=filename, format=fmt, writeVersion=False)(pool))
+        load = timed(lambda: YamlInput(filename=filename, format=fmt)())
+        print('%-10s %12.2f %12.3f %12.3f' % (fmt, os.path.getsize(filename) / 1e6, write, load))
+        os.remove(filename)
+
+    filename = os.path.join(tmpdir, 'pool.bin')
+    write = timed(lambda: PoolBinaryOutput(filename=filename)(pool))
+    load = timed(lambda: PoolBinaryInput(filename=filename)())
+    mapped = timed(lambda: [np.sum(v) for v in poolbinary.load(filename).values()
+                            if isinstance(v, np.ndarray)])
+    size = os.path.getsize(filename) / 1e6
+    print('%-10s %12.2f %12.3f %12.3f' % ('binary', size, write, load))
+    print('%-10s %12.2f %12s %12.3f' % ('mmap', size, '-', mapped))
+    os.remove(filename)
+    os.rmdir(tmpdir)
@@ -0,0 +1,68 @@
+from __future__ import print_function
+from essentia.standard import EasyLoader, MonoLoader, MonoWriter
+from argparse import ArgumentParser
+import numpy as np
+import tempfile
+import time
+import os
+
+
+# Measures the time EasyLoader takes to load a segment of a long audio file, at
+# several positions in the file, compared to loading the whole file. As the
+# loaders seek close to the segment before decoding, the time should depend on
+# the length of the segment and not on its position nor on the length of the
+# file.
+#
+# Without an audio file, a file of the given duration is synthesized first.
+
+def best_time(function, repetitions):
+    best = None
+    for _ in range(repetitions):
+        start = time.time()
+        function()
+        elapsed = time.time() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def synthesize(filename, fmt, minutes):
+    rng = np.random.RandomState(0)
+    t = np.arange(int(minutes * 60 * 44100)) / 44100.
+    audio = 0.3 * np.sin(2 * np.pi * 440 * t) + 0.05 * rng.uniform(-1, 1, len(t))
+    MonoWriter(filename=filename, format=fmt)(audio.astype(np.float32))
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Benchmarks loading a segment of a long audio file")
+    parser.add_argument('audio_file', nargs='?', help='audio file to load (synthesized if not given)')
+    parser.add_argument('-m', '--minutes', type=float, default=20,
+                        help='duration of the synthesized file [min]')
+    parser.add_argument('-f', '--format', default='mp3', choices=['wav', 'flac', 'ogg', 'mp3'],
+                        help='format of the synthesized file')
+    parser.add_argument('-s', '--segment', type=float, default=30,
+                        help='duration of the loaded segment [s]')
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='number of runs per configuration (the fastest one is kept)')
+    args = parser.parse_args()
+
+    filename = args.audio_file
+    if filename is None:
+        filename = os.path.join(tempfile.mkdtemp(), 'long.' + args.format)
+        synthesize(filename, args.format, args.minutes)
+
+    audio = MonoLoader(filename=filename)()
+    duration = len(audio) / 44100.
+    full = best_time(EasyLoader(filename=filename), args.repetitions)
+
+    print('file duration: %.1f s, segment duration: %.1f s' % (duration, args.segment))
+    print('%-20s %12s %12s' % ('segment start (s)', 'time (s)', 'full / time'))
+    for position in [0, 0.25, 0.5, 0.9]:
+        start = position * max(duration - args.segment, 0)
+        loader = EasyLoader(filename=filename, startTime=start, endTime=start + args.segment)
+        elapsed = best_time(loader, args.repetitions)
+        print('%-20.1f %12.3f %12.1f' % (start, elapsed, full / elapsed))
+    print('%-20s %12.3f %12.1f' % ('whole file', full, 1.))
+
+    if args.audio_file is None:
+        os.remove(filename)
+        os.rmdir(os.path.dirname(filename))
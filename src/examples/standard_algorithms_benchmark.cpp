@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <essentia/algorithmfactory.h>
+#include <essentia/pool.h>
+#include <essentia/utils/allocationcounter.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+// Benchmarks of the most used algorithms, created with the AlgorithmFactory
+// and run on a synthetic signal (tones changing every beat at 120 BPM, a
+// click on each beat and some noise), or on an audio file for MusicExtractor.
+//
+// Each algorithm is called once to warm it up, then repeatedly for at least
+// the given time. The time per call (ns/op), the number of frames processed
+// per second and the number of memory allocations per call are printed as a
+// table, and can be written as JSON to track regressions. Frame-wise
+// algorithms process 1 frame per call, algorithms taking the whole signal
+// process as many frames as fit in it with a hop size of 512.
+
+struct Result {
+  string name;
+  string parameters;
+  uint64_t iterations;
+  double nsPerOp;
+  double framesPerOp;
+  double allocationsPerOp;
+  double bytesPerOp;
+};
+
+double minTime = 0.5;
+const int sampleRate = 44100;
+const int hopSize = 512;
+
+Result measure(const string& name, const string& parameters, double framesPerOp,
+               const function<void()>& op) {
+  op(); // warm-up
+
+  AllocationCount before = allocationCount();
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  double elapsed = 0;
+  uint64_t iterations = 0;
+
+  // run in batches of increasing size so that reading the clock does not
+  // weigh on the fastest algorithms
+  for (uint64_t batch=1; elapsed < minTime; batch*=2) {
+    for (uint64_t i=0; i<batch; i++) op();
+    iterations += batch;
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+  AllocationCount allocated = allocationCount() - before;
+
+  Result result;
+  result.name = name;
+  result.parameters = parameters;
+  result.iterations = iterations;
+  result.nsPerOp = elapsed * 1e9 / iterations;
+  result.framesPerOp = framesPerOp;
+  result.allocationsPerOp = (double)allocated.allocations / iterations;
+  result.bytesPerOp = (double)allocated.bytes / iterations;
+  return result;
+}
+
+void printResult(ostream& out, const Result& r) {
+  out << left << setw(26) << r.name << setw(30) << r.parameters << right
+      << setw(14) << fixed << setprecision(0) << r.nsPerOp
+      << setw(14) << setprecision(1) << r.framesPerOp * 1e9 / r.nsPerOp
+      << setw(12) << setprecision(2) << r.allocationsPerOp
+      << setw(14) << setprecision(0) << r.bytesPerOp << endl;
+}
+
+string jsonEscape(const string& str) {
+  string result;
+  for (int i=0; i<(int)str.size(); i++) {
+    if (str[i] == '"' || str[i] == '\\') result += '\\';
+    result += str[i];
+  }
+  return result;
+}
+
+void writeJson(ostream& out, const ::essentia::VectorEx<Result>& results) {
+  out << "{\n"
+      << "  \"essentia_version\": \"" << essentia::version << "\",\n"
+      << "  \"git_sha\": \"" << essentia::version_git_sha << "\",\n"
+      << "  \"min_time\": " << minTime << ",\n"
+      << "  \"benchmarks\": [";
+  for (int i=0; i<(int)results.size(); i++) {
+    const Result& r = results[i];
+    out << (i ? ",\n" : "\n") << fixed << setprecision(3)
+        << "    {\"name\": \"" << r.name << "\", \"parameters\": \"" << jsonEscape(r.parameters) << "\""
+        << ", \"iterations\": " << r.iterations
+        << ", \"ns_per_op\": " << r.nsPerOp
+        << ", \"frames_per_op\": " << r.framesPerOp
+        << ", \"frames_per_second\": " << r.framesPerOp * 1e9 / r.nsPerOp
+        << ", \"allocations_per_op\": " << r.allocationsPerOp
+        << ", \"bytes_per_op\": " << r.bytesPerOp << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+::essentia::VectorEx<Real> syntheticSignal(Real duration) {
+  ::essentia::VectorEx<Real> signal((size_t)(duration * sampleRate));
+  Real f0[] = { 220, 261.63, 329.63, 392, 293.66, 349.23, 246.94, 196 };
+  int beat = sampleRate / 2;
+  srand(0);
+  for (int i=0; i<(int)signal.size(); i++) {
+    Real f = f0[(i / beat) % 8];
+    Real t = (Real)i / sampleRate;
+    Real x = 0;
+    for (int h=1; h<=4; h++) x += 0.2 / h * sin(2 * M_PI * h * f * t);
+    int sinceBeat = i % beat;
+    if (sinceBeat < 2000) x += 0.5 * exp(-sinceBeat / 300.) * sin(2 * M_PI * 60 * t);
+    x += 0.01 * ((Real)rand() / RAND_MAX - 0.5);
+    signal[i] = x;
+  }
+  return signal;
+}
+
+void usage(const char* program) {
+  cout << "Usage: " << program << " [options]" << endl
+       << "  -t seconds   minimum time spent on each benchmark (default: 0.5)" << endl
+       << "  -d seconds   duration of the synthetic signal (default: 30)" << endl
+       << "  -f filter    only run the benchmarks whose name contains filter" << endl
+       << "  -a file      audio file to run MusicExtractor on (skipped otherwise)" << endl
+       << "  -o file      write the results as JSON to file ('-' for the standard output)" << endl;
+  exit(1);
+}
+
+int main(int argc, char* argv[]) {
+  Real duration = 30;
+  string filter, audioFile, jsonFile;
+
+  for (int i=1; i<argc; i++) {
+    string arg = argv[i];
+    if (i+1 == argc) usage(argv[0]);
+    if (arg == "-t") minTime = atof(argv[++i]);
+    else if (arg == "-d") duration = atof(argv[++i]);
+    else if (arg == "-f") filter = argv[++i];
+    else if (arg == "-a") audioFile = argv[++i];
+    else if (arg == "-o") jsonFile = argv[++i];
+    else usage(argv[0]);
+  }
+
+  essentia::init();
+
+  ::essentia::VectorEx<Result> results;
+  // the table goes to the error output when the JSON goes to the standard one
+  ostream& table = (jsonFile == "-") ? cerr : cout;
+  table << left << setw(26) << "algorithm" << setw(30) << "parameters" << right
+        << setw(14) << "ns/op" << setw(14) << "frames/s" << setw(12) << "allocs/op"
+        << setw(14) << "bytes/op" << endl;
+
+  function<void(const string&, const string&, double, const function<void()>&)> run =
+    [&](const string& name, const string& parameters, double framesPerOp, const function<void()>& op) {
+      if (name.find(filter) == string::npos) return;
+      results.push_back(measure(name, parameters, framesPerOp, op));
+      printResult(table, results.back());
+    };
+
+  AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+
+  ::essentia::VectorEx<Real> signal = syntheticSignal(duration);
+  double signalFrames = (double)signal.size() / hopSize;
+  int frameSize = 2048;
+  int spectrumSize = frameSize/2 + 1;
+
+  // a frame of the signal and its spectrum, used as input by the algorithms
+  // which work on frames
+  ::essentia::VectorEx<Real> frame(signal.begin() + 10*frameSize, signal.begin() + 11*frameSize);
+  ::essentia::VectorEx<Real> windowedFrame, spectrum;
+  Algorithm* window = factory.create("Windowing", "type", "hann");
+  Algorithm* spec   = factory.create("Spectrum", "size", frameSize);
+  window->input("frame").set(frame);
+  window->output("frame").set(windowedFrame);
+  spec->input("frame").set(windowedFrame);
+  spec->output("spectrum").set(spectrum);
+  window->compute();
+  spec->compute();
+
+  /////////// FRAMES ////////////////
+  {
+    ::essentia::VectorEx<Real> cut;
+    Algorithm* fc = factory.create("FrameCutter", "frameSize", frameSize, "hopSize", hopSize);
+    fc->input("signal").set(signal);
+    fc->output("frame").set(cut);
+    run("FrameCutter", "frameSize=2048 hopSize=512", 1, [&]() {
+      fc->compute();
+      if (cut.empty()) fc->reset();
+    });
+    delete fc;
+  }
+
+  run("Windowing", "type=hann size=2048", 1, [&]() { window->compute(); });
+
+  /////////// SPECTRUM / FFT ////////////////
+  int sizes[] = { 512, 1024, 2048, 4096 };
+  for (int s=0; s<4; s++) {
+    int size = sizes[s];
+    ::essentia::VectorEx<Real> input(signal.begin(), signal.begin() + size), magnitude;
+    ::essentia::VectorEx<complex<Real> > fftOutput;
+    string parameters = "size=" + (Stringifier() << size).str();
+
+    Algorithm* sp = factory.create("Spectrum", "size", size);
+    sp->input("frame").set(input);
+    sp->output("spectrum").set(magnitude);
+    run("Spectrum", parameters, 1, [&]() { sp->compute(); });
+    delete sp;
+
+    Algorithm* fft = factory.create("FFT", "size", size);
+    fft->input("frame").set(input);
+    fft->output("fft").set(fftOutput);
+    run("FFT", parameters, 1, [&]() { fft->compute(); });
+    delete fft;
+  }
+
+  /////////// SPECTRAL DESCRIPTORS ////////////////
+  {
+    ::essentia::VectorEx<Real> bands, mfccBands, mfccCoeffs;
+    Algorithm* mel = factory.create("MelBands", "sampleRate", sampleRate, "inputSize", spectrumSize);
+    mel->input("spectrum").set(spectrum);
+    mel->output("bands").set(bands);
+    run("MelBands", "numberBands=24 inputSize=1025", 1, [&]() { mel->compute(); });
+    delete mel;
+
+    Algorithm* mfcc = factory.create("MFCC", "sampleRate", sampleRate, "inputSize", spectrumSize);
+    mfcc->input("spectrum").set(spectrum);
+    mfcc->output("bands").set(mfccBands);
+    mfcc->output("mfcc").set(mfccCoeffs);
+    run("MFCC", "inputSize=1025", 1, [&]() { mfcc->compute(); });
+    delete mfcc;
+  }
+
+  {
+    ::essentia::VectorEx<Real> frequencies, magnitudes, hpcp;
+    Algorithm* peaks = factory.create("SpectralPeaks", "sampleRate", sampleRate);
+    peaks->input("spectrum").set(spectrum);
+    peaks->output("frequencies").set(frequencies);
+    peaks->output("magnitudes").set(magnitudes);
+    run("SpectralPeaks", "inputSize=1025", 1, [&]() { peaks->compute(); });
+
+    peaks->compute();
+    Algorithm* chroma = factory.create("HPCP", "sampleRate", sampleRate);
+    chroma->input("frequencies").set(frequencies);
+    chroma->input("magnitudes").set(magnitudes);
+    chroma->output("hpcp").set(hpcp);
+    string parameters = "size=12 peaks=" + (Stringifier() << frequencies.size()).str();
+    run("HPCP", parameters, 1, [&]() { chroma->compute(); });
+    delete chroma;
+    delete peaks;
+  }
+
+  {
+    Real pitch, confidence;
+    Algorithm* yin = factory.create("PitchYinFFT", "frameSize", frameSize, "sampleRate", sampleRate);
+    yin->input("spectrum").set(spectrum);
+    yin->output("pitch").set(pitch);
+    yin->output("pitchConfidence").set(confidence);
+    run("PitchYinFFT", "frameSize=2048", 1, [&]() { yin->compute(); });
+    delete yin;
+  }
+
+  /////////// ONSETS / RHYTHM ////////////////
+  {
+    ::essentia::VectorEx<complex<Real> > fftOutput;
+    ::essentia::VectorEx<Real> magnitude, phase;
+    Algorithm* fft = factory.create("FFT", "size", frameSize);
+    Algorithm* c2p = factory.create("CartesianToPolar");
+    fft->input("frame").set(windowedFrame);
+    fft->output("fft").set(fftOutput);
+    c2p->input("complex").set(fftOutput);
+    c2p->output("magnitude").set(magnitude);
+    c2p->output("phase").set(phase);
+    fft->compute();
+    c2p->compute();
+
+    const char* methods[] = { "hfc", "complex" };
+    for (int m=0; m<2; m++) {
+      Real onset;
+      Algorithm* od = factory.create("OnsetDetection", "method", methods[m], "sampleRate", sampleRate);
+      od->input("spectrum").set(magnitude);
+      od->input("phase").set(phase);
+      od->output("onsetDetection").set(onset);
+      run("OnsetDetection", string("method=") + methods[m], 1, [&]() { od->compute(); });
+      delete od;
+    }
+    delete c2p;
+    delete fft;
+  }
+
+  {
+    ::essentia::VectorEx<Real> ticks;
+    Real confidence;
+    Algorithm* beats = factory.create("BeatTrackerMultiFeature");
+    beats->input("signal").set(signal);
+    beats->output("ticks").set(ticks);
+    beats->output("confidence").set(confidence);
+    string parameters = "signal=" + (Stringifier() << duration).str() + "s";
+    run("BeatTrackerMultiFeature", parameters, signalFrames, [&]() { beats->compute(); });
+    delete beats;
+  }
+
+  /////////// EXTRACTOR ////////////////
+  if (!audioFile.empty()) {
+    ::essentia::VectorEx<string> algorithms = factory.keys();
+    if (find(algorithms.begin(), algorithms.end(), "MusicExtractor") == algorithms.end()) {
+      cerr << "MusicExtractor is not available in this build, skipping it" << endl;
+    }
+    else {
+      Pool stats, frames;
+      Algorithm* extractor = factory.create("MusicExtractor");
+      extractor->input("filename").set(audioFile);
+      extractor->output("results").set(stats);
+      extractor->output("resultsFrames").set(frames);
+      extractor->compute();
+
+      double fileFrames = stats.value<Real>("metadata.audio_properties.length") * sampleRate / hopSize;
+      run("MusicExtractor", audioFile, fileFrames, [&]() {
+        stats.clear();
+        frames.clear();
+        extractor->compute();
+      });
+      delete extractor;
+    }
+  }
+
+  delete spec;
+  delete window;
+
+  if (!jsonFile.empty()) {
+    if (jsonFile == "-") {
+      writeJson(cout, results);
+    }
+    else {
+      ofstream out(jsonFile.c_str());
+      writeJson(out, results);
+      if (!out.good()) {
+        cerr << "Error: could not write " << jsonFile << endl;
+        exit(1);
+      }
+    }
+  }
+
+  essentia::shutdown();
+
+  return 0;
+}
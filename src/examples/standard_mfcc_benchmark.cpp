@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <essentia/algorithmfactory.h>
+#include <essentia/utils/simd.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+// Measures the number of frames per second of the MFCC chain
+// (FrameCutter -> Windowing -> Spectrum -> MFCC) on a synthetic signal, for
+// each of the SIMD levels supported by the machine.
+
+int main(int argc, char* argv[]) {
+
+  if (argc > 2) {
+    cout << "Error: incorrect number of arguments." << endl;
+    cout << "Usage: " << argv[0] << " [seconds of audio]" << endl;
+    exit(1);
+  }
+  Real duration = (argc == 2) ? atof(argv[1]) : 60;
+
+  essentia::init();
+
+  int sampleRate = 44100;
+  int frameSize = 2048;
+  int hopSize = 512;
+
+  ::essentia::VectorEx<Real> audio((size_t)(duration * sampleRate));
+  for (int i=0; i<(int)audio.size(); i++) {
+    audio[i] = 0.5 * sin(2 * M_PI * 440 * i / sampleRate) + 0.1 * ((Real)rand() / RAND_MAX - 0.5);
+  }
+
+  AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+
+  Algorithm* fc   = factory.create("FrameCutter",
+                                   "frameSize", frameSize,
+                                   "hopSize", hopSize);
+  Algorithm* w    = factory.create("Windowing", "type", "hann");
+  Algorithm* spec = factory.create("Spectrum");
+  Algorithm* mfcc = factory.create("MFCC");
+
+  ::essentia::VectorEx<Real> frame, windowedFrame, spectrum, mfccBands, mfccCoeffs;
+
+  fc->input("signal").set(audio);
+  fc->output("frame").set(frame);
+  w->input("frame").set(frame);
+  w->output("frame").set(windowedFrame);
+  spec->input("frame").set(windowedFrame);
+  spec->output("spectrum").set(spectrum);
+  mfcc->input("spectrum").set(spectrum);
+  mfcc->output("bands").set(mfccBands);
+  mfcc->output("mfcc").set(mfccCoeffs);
+
+  cout << left << setw(10) << "level" << right << setw(14) << "frames/s" << setw(12) << "speedup" << endl;
+
+  double reference = 0;
+  for (int level=simd::SCALAR; level<=simd::supportedLevel(); level++) {
+    simd::setLevel((simd::Level)level);
+    fc->reset();
+
+    int nFrames = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (true) {
+      fc->compute();
+      if (!frame.size()) break;
+      w->compute();
+      spec->compute();
+      mfcc->compute();
+      nFrames++;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double framesPerSecond = nFrames / elapsed;
+    if (level == simd::SCALAR) reference = framesPerSecond;
+    cout << left << setw(10) << simd::levelName((simd::Level)level) << right
+         << setw(14) << fixed << setprecision(0) << framesPerSecond
+         << setw(12) << setprecision(2) << framesPerSecond / reference << endl;
+  }
+
+  delete fc;
+  delete w;
+  delete spec;
+  delete mfcc;
+
+  essentia::shutdown();
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <sys/resource.h>
+#include <essentia/algorithmfactory.h>
+#include <essentia/pool.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+// Measures the memory used by a Pool holding the frame-wise descriptors of a
+// track (10 minutes by default) and the time PoolAggregator takes to compute
+// their statistics, with or without the columnar storage of the frames (see
+// Pool::setColumnarStorage()). The peak memory of a process never decreases,
+// so run it once for each mode to compare them.
+
+long peakMemoryKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss; // in kilobytes on linux
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 2 || argc > 3 || (strcmp(argv[1], "rows") && strcmp(argv[1], "columnar"))) {
+    cout << "Error: incorrect arguments." << endl;
+    cout << "Usage: " << argv[0] << " rows|columnar [minutes of audio]" << endl;
+    exit(1);
+  }
+  bool columnar = strcmp(argv[1], "columnar") == 0;
+  Real duration = (argc == 3) ? atof(argv[2]) * 60 : 600;
+
+  essentia::init();
+
+  // descriptors of the same sizes as the frame-wise ones of MusicExtractor
+  const char* names[] = { "lowlevel.mfcc", "lowlevel.gfcc", "lowlevel.melbands",
+                          "lowlevel.erbbands", "lowlevel.barkbands", "tonal.hpcp",
+                          "lowlevel.spectral_contrast", "lowlevel.spectral_valleys" };
+  int sizes[] = { 13, 13, 40, 40, 27, 36, 6, 6 };
+
+  int sampleRate = 44100;
+  int hopSize = 512;
+  int nFrames = int(duration * sampleRate / hopSize);
+
+  long memoryBefore = peakMemoryKb();
+
+  Pool pool;
+  pool.setColumnarStorage(columnar);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int i=0; i<nFrames; i++) {
+    for (int j=0; j<(int)ARRAY_SIZE(names); j++) {
+      ::essentia::VectorEx<Real> frame(sizes[j]);
+      for (int k=0; k<sizes[j]; k++) frame[k] = (Real)rand() / RAND_MAX;
+      pool.add(names[j], frame);
+    }
+  }
+  double fillTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  long memoryFilled = peakMemoryKb();
+
+  Algorithm* aggregator = AlgorithmFactory::create("PoolAggregator",
+                                                   "defaultStats", ::essentia::VectorEx<string>{"mean", "var", "min", "max", "median", "dmean", "dvar"});
+  Pool stats;
+  aggregator->input("input").set(pool);
+  aggregator->output("output").set(stats);
+
+  start = chrono::steady_clock::now();
+  aggregator->compute();
+  double aggregationTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << "storage:           " << (columnar ? "columnar" : "rows") << endl;
+  cout << "frames:            " << nFrames << " x " << ARRAY_SIZE(names) << " descriptors" << endl;
+  cout << "pool memory:       " << (memoryFilled - memoryBefore) / 1024. << " MB" << endl;
+  cout << fixed << setprecision(3);
+  cout << "fill time:         " << fillTime << " s" << endl;
+  cout << "aggregation time:  " << aggregationTime << " s" << endl;
+
+  delete aggregator;
+  essentia::shutdown();
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <essentia/algorithmfactory.h>
+#include <essentia/roguevector.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+// Micro-benchmarks of the element access of VectorEx (owned and as a view,
+// as used by RogueVector) compared to std::vector, and of some common
+// algorithms whose inner loops go through VectorEx. Run it on two builds to
+// compare them, the times are given in nanoseconds per call.
+
+int nIterations = 10000;
+
+void report(const string& name, const function<void()>& f) {
+  f(); // warm-up
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int i=0; i<nIterations; i++) f();
+  double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  cout << left << setw(32) << name << right << setw(14) << fixed << setprecision(1)
+       << elapsed / nIterations << " ns/op" << endl;
+}
+
+template <typename VectorType>
+void benchmarkAccess(const string& name, VectorType& v) {
+  volatile Real sink;
+
+  report(name + " operator[] sum", [&]() {
+    Real sum = 0;
+    for (int i=0; i<(int)v.size(); i++) sum += v[i];
+    sink = sum;
+  });
+
+  report(name + " iterator sum", [&]() {
+    Real sum = 0;
+    for (typename VectorType::iterator it=v.begin(); it!=v.end(); ++it) sum += *it;
+    sink = sum;
+  });
+
+  report(name + " operator[] scale", [&]() {
+    for (int i=0; i<(int)v.size(); i++) v[i] *= 0.999f;
+  });
+  (void)sink;
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc > 2) {
+    cout << "Error: incorrect number of arguments." << endl;
+    cout << "Usage: " << argv[0] << " [iterations]" << endl;
+    exit(1);
+  }
+  if (argc == 2) nIterations = atoi(argv[1]);
+
+  essentia::init();
+
+  int frameSize = 2048;
+  int sampleRate = 44100;
+
+  ::essentia::VectorEx<Real> frame(frameSize);
+  for (int i=0; i<frameSize; i++) {
+    frame[i] = sin(2 * M_PI * 440 * i / sampleRate) + 0.5 * sin(2 * M_PI * 1250 * i / sampleRate);
+  }
+
+  /////////// ELEMENT ACCESS ////////////////
+  std::vector<Real> stdVector(frame.begin(), frame.end());
+  ::essentia::VectorEx<Real> owned(frame.begin(), frame.end());
+  std::vector<Real> viewData(frame.begin(), frame.end());
+  RogueVector<Real> view(&viewData[0], viewData.size());
+
+  benchmarkAccess("std::vector", stdVector);
+  benchmarkAccess("VectorEx", owned);
+  benchmarkAccess("RogueVector", view);
+
+  /////////// ALGORITHMS ////////////////
+  AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+
+  Algorithm* w     = factory.create("Windowing", "type", "hann");
+  Algorithm* spec  = factory.create("Spectrum", "size", frameSize);
+  Algorithm* bands = factory.create("TriangularBands", "sampleRate", sampleRate,
+                                    "inputSize", frameSize/2 + 1);
+  Algorithm* mel   = factory.create("MelBands", "sampleRate", sampleRate,
+                                    "inputSize", frameSize/2 + 1);
+  Algorithm* mfcc  = factory.create("MFCC", "sampleRate", sampleRate,
+                                    "inputSize", frameSize/2 + 1);
+  Algorithm* peaks = factory.create("SpectralPeaks", "sampleRate", sampleRate);
+  Algorithm* hpcp  = factory.create("HPCP", "sampleRate", sampleRate);
+
+  ::essentia::VectorEx<Real> windowedFrame, spectrum, triBands, melBands, mfccBands, mfccCoeffs;
+  ::essentia::VectorEx<Real> frequencies, magnitudes, chroma;
+
+  w->input("frame").set(frame);
+  w->output("frame").set(windowedFrame);
+  spec->input("frame").set(windowedFrame);
+  spec->output("spectrum").set(spectrum);
+  bands->input("spectrum").set(spectrum);
+  bands->output("bands").set(triBands);
+  mel->input("spectrum").set(spectrum);
+  mel->output("bands").set(melBands);
+  mfcc->input("spectrum").set(spectrum);
+  mfcc->output("bands").set(mfccBands);
+  mfcc->output("mfcc").set(mfccCoeffs);
+  peaks->input("spectrum").set(spectrum);
+  peaks->output("frequencies").set(frequencies);
+  peaks->output("magnitudes").set(magnitudes);
+  hpcp->input("frequencies").set(frequencies);
+  hpcp->input("magnitudes").set(magnitudes);
+  hpcp->output("hpcp").set(chroma);
+
+  // compute everything once so that each algorithm gets valid inputs
+  w->compute();
+  spec->compute();
+  peaks->compute();
+
+  report("Windowing", [&]() { w->compute(); });
+  report("Spectrum", [&]() { spec->compute(); });
+  report("TriangularBands", [&]() { bands->compute(); });
+  report("MelBands", [&]() { mel->compute(); });
+  report("MFCC", [&]() { mfcc->compute(); });
+  report("SpectralPeaks", [&]() { peaks->compute(); });
+  report("HPCP", [&]() { hpcp->compute(); });
+
+  delete w;
+  delete spec;
+  delete bands;
+  delete mel;
+  delete mfcc;
+  delete peaks;
+  delete hpcp;
+
+  essentia::shutdown();
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <essentia/essentia.h>
+#include <essentia/streaming/source.h>
+#include <essentia/streaming/sink.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+
+// Throughput of the buffers between streaming algorithms: a source writes
+// nTokens Real tokens, in chunks of the given size, which are read by
+// nReaders sinks. With the PhantomBuffer, everything runs on the calling
+// thread, as in a network run by a single thread. With the SPMCPhantomBuffer,
+// the writer and each reader run on their own thread. The throughput is given
+// in millions of tokens written per second.
+
+int nTokens = 1 << 24;
+
+// writes and reads chunk tokens at a time, on the calling thread
+void runSerial(Source<Real>& source, vector<Sink<Real>*>& sinks, int chunk) {
+  Real value = 0;
+  for (int written=0; written<nTokens; written+=chunk) {
+    if (!source.acquire(chunk)) {
+      throw EssentiaException("the buffer is full while all the tokens have been read");
+    }
+    ::essentia::VectorEx<Real>& tokens = source.tokens();
+    for (int i=0; i<chunk; i++) tokens[i] = value++;
+    source.release(chunk);
+
+    for (int r=0; r<(int)sinks.size(); r++) {
+      sinks[r]->acquire(chunk);
+      sinks[r]->release(chunk);
+    }
+  }
+}
+
+// writes on the calling thread, reads on one thread per sink
+void runThreaded(Source<Real>& source, vector<Sink<Real>*>& sinks, int chunk) {
+  vector<thread> readers;
+  vector<Real> sums(sinks.size());
+  for (int r=0; r<(int)sinks.size(); r++) {
+    readers.push_back(thread([&, r]() {
+      Real sum = 0;
+      for (int read=0; read<nTokens; read+=chunk) {
+        sinks[r]->acquire(chunk);
+        const ::essentia::VectorEx<Real>& tokens = sinks[r]->tokens();
+        sum += tokens[0] + tokens[chunk-1];
+        sinks[r]->release(chunk);
+      }
+      sums[r] = sum;
+    }));
+  }
+
+  Real value = 0;
+  for (int written=0; written<nTokens; written+=chunk) {
+    source.acquire(chunk);
+    ::essentia::VectorEx<Real>& tokens = source.tokens();
+    for (int i=0; i<chunk; i++) tokens[i] = value++;
+    source.release(chunk);
+  }
+
+  for (int r=0; r<(int)readers.size(); r++) readers[r].join();
+}
+
+void report(const string& name, int nReaders, int chunk, bool concurrent) {
+  Source<Real> source("source");
+  source.setBufferType(BufferUsage::forAudioStream);
+  vector<Sink<Real>*> sinks;
+  for (int r=0; r<nReaders; r++) {
+    sinks.push_back(new Sink<Real>("sink"));
+    connect(source, *sinks.back());
+  }
+  // wait forever, as each side knows how many tokens to expect
+  if (concurrent) source.setConcurrentBuffer(true, -1);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  if (concurrent) runThreaded(source, sinks, chunk);
+  else runSerial(source, sinks, chunk);
+  double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << left << setw(32) << name << right << setw(8) << nReaders << setw(8) << chunk
+       << setw(14) << fixed << setprecision(1) << nTokens / elapsed * 1e-6 << " Mtokens/s" << endl;
+
+  for (int r=0; r<nReaders; r++) {
+    disconnect(source, *sinks[r]);
+    delete sinks[r];
+  }
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc > 2) {
+    cout << "Error: incorrect number of arguments." << endl;
+    cout << "Usage: " << argv[0] << " [log2 of the number of tokens]" << endl;
+    exit(1);
+  }
+  if (argc == 2) nTokens = 1 << atoi(argv[1]);
+
+  essentia::init();
+
+  cout << left << setw(32) << "buffer" << right << setw(8) << "readers" << setw(8) << "chunk"
+       << setw(14) << "throughput" << endl;
+
+  int chunks[] = { 1, 64, 1024 };
+  int readers[] = { 1, 3 };
+  for (int c=0; c<3; c++) {
+    for (int r=0; r<2; r++) {
+      report("PhantomBuffer (1 thread)", readers[r], chunks[c], false);
+      report("SPMCPhantomBuffer (threads)", readers[r], chunks[c], true);
+    }
+  }
+
+  essentia::shutdown();
+
+  return 0;
+}
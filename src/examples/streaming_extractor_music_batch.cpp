@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <fstream>
+#include <cstdlib>
+#include <essentia/essentia.h>
+#include <essentia/algorithm.h>
+#include <essentia/algorithmfactory.h>
+#include <essentia/utils/batchextractor.h>
+#include <essentia/utils/extractor_music/extractor_version.h>
+#include "music_extractor/extractor_utils.h"
+
+#include "credit_libav.h"
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+
+void usage(char *progname) {
+    cout << "Error: wrong number of arguments" << endl;
+    cout << "Usage: " << progname << " input_filelist output_dir [profile] [threads]" << endl;
+    cout << endl << "input_filelist is a text file with one audio file path per line. The results" << endl
+         << "for each audio file are written into output_dir, under the name of the audio" << endl
+         << "file with the extension of the output format." << endl;
+    cout << endl << "Music extractor version '" << MUSIC_EXTRACTOR_VERSION << "'" << endl
+         << "built with Essentia version " << essentia::version_git_sha << endl;
+    creditLibAV();
+
+    exit(1);
+}
+
+
+string outputPath(const string& audioFilename, const string& outputDir, Pool& options) {
+  string basename = audioFilename.substr(audioFilename.find_last_of("/\\") + 1);
+  return outputDir + "/" + basename + "." + options.value<string>("outputFormat");
+}
+
+
+int main(int argc, char* argv[]) {
+  string listFilename, outputDir, profileFilename;
+  int threads = 0;
+
+  switch (argc) {
+    case 5:
+      threads = atoi(argv[4]);
+    case 4:
+      profileFilename = argv[3];
+    case 3:
+      listFilename = argv[1];
+      outputDir = argv[2];
+      break;
+    default:
+      usage(argv[0]);
+  }
+
+  try {
+    essentia::init();
+
+    Pool options;
+    setExtractorDefaultOptions(options);
+    setExtractorOptions(profileFilename, options);
+
+    ::essentia::VectorEx<string> audioFilenames;
+    ifstream list(listFilename.c_str());
+    if (!list) {
+      throw EssentiaException("Could not open file list: ", listFilename);
+    }
+    string line;
+    while (getline(list, line)) {
+      if (!line.empty()) audioFilenames.push_back(line);
+    }
+
+    ParameterMap parameters;
+    parameters.add("profile", profileFilename);
+    BatchExtractor extractor("MusicExtractor", parameters, threads);
+
+    cerr << "Processing " << audioFilenames.size() << " files using "
+         << extractor.numThreads() << " threads" << endl;
+
+    extractor.process(audioFilenames, [&](const BatchExtractor::Result& result) {
+      if (!result.ok) {
+        cerr << "Error processing " << result.filename << ": " << result.error << endl;
+        return;
+      }
+
+      Pool results = result.results;
+      mergeValues(results, options);
+
+      string outputFilename = outputPath(result.filename, outputDir, options);
+      outputToFile(results, outputFilename, options);
+      if (options.value<Real>("outputFrames")) {
+        Pool resultsFrames = result.resultsFrames;
+        outputToFile(resultsFrames, outputFilename+"_frames", options);
+      }
+    });
+
+    cerr << "Processed " << extractor.processedFiles() << " files ("
+         << extractor.failedFiles() << " failed) in " << extractor.elapsedTime() << "s: "
+         << extractor.throughput() << " files/s" << endl;
+
+    essentia::shutdown();
+  }
+  catch (EssentiaException& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  catch (const std::bad_alloc& e) {
+    cerr << "bad_alloc exception: Out of memory " << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
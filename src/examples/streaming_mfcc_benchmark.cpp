@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <essentia/algorithmfactory.h>
+#include <essentia/streaming/algorithms/vectorinput.h>
+#include <essentia/streaming/algorithms/poolstorage.h>
+#include <essentia/streaming/streamingalgorithmwrapper.h>
+#include <essentia/scheduler/network.h>
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+using namespace essentia::scheduler;
+
+// Measures the number of frames per second of the streaming MFCC chain
+// (FrameCutter -> Windowing -> Spectrum -> MFCC) on a synthetic signal, for
+// several batch sizes of the frame-based algorithms (see
+// StreamingAlgorithmWrapper::setBatchSize()).
+
+int main(int argc, char* argv[]) {
+
+  if (argc > 2) {
+    cout << "Error: incorrect number of arguments." << endl;
+    cout << "Usage: " << argv[0] << " [seconds of audio]" << endl;
+    exit(1);
+  }
+  Real duration = (argc == 2) ? atof(argv[1]) : 60;
+
+  essentia::init();
+
+  int sampleRate = 44100;
+  int frameSize = 2048;
+  int hopSize = 512;
+
+  ::essentia::VectorEx<Real> audio((size_t)(duration * sampleRate));
+  for (int i=0; i<(int)audio.size(); i++) {
+    audio[i] = 0.5 * sin(2 * M_PI * 440 * i / sampleRate) + 0.1 * ((Real)rand() / RAND_MAX - 0.5);
+  }
+
+  AlgorithmFactory& factory = streaming::AlgorithmFactory::instance();
+
+  cout << left << setw(10) << "batch" << right << setw(14) << "frames/s" << setw(12) << "speedup" << endl;
+
+  double reference = 0;
+  int batchSizes[] = { 1, 4, 16, 64 };
+  for (int i=0; i<(int)ARRAY_SIZE(batchSizes); i++) {
+    Pool pool;
+
+    // feed the audio one hop at a time, rather than the default of one
+    // sample per generator step
+    VectorInput<Real>* input = new VectorInput<Real>(&audio);
+    input->setAcquireSize(hopSize);
+
+    Algorithm* fc    = factory.create("FrameCutter",
+                                      "frameSize", frameSize,
+                                      "hopSize", hopSize);
+    Algorithm* w     = factory.create("Windowing", "type", "hann");
+    Algorithm* spec  = factory.create("Spectrum");
+    Algorithm* mfcc  = factory.create("MFCC");
+
+    input->output("data")        >> fc->input("signal");
+    fc->output("frame")          >> w->input("frame");
+    w->output("frame")           >> spec->input("frame");
+    spec->output("spectrum")     >> mfcc->input("spectrum");
+    mfcc->output("bands")        >> NOWHERE;
+    mfcc->output("mfcc")         >> PC(pool, "mfcc");
+
+    Algorithm* wrapped[] = { w, spec, mfcc };
+    for (int j=0; j<(int)ARRAY_SIZE(wrapped); j++) {
+      dynamic_cast<StreamingAlgorithmWrapper*>(wrapped[j])->setBatchSize(batchSizes[i]);
+    }
+
+    Network network(input);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    network.run();
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int nFrames = (int)pool.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("mfcc").size();
+    double framesPerSecond = nFrames / elapsed;
+    if (i == 0) reference = framesPerSecond;
+    cout << left << setw(10) << batchSizes[i] << right
+         << setw(14) << fixed << setprecision(0) << framesPerSecond
+         << setw(12) << setprecision(2) << framesPerSecond / reference << endl;
+  }
+
+  essentia::shutdown();
+
+  return 0;
+}
@@ -305,7 +305,11 @@ def convertData(data, goalType):
         return array(data)
 
     if goalType == Edt.VECTOR_VECTOR_REAL:
-        if origType == Edt.MATRIX_REAL or origType == Edt.LIST_LIST_INTEGER:
+        # 2D arrays are copied row by row in C++, without going through python floats
+        if origType == Edt.MATRIX_REAL:
+            return data
+
+        if origType == Edt.LIST_LIST_INTEGER:
             return [[float(col) for col in row] for row in data]
 
         if origType == Edt.LIST_LIST_REAL or origType == Edt.LIST_LIST_EMPTY or Edt.LIST_ARRAY_REAL:
@@ -0,0 +1,177 @@
+# Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+#
+# This file is part of Essentia
+#
+# Essentia is free software: you can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the Free
+# Software Foundation (FSF), either version 3 of the License, or (at your
+# option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the Affero GNU General Public License
+# version 3 along with this program. If not, see http://www.gnu.org/licenses/
+
+"""Memory-mapped reader of the binary Pool files written by the
+PoolBinaryOutput algorithm (see src/essentia/utils/poolbinary.h for their
+layout).
+
+The arrays of Reals are returned as read-only numpy arrays that point
+directly into the mapped file, so that loading a file doesn't copy its
+frames, which are only read from the disk when they are accessed. Use
+essentia.standard.PoolBinaryInput instead to load a file into a Pool.
+"""
+
+import mmap as _mmap
+import struct as _struct
+import numpy as _np
+
+MAGIC = b'ESSPOOL\0'
+VERSION = 1
+
+(SINGLE_REAL, REAL, SINGLE_VECTOR_REAL, VECTOR_REAL, SINGLE_STRING, STRING,
+ SINGLE_VECTOR_STRING, VECTOR_STRING, ARRAY2D_REAL, STEREO_SAMPLE,
+ SINGLE_TENSOR_REAL, TENSOR_REAL) = range(1, 13)
+
+TENSOR_RANK = 4
+
+
+class _Reader:
+    def __init__(self, buf):
+        self.buf = buf
+        self.pos = 0
+        # byte order of the file, for struct and numpy
+        self.prefix = None
+        self.dtype = None
+
+    def _check(self, size):
+        if size < 0 or self.pos + size > len(self.buf):
+            raise ValueError('unexpected end of data, the file is truncated or corrupted')
+
+    def bytes(self, size):
+        self._check(size)
+        result = self.buf[self.pos:self.pos + size]
+        self.pos += size
+        return result
+
+    def unpack(self, fmt):
+        size = _struct.calcsize(fmt)
+        self._check(size)
+        result = _struct.unpack_from(self.prefix + fmt, self.buf, self.pos)
+        self.pos += size
+        return result
+
+    def u64(self):
+        return self.unpack('Q')[0]
+
+    def reals(self, count):
+        self._check(4 * count)
+        result = _np.frombuffer(self.buf, dtype=self.dtype, count=count, offset=self.pos)
+        self.pos += 4 * count
+        return result
+
+    def string(self):
+        return self.bytes(self.u64()).decode('utf-8')
+
+    def strings(self):
+        return [self.string() for _ in range(self.u64())]
+
+    def pad(self):
+        if self.pos % 8:
+            self.bytes(8 - self.pos % 8)
+
+    def tensor(self):
+        dims = self.unpack('%dQ' % TENSOR_RANK)
+        result = self.reals(int(_np.prod(dims))).reshape(dims)
+        self.pad()
+        return result
+
+
+def _read(r):
+    if r.bytes(len(MAGIC)) != MAGIC:
+        raise ValueError('not a binary pool file')
+
+    # the byte order mark tells in which order all the numbers are written
+    header = r.bytes(8)
+    for prefix in ('<', '>'):
+        version, mark = _struct.unpack(prefix + 'II', header)
+        if mark == 0x01020304:
+            break
+    else:
+        raise ValueError('invalid byte order mark, the file is corrupted')
+    if version != VERSION:
+        raise ValueError('unsupported version of the format: %d' % version)
+    r.prefix = prefix
+    r.dtype = _np.dtype(prefix + 'f4')
+
+    pool = {}
+    for _ in range(r.u64()):
+        dtype, nameSize = r.unpack('II')
+        name = r.bytes(nameSize).decode('utf-8')
+        r.pad()
+
+        if dtype == SINGLE_REAL:
+            value = float(r.reals(1)[0])
+
+        elif dtype in (REAL, SINGLE_VECTOR_REAL):
+            value = r.reals(r.u64())
+
+        elif dtype == VECTOR_REAL:
+            n = r.u64()
+            sizes = r.unpack('%dQ' % n)
+            if n and all(s == sizes[0] for s in sizes):
+                # rectangular frames are returned as a single 2D array
+                value = r.reals(n * sizes[0]).reshape(n, sizes[0])
+            else:
+                value = [r.reals(s) for s in sizes]
+
+        elif dtype == SINGLE_STRING:
+            value = r.string()
+
+        elif dtype in (STRING, SINGLE_VECTOR_STRING):
+            value = r.strings()
+
+        elif dtype == VECTOR_STRING:
+            value = [r.strings() for _ in range(r.u64())]
+
+        elif dtype == ARRAY2D_REAL:
+            value = []
+            for _ in range(r.u64()):
+                dim1, dim2 = r.unpack('QQ')
+                value.append(r.reals(dim1 * dim2).reshape(dim1, dim2))
+                r.pad()
+
+        elif dtype == STEREO_SAMPLE:
+            value = r.reals(2 * r.u64()).reshape(-1, 2)
+
+        elif dtype == SINGLE_TENSOR_REAL:
+            value = r.tensor()
+
+        elif dtype == TENSOR_REAL:
+            value = [r.tensor() for _ in range(r.u64())]
+
+        else:
+            raise ValueError('unknown type of descriptor for "%s": %d' % (name, dtype))
+
+        r.pad()
+        pool[name] = value
+
+    return pool
+
+
+def load(filename):
+    """Returns a dictionary mapping the descriptor names of a binary Pool file
+    to their values. The arrays of Reals are read-only numpy arrays mapping the
+    file (vectors of Reals with frames of the same size are a single 2D array,
+    stereo samples are an array of shape (n, 2))."""
+    with open(filename, 'rb') as f:
+        buf = _mmap.mmap(f.fileno(), 0, access=_mmap.ACCESS_READ)
+    return _read(_Reader(buf))
+
+
+def loads(data):
+    """Same as load(), for the content of a file that is already in memory."""
+    return _read(_Reader(data))
@@ -21,7 +21,7 @@ import essentia
 from . import common as _c
 import sys as _sys
 from ._essentia import keys as algorithmNames, info as algorithmInfo
-from copy import copy
+import numpy as _np
 
 # given an essentia algorithm name, create the corresponding class
 def _create_essentia_class(name, moduleName = __name__):
@@ -50,7 +50,7 @@ def _create_essentia_class(name, moduleName = __name__):
 
                 if type(val).__module__ == 'numpy':
                     if not val.flags['C_CONTIGUOUS']:
-                        val = copy(val)
+                        val = _np.ascontiguousarray(val)
 
                 try:
                     convertedVal = _c.convertData(val, goalType)
@@ -88,8 +88,10 @@ def _create_essentia_class(name, moduleName = __name__):
                         essentia.INFO('Warning: essentia can currently only accept numpy arrays of dtype '
                                       '"single". "%s" dtype is double. Precision will be automatically '
                                       'truncated into "single".' %(inputNames[i]))
-                    if not args[i].flags['C_CONTIGUOUS']:
-                        arg = copy(args[i])
+                    # the C++ side reads the data of numpy arrays as C-ordered
+                    # rows, views with other strides are copied first
+                    if not arg.flags['C_CONTIGUOUS']:
+                        arg = _np.ascontiguousarray(arg)
 
                 goalType = _c.Edt(self.inputType(inputNames[i]))
 
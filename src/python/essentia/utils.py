@@ -79,6 +79,12 @@ def normalize(array):
 def derivative(array):
     return _essentia.derivative(_c.convertData(array, _c.Edt.VECTOR_REAL))
 
+def audioCacheStatistics():
+    return _essentia.audioCacheStatistics()
+
+def resetAudioCacheStatistics():
+    return _essentia.resetAudioCacheStatistics()
+
 __all__ = [ 'isSilent', 'instantPower',
             'nextPowerTwo', 'isPowerTwo',
             'lin2db', 'db2lin',
@@ -88,4 +94,5 @@ __all__ = [ 'isSilent', 'instantPower',
             'mel2hz', 'hz2mel',
             'postProcessTicks',
             'normalize', 'derivative',
-            'equivalentKey', 'lin2log']
+            'equivalentKey', 'lin2log',
+            'audioCacheStatistics', 'resetAudioCacheStatistics']
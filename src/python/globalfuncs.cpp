@@ -22,6 +22,7 @@
 #include "poolstorage.h" // connecting pools
 #include "../algorithms/io/fileoutputproxy.h" // connecting FileOutput algorithm
 #include "bpmutil.h" // postProcessTicks()
+#include "audiocache.h" // audioCacheStatistics()
 
 static PyObject*
 get_version() {
@@ -685,11 +686,24 @@ static PyObject* run(PyObject* notUsed, PyObject* obj) {
 
   PyStreamingAlgorithm* pyAlg = reinterpret_cast<PyStreamingAlgorithm*>(obj);
 
+  // release the GIL while the network is running, so that other python threads
+  // can run their own networks concurrently. The python objects referenced by
+  // this network (input arrays, pools) are kept alive by the caller
+  bool failed = false;
+  string error;
+
+  Py_BEGIN_ALLOW_THREADS
   try {
     scheduler::Network(pyAlg->algo, false).run();
   }
   catch (const exception& e) {
-    PyErr_SetString(PyExc_RuntimeError, e.what());
+    failed = true;
+    error = e.what();
+  }
+  Py_END_ALLOW_THREADS
+
+  if (failed) {
+    PyErr_SetString(PyExc_RuntimeError, error.c_str());
     return NULL;
   }
 
@@ -975,6 +989,28 @@ postProcessTicks(PyObject* self, PyObject* args) {
 }
 
 
+static PyObject*
+audio_cache_statistics() {
+  AudioCacheStatistics stats = audioCacheStatistics();
+
+  const char* names[] = { "hits", "misses", "bytesRead", "bytesWritten" };
+  uint64_t values[] = { stats.hits, stats.misses, stats.bytesRead, stats.bytesWritten };
+
+  PyObject* result = PyDict_New();
+  for (int i=0; i<4; i++) {
+    PyObject* value = PyLong_FromUnsignedLongLong(values[i]);
+    PyDict_SetItemString(result, names[i], value);
+    Py_DECREF(value);
+  }
+  return result;
+}
+
+static PyObject*
+reset_audio_cache_statistics() {
+  resetAudioCacheStatistics();
+  Py_RETURN_NONE;
+}
+
 
 static PyMethodDef Essentia__Methods[] = {
   { "debugLevel",      (PyCFunction)debug_level,       METH_NOARGS,  "return the activated debugging modules." },
@@ -1029,5 +1065,7 @@ static PyMethodDef Essentia__Methods[] = {
   { "version_git_sha",      (PyCFunction)get_version_git_sha, METH_NOARGS, "returns essentia's version git commit SHA hash" }, 
   { "almostEqualArray", (PyCFunction)almostEqualArray,   METH_VARARGS, "Returns true if two numpy arrays are within a given precision of each other" },
   { "postProcessTicks", (PyCFunction)postProcessTicks,   METH_VARARGS, "Purges ticks array based on ticks amplitude and the preferred period" },
+  { "audioCacheStatistics", (PyCFunction)audio_cache_statistics, METH_NOARGS, "returns the hits and misses of the decoded audio cache of the loaders" },
+  { "resetAudioCacheStatistics", (PyCFunction)reset_audio_cache_statistics, METH_NOARGS, "resets the statistics of the decoded audio cache of the loaders" },
   { NULL } // Sentinel
 };
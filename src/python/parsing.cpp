@@ -141,6 +141,8 @@ PyObject* buildReturnValue(const ::essentia::VectorEx<PyObject*>& result_vec) {
   return result;
 }
 
+// NB: the types converted with toPythonRef are handed over to python, so obj
+//     needs to be allocated on the heap and must not be deleted afterwards
 PyObject* toPython(void* obj, Edt tp) {
   switch (tp) {
     case REAL: return PyReal::toPythonCopy((Real*)obj);
@@ -153,11 +155,11 @@ PyObject* toPython(void* obj, Edt tp) {
     case VECTOR_COMPLEX: return VectorComplex::toPythonRef((RogueVector<complex<Real> >*)obj);
     case VECTOR_INTEGER: return VectorInteger::toPythonRef((RogueVector<int>*)obj);
     case VECTOR_STEREOSAMPLE: return VectorStereoSample::toPythonCopy((::essentia::VectorEx<StereoSample>*)obj);
-    case VECTOR_VECTOR_REAL: return VectorVectorReal::toPythonCopy((::essentia::VectorEx<::essentia::VectorEx<Real> >*)obj);
+    case VECTOR_VECTOR_REAL: return VectorVectorReal::toPythonRef((::essentia::VectorEx<::essentia::VectorEx<Real> >*)obj);
     case VECTOR_VECTOR_COMPLEX: return VectorVectorComplex::toPythonCopy((::essentia::VectorEx<::essentia::VectorEx<complex<Real> > >*)obj);
     case VECTOR_VECTOR_STRING: return VectorVectorString::toPythonCopy((::essentia::VectorEx<::essentia::VectorEx<string> >*)obj);
     case VECTOR_VECTOR_STEREOSAMPLE: return VectorVectorStereoSample::toPythonCopy((::essentia::VectorEx<::essentia::VectorEx<StereoSample> >*)obj);
-    case TENSOR_REAL: return TensorReal::toPythonCopy((Tensor<Real>*)obj);
+    case TENSOR_REAL: return TensorReal::toPythonRef((Tensor<Real>*)obj);
     case VECTOR_TENSOR_REAL: return VectorTensorReal::toPythonCopy((::essentia::VectorEx<Tensor<Real> >*)obj);
     case MATRIX_REAL: return MatrixReal::toPythonRef((TNT::Array2D<Real>*)obj);
     case VECTOR_MATRIX_REAL: return VectorMatrixReal::toPythonCopy((::essentia::VectorEx<TNT::Array2D<Real> >*)obj);
@@ -209,10 +211,11 @@ PyObject* paramToPython(const Parameter& p) {
       return toPython(r, paramTypeToEdt(pType));
     }
     PARAM_CASE(VECTOR_STEREOSAMPLE, ::essentia::VectorEx<StereoSample>, VectorStereoSample);
-    PARAM_CASE(VECTOR_VECTOR_REAL, ::essentia::VectorEx<::essentia::VectorEx<Real> >, VectorVectorReal);
+    // same as above, these are handed over to python by toPython
+    case Parameter::VECTOR_VECTOR_REAL: return toPython(new ::essentia::VectorEx<::essentia::VectorEx<Real> >(p.toVectorVectorReal()), VECTOR_VECTOR_REAL);
     PARAM_CASE(VECTOR_VECTOR_STRING, ::essentia::VectorEx<::essentia::VectorEx<string> >, VectorVectorString);
     PARAM_CASE(VECTOR_VECTOR_STEREOSAMPLE, ::essentia::VectorEx<::essentia::VectorEx<StereoSample> >, VectorVectorStereoSample);
-    PARAM_CASE(MATRIX_REAL, TNT::Array2D<Real>, MatrixReal);
+    case Parameter::MATRIX_REAL: return toPython(new TNT::Array2D<Real>(p.toMatrixReal()), MATRIX_REAL);
     PARAM_CASE(VECTOR_MATRIX_REAL, ::essentia::VectorEx<TNT::Array2D<Real> >, VectorMatrixReal);
     PARAM_CASE(MAP_VECTOR_REAL, mapvectorreal, MapVectorReal);
     PARAM_CASE(MAP_VECTOR_STRING, mapvectorstring, MapVectorString);
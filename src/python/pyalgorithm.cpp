@@ -34,7 +34,12 @@ using namespace standard;
 
 /**
  * The algorithm structure. Contains a pointer to the C++ algorithm, and a bool
- * indicating whether it has already been configured or not.
+ * indicating whether it is currently computing in another thread.
+ *
+ * The GIL is released while the C++ algorithm computes, so that different
+ * algorithm instances can be used concurrently from several python threads.
+ * An instance itself is not thread-safe though: using it from another thread
+ * while it is computing raises an exception instead of corrupting its state.
  */
 class PyAlgorithm {
 
@@ -42,6 +47,7 @@ class PyAlgorithm {
   PyObject_HEAD
 
   Algorithm* algo;
+  bool computing; // only read and written while holding the GIL
 
   static PyObject* make_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
   static int init(PyAlgorithm *self, PyObject *args, PyObject *kwds);
@@ -52,6 +58,7 @@ class PyAlgorithm {
   }
 
   static PyObject* reset(PyAlgorithm* self) {
+    if (!checkNotComputing(self, "reset")) return NULL;
     self->algo->reset();
     Py_RETURN_NONE;
   }
@@ -79,9 +86,23 @@ class PyAlgorithm {
 
   static PyObject* getDoc(PyAlgorithm* self);
   static PyObject* getStruct(PyAlgorithm* self);
+
+  static bool checkNotComputing(PyAlgorithm* self, const char* method);
 };
 
 
+bool PyAlgorithm::checkNotComputing(PyAlgorithm* self, const char* method) {
+  if (self->computing) {
+    ostringstream msg;
+    msg << "In " << self->algo->name() << "." << method << ": this algorithm instance is "
+        << "already computing in another thread, use a separate instance per thread";
+    PyErr_SetString(PyExc_RuntimeError, msg.str().c_str());
+    return false;
+  }
+  return true;
+}
+
+
 PyObject* PyAlgorithm::make_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
   return (PyObject*)(type->tp_alloc(type, 0));
 }
@@ -121,6 +142,8 @@ PyObject* PyAlgorithm::configure(PyAlgorithm* self, PyObject* args, PyObject* ke
 
   E_DEBUG(EPyBindings, PY_ALGONAME << "::configure()");
 
+  if (!checkNotComputing(self, "configure")) return NULL;
+
   // create the list of named parameters that this algorithm can accept
   ParameterMap pm = self->algo->defaultParameters();
 
@@ -172,8 +195,9 @@ void deallocate_outputs(::essentia::VectorEx<void*> outputs, ::essentia::VectorE
   for (int i=0; i<int(outputs.size()); ++i) {
     if (outputs[i] == NULL) continue;
     Edt tp = outputTypes[i];
+    // the types converted with toPythonRef now belong to their python object
     if (tp != VECTOR_REAL && tp != VECTOR_COMPLEX && tp != VECTOR_INTEGER &&
-        tp != MATRIX_REAL && tp != POOL) {
+        tp != VECTOR_VECTOR_REAL && tp != MATRIX_REAL && tp != TENSOR_REAL && tp != POOL) {
       dealloc(outputs[i], tp);
     }
   }
@@ -183,6 +207,8 @@ void deallocate_outputs(::essentia::VectorEx<void*> outputs, ::essentia::VectorE
 PyObject* PyAlgorithm::compute(PyAlgorithm* self, PyObject* args) {
   E_DEBUG(EPyBindings, PY_ALGONAME << "::compute()");
 
+  if (!checkNotComputing(self, "compute")) return NULL;
+
   // parse the arguments into separate python objects
   ::essentia::VectorEx<PyObject*> arg_list = unpack(args);
 
@@ -340,12 +366,28 @@ PyObject* PyAlgorithm::compute(PyAlgorithm* self, PyObject* args) {
   // are correctly bound), we can safely call the compute() method.
   E_DEBUG(EPyBindings, PY_ALGONAME << ": computing...");
 
+  // the inputs and outputs are plain C++ objects at this point, so the GIL
+  // can be released while computing to let other python threads run. The
+  // exception cannot be turned into a python error before re-acquiring it.
+  bool failed = false;
+  string error;
+  self->computing = true;
+
+  Py_BEGIN_ALLOW_THREADS
   try {
     self->algo->compute();
   }
   catch (const exception& e) {
+    failed = true;
+    error = e.what();
+  }
+  Py_END_ALLOW_THREADS
+
+  self->computing = false;
+
+  if (failed) {
     ostringstream msg;
-    msg << "In " << self->algo->name() << ".compute: " << e.what();
+    msg << "In " << self->algo->name() << ".compute: " << error;
     PyErr_SetString(PyExc_RuntimeError, msg.str().c_str());
 
     // clean up temp vars
@@ -521,7 +521,7 @@ PyObject* PyPool::value(PyPool* self, PyObject* pyArgs) {
         // still exists
         const ::essentia::VectorEx<Real>& v = p.value<::essentia::VectorEx<Real> >(key);
         RogueVector<Real>* r = new RogueVector<Real>(v.size(), 0.);
-        for (int i=0; i<int(v.size()); ++i) { (*r)[i] = v[i]; }
+        if (!v.empty()) fastcopy(&(*r)[0], &v[0], v.size());
         return VectorReal::toPythonRef(r);
       }
       case VECTOR_STRING: return VectorString::toPythonCopy(&p.value<::essentia::VectorEx<string> >(key));
@@ -37,16 +37,43 @@ PyObject* TensorReal::toPythonCopy(const essentia::Tensor<essentia::Real>* tenso
 
   result = PyArray_SimpleNew(nd, dims, PyArray_FLOAT);
 
+  if (result == NULL) {
+    throw EssentiaException("TensorReal: dang null object");
+  }
+
+  assert(((PyArrayObject*)result)->strides[3] == sizeof(Real));
+
   Real* dest = (Real*)(((PyArrayObject*)result)->data);
   const Real* src = tensor->data();
   fastcopy(dest, src, tensor->size());
 
-  assert(result->strides[3] == sizeof(Real));
+  return result;
+}
+
+
+// Tensors are stored in row-major order, so the numpy array can wrap the
+// tensor's data directly. The array takes ownership of the tensor, which is
+// deleted together with it.
+PyObject* TensorReal::toPythonRef(essentia::Tensor<essentia::Real>* tensor) {
+  npy_intp dims[TENSORRANK];
+
+  for (int i = 0; i < TENSORRANK; i++)
+    dims[i] = tensor->dimension(i);
+
+  PyObject* result;
+  if (tensor->size() == 0) {
+    result = PyArray_SimpleNew(TENSORRANK, dims, PyArray_FLOAT);
+  }
+  else {
+    result = PyArray_SimpleNewFromData(TENSORRANK, dims, PyArray_FLOAT, tensor->data());
+  }
 
   if (result == NULL) {
     throw EssentiaException("TensorReal: dang null object");
   }
 
+  PyArray_BASE(result) = TO_PYTHON_PROXY(TensorReal, tensor);
+
   return result;
 }
 
@@ -65,9 +92,18 @@ void* TensorReal::fromPythonCopy(PyObject* obj) {
      throw EssentiaException("TensorReal::fromPythonRef: this NumPy array doesn't contain Reals (maybe you forgot dtype='f4')");
    }
 
-  return new Tensor<Real>(TensorMap<Real>((Real *)PyArray_DATA(numpyarr),
-                                                  PyArray_DIM(obj, 0),
-                                                  PyArray_DIM(obj, 1),
-                                                  PyArray_DIM(obj, 2),
-                                                  PyArray_DIM(obj, 3)));
+  // the TensorMap expects row-major data without gaps (i.e. not a slice or a
+  // transposed view), this is only a new reference to obj if it already is
+  numpyarr = PyArray_GETCONTIGUOUS(numpyarr);
+  if (numpyarr == NULL) {
+    throw EssentiaException("TensorReal::fromPythonCopy: could not get a contiguous array");
+  }
+
+  Tensor<Real>* result = new Tensor<Real>(TensorMap<Real>((Real *)PyArray_DATA(numpyarr),
+                                                          PyArray_DIM(numpyarr, 0),
+                                                          PyArray_DIM(numpyarr, 1),
+                                                          PyArray_DIM(numpyarr, 2),
+                                                          PyArray_DIM(numpyarr, 3)));
+  Py_DECREF(numpyarr);
+  return result;
 }
@@ -88,9 +88,99 @@ PyObject* VectorVectorReal::toPythonCopy(const ::essentia::VectorEx<::essentia::
 }
 
 
+// Takes ownership of v: it is consumed while being converted, and nothing of it
+// is left once the result is returned. Rows of different sizes are moved as
+// they are into the numpy arrays of the returned list, without any copy.
+// Rows of a rectangular matrix are separate allocations and need to be copied
+// into a contiguous numpy array: each of them is freed once it has been
+// copied, but the whole array is allocated before the first row is, so the
+// peak memory is still about twice the size of the matrix.
+PyObject* VectorVectorReal::toPythonRef(::essentia::VectorEx<::essentia::VectorEx<Real> >* v) {
+  npy_intp dims[2] = { 0, 0 };
+  dims[0] = v->size();
+  if (!v->empty()) dims[1] = (*v)[0].size();
+
+  bool isRectangular = true;
+
+  for (int i=1; i<dims[0]; i++) {
+    if ((int)(*v)[i].size() != dims[1]) {
+      isRectangular = false;
+    }
+  }
+
+  if (isRectangular && dims[0] > 0 && dims[1] > 0) {
+    PyArrayObject* result = (PyArrayObject*)PyArray_SimpleNew(2, dims, PyArray_FLOAT);
+
+    if (result == NULL) {
+      delete v;
+      throw EssentiaException("VectorVectorReal: dang null object");
+    }
+
+    for (int i=0; i<dims[0]; i++) {
+      Real* dest = (Real*)(result->data + i*result->strides[0]);
+      fastcopy(dest, &((*v)[i][0]), dims[1]);
+      ::essentia::VectorEx<Real>().swap((*v)[i]);
+    }
+
+    delete v;
+    return (PyObject*)result;
+  }
+
+  // the list of numpy arrays is built the same way as in toPythonCopy, except
+  // that each array takes the row's storage over
+  PyObject* result = PyList_New(v->size());
+
+  for (int i=0; i<(int)v->size(); ++i) {
+    RogueVector<Real>* row = new RogueVector<Real>();
+    row->swap((*v)[i]);
+    try {
+      PyList_SET_ITEM(result, i, VectorReal::toPythonRef(row));
+    }
+    catch (...) {
+      delete row;
+      delete v;
+      Py_DECREF(result);
+      throw;
+    }
+  }
+
+  delete v;
+  return result;
+}
+
+
 void* VectorVectorReal::fromPythonCopy(PyObject* obj) {
+  // 2-dimensional numpy array of floats, copied row by row. Accepting it here
+  // avoids converting it to a list of lists of python floats first
+  if (PyArray_Check(obj)) {
+    if (PyArray_NDIM(obj) != 2) {
+      throw EssentiaException("VectorVectorReal::fromPythonCopy: input is not a 2-dimensional numpy array: ", PyArray_NDIM(obj));
+    }
+    if (PyArray_TYPE((PyArrayObject*)obj) != PyArray_FLOAT) {
+      throw EssentiaException("VectorVectorReal::fromPythonCopy: this NumPy array doesn't contain Reals (maybe you forgot dtype='f4')");
+    }
+
+    // this is only a new reference to obj if it is already C-contiguous
+    PyArrayObject* array = PyArray_GETCONTIGUOUS((PyArrayObject*)obj);
+    if (array == NULL) {
+      throw EssentiaException("VectorVectorReal::fromPythonCopy: could not get a contiguous array");
+    }
+
+    int nrows = PyArray_DIM(array, 0);
+    int ncols = PyArray_DIM(array, 1);
+    ::essentia::VectorEx<::essentia::VectorEx<Real> >* v = new ::essentia::VectorEx<::essentia::VectorEx<Real> >(nrows, ::essentia::VectorEx<Real>());
+
+    for (int i=0; i<nrows; i++) {
+      (*v)[i].resize(ncols);
+      if (ncols > 0) fastcopy(&((*v)[i][0]), (Real*)PyArray_GETPTR2(array, i, 0), ncols);
+    }
+
+    Py_DECREF(array);
+    return v;
+  }
+
   if (!PyList_Check(obj)) {
-    throw EssentiaException("VectorVectorReal::fromPythonCopy: input is not a list");
+    throw EssentiaException("VectorVectorReal::fromPythonCopy: input is not a list nor a 2-dimensional numpy array");
   }
 
   int size = PyList_Size(obj);
@@ -117,6 +207,7 @@ void* VectorVectorReal::fromPythonCopy(PyObject* obj) {
     // Numpy array of floats
     else if (PyArray_Check(row)) {
       if (PyArray_NDIM(row) != 1) {
+        delete v;
         throw EssentiaException("VectorVectorReal::fromPythonCopy: the element of input list "
                                 "is not a 1-dimensional numpy array: ", PyArray_NDIM(row));
       }
@@ -125,6 +216,7 @@ void* VectorVectorReal::fromPythonCopy(PyObject* obj) {
         throw EssentiaException("VectorVectorReal::fromPythonCopy: dang null object (list of numpy arrays)");
       }
       if (array->descr->type_num != PyArray_FLOAT) {
+        delete v;
         throw EssentiaException("VectorVectorReal::fromPythonCopy: this NumPy array doesn't contain Reals (maybe you forgot dtype='f4')");
       }
       assert(array->strides[0] == sizeof(Real));
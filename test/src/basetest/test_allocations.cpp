@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include "essentia_gtest.h"
+#include "allocationcounter.h"
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+// The algorithms of the spectral chain should not allocate any memory once
+// they have processed a first pass over their input: the temporaries they
+// need are kept as members, and the outputs keep their capacity.
+
+namespace {
+
+const int frameSize = 2048;
+const int nFrames = 16;
+
+// frames of harmonic tones with a changing fundamental and some noise, so
+// that the number of peaks changes from frame to frame
+::essentia::VectorEx< ::essentia::VectorEx<Real> > testFrames() {
+  ::essentia::VectorEx< ::essentia::VectorEx<Real> > frames(nFrames);
+  srand(0);
+  for (int f=0; f<nFrames; f++) {
+    frames[f].resize(frameSize);
+    Real f0 = 110 * (1 + f % 5);
+    for (int i=0; i<frameSize; i++) {
+      Real x = 0;
+      for (int h=1; h<=1+f%4; h++) x += 0.3 / h * sin(2 * M_PI * h * f0 * i / 44100.);
+      frames[f][i] = x + 0.01 * ((Real)rand() / RAND_MAX - 0.5);
+    }
+  }
+  return frames;
+}
+
+// number of allocations made by computing the algorithm on all the frames,
+// after having done so once to warm it up
+template <typename Input>
+uint64_t steadyStateAllocations(Algorithm* algo, const ::essentia::VectorEx<Input>& inputs,
+                                const char* inputName) {
+  for (int pass=0; pass<2; pass++) {
+    AllocationCount before = allocationCount();
+    for (int i=0; i<(int)inputs.size(); i++) {
+      algo->input(inputName).set(inputs[i]);
+      algo->compute();
+    }
+    if (pass == 1) return (allocationCount() - before).allocations;
+  }
+  return 0;
+}
+
+} // namespace
+
+// the counts are meaningless if the operator new of allocationcounter.h is
+// not the one in use: report the test as skipped rather than as passed
+#ifdef GTEST_SKIP
+#define SKIP_IF_NOT_COUNTING()                                             \
+  if (!allocationCountingEnabled()) {                                      \
+    GTEST_SKIP() << "allocation counting is not compiled in";              \
+  }
+#else
+#define SKIP_IF_NOT_COUNTING()                                             \
+  if (!allocationCountingEnabled()) {                                      \
+    cout << "[  SKIPPED ] allocation counting is not compiled in" << endl; \
+    RecordProperty("skipped", "allocation counting is not compiled in");   \
+    return;                                                                \
+  }
+#endif
+
+
+TEST(Allocations, Counter) {
+  SKIP_IF_NOT_COUNTING();
+  AllocationCount before = allocationCount();
+  ::essentia::VectorEx<Real>* v = new ::essentia::VectorEx<Real>(100);
+  AllocationCount allocated = allocationCount() - before;
+  delete v;
+
+  // the vector itself and its aligned storage
+  EXPECT_EQ((uint64_t)2, allocated.allocations);
+  EXPECT_GE(allocated.bytes, 100 * sizeof(Real));
+}
+
+TEST(Allocations, SpectralChain) {
+  SKIP_IF_NOT_COUNTING();
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+  ::essentia::VectorEx< ::essentia::VectorEx<Real> > frames = testFrames();
+  ::essentia::VectorEx< ::essentia::VectorEx<Real> > windowed(nFrames), spectra(nFrames);
+  ::essentia::VectorEx< ::essentia::VectorEx<Real> > frequencies(nFrames), magnitudes(nFrames);
+
+  Algorithm* windowing = factory.create("Windowing", "type", "blackmanharris62");
+  Algorithm* spectrum = factory.create("Spectrum", "size", frameSize);
+  Algorithm* peaks = factory.create("SpectralPeaks", "orderBy", "magnitude",
+                                    "minFrequency", 40, "maxPeaks", 60);
+
+  // compute the inputs of each algorithm from the outputs of the previous one
+  for (int i=0; i<nFrames; i++) {
+    windowing->input("frame").set(frames[i]);
+    windowing->output("frame").set(windowed[i]);
+    windowing->compute();
+    spectrum->input("frame").set(windowed[i]);
+    spectrum->output("spectrum").set(spectra[i]);
+    spectrum->compute();
+    peaks->input("spectrum").set(spectra[i]);
+    peaks->output("frequencies").set(frequencies[i]);
+    peaks->output("magnitudes").set(magnitudes[i]);
+    peaks->compute();
+    ASSERT_GT(frequencies[i].size(), (size_t)0);
+  }
+
+  ::essentia::VectorEx<Real> windowedFrame, spectrumFrame, frequencyFrame, magnitudeFrame;
+  windowing->output("frame").set(windowedFrame);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(windowing, frames, "frame"));
+
+  spectrum->output("spectrum").set(spectrumFrame);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(spectrum, windowed, "frame"));
+
+  peaks->output("frequencies").set(frequencyFrame);
+  peaks->output("magnitudes").set(magnitudeFrame);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(peaks, spectra, "spectrum"));
+
+  // the band preset and the shift of the maximum use scratch vectors
+  Algorithm* hpcp = factory.create("HPCP", "bandPreset", true, "maxShifted", true);
+  ::essentia::VectorEx<Real> hpcpFrame;
+  hpcp->output("hpcp").set(hpcpFrame);
+  for (int pass=0; pass<2; pass++) {
+    AllocationCount before = allocationCount();
+    for (int i=0; i<nFrames; i++) {
+      hpcp->input("frequencies").set(frequencies[i]);
+      hpcp->input("magnitudes").set(magnitudes[i]);
+      hpcp->compute();
+    }
+    if (pass == 1) {
+      EXPECT_EQ((uint64_t)0, (allocationCount() - before).allocations);
+    }
+  }
+
+  Algorithm* mfcc = factory.create("MFCC", "inputSize", frameSize/2+1);
+  ::essentia::VectorEx<Real> bands, coefficients;
+  mfcc->output("bands").set(bands);
+  mfcc->output("mfcc").set(coefficients);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(mfcc, spectra, "spectrum"));
+
+  Algorithm* pitch = factory.create("PitchYinFFT", "frameSize", frameSize);
+  Real pitchValue, pitchConfidence;
+  pitch->output("pitch").set(pitchValue);
+  pitch->output("pitchConfidence").set(pitchConfidence);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(pitch, spectra, "spectrum"));
+
+  delete windowing;
+  delete spectrum;
+  delete peaks;
+  delete hpcp;
+  delete mfcc;
+  delete pitch;
+}
+
+TEST(Allocations, PeakDetection) {
+  SKIP_IF_NOT_COUNTING();
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+  ::essentia::VectorEx< ::essentia::VectorEx<Real> > frames = testFrames();
+  ::essentia::VectorEx<Real> positions, amplitudes;
+
+  // with minPeakDistance, peaks are removed from the scratch vector as well
+  Algorithm* peakDetection = factory.create("PeakDetection", "minPeakDistance", 0.01,
+                                            "orderBy", "amplitude");
+  peakDetection->output("positions").set(positions);
+  peakDetection->output("amplitudes").set(amplitudes);
+  EXPECT_EQ((uint64_t)0, steadyStateAllocations(peakDetection, frames, "array"));
+  delete peakDetection;
+}
+
+TEST(Allocations, SineModelSynth) {
+  SKIP_IF_NOT_COUNTING();
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+  ::essentia::VectorEx<Real> frequencies, magnitudes, phases;
+  for (int i=1; i<=10; i++) {
+    frequencies.push_back(220 * i);
+    magnitudes.push_back(-6 * i);
+  }
+  ::essentia::VectorEx<complex<Real> > fft;
+
+  Algorithm* synth = factory.create("SineModelSynth", "fftSize", frameSize, "hopSize", frameSize/4);
+  synth->input("frequencies").set(frequencies);
+  synth->input("magnitudes").set(magnitudes);
+  synth->input("phases").set(phases);
+  synth->output("fft").set(fft);
+
+  synth->compute();
+  AllocationCount before = allocationCount();
+  for (int i=0; i<10; i++) synth->compute();
+  EXPECT_EQ((uint64_t)0, (allocationCount() - before).allocations);
+  delete synth;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "audiocache.h"
+#include <cstdio>
+#include <fstream>
+using namespace std;
+using namespace essentia;
+
+
+TEST(AudioCache, PathDependsOnContentAndStream) {
+  string file1 = "build/test/audiocache_test1.wav";
+  string file2 = "build/test/audiocache_test2.wav";
+  { ofstream f(file1.c_str()); f << "some audio data"; }
+  { ofstream f(file2.c_str()); f << "some audio data"; }
+
+  string path = audioCachePath("cache", file1, 0);
+  EXPECT_EQ("cache/", path.substr(0, 6));
+  EXPECT_EQ(path, audioCachePath("cache/", file2, 0));
+  EXPECT_NE(path, audioCachePath("cache", file1, 1));
+
+  { ofstream f(file2.c_str()); f << "some audio datb"; }
+  EXPECT_NE(path, audioCachePath("cache", file2, 0));
+
+  EXPECT_EQ("", audioCachePath("cache", "build/test/audiocache_missing.wav", 0));
+
+  remove(file1.c_str());
+  remove(file2.c_str());
+}
+
+TEST(AudioCache, WriteAndRead) {
+  string path = "build/test/audiocache_test.pcm";
+  remove(path.c_str());
+  resetAudioCacheStatistics();
+
+  ::essentia::VectorEx<float> samples(2*1000);
+  for (int i=0; i<(int)samples.size(); i++) samples[i] = i * 0.001;
+
+  AudioCacheInfo info;
+  info.sampleRate = 44100;
+  info.channels = 2;
+  info.bitRate = 1411200;
+  info.codec = "pcm_s16le";
+  info.md5 = "426fe5cf5ac3730f8c8db2a760e2b819";
+
+  {
+    AudioCacheWriter writer(path, 2);
+    writer.append(samples.data(), 600);
+    writer.append(samples.data() + 2*600, 400);
+
+    // the entry is not visible until it is committed
+    AudioCacheEntry entry;
+    EXPECT_FALSE(entry.open(path));
+
+    writer.commit(info);
+  }
+
+  AudioCacheEntry entry;
+  ASSERT_TRUE(entry.open(path));
+  EXPECT_EQ(1000, (int)entry.info().frames);
+  EXPECT_EQ(44100, entry.info().sampleRate);
+  EXPECT_EQ(2, entry.info().channels);
+  EXPECT_EQ(1411200, entry.info().bitRate);
+  EXPECT_EQ("pcm_s16le", entry.info().codec);
+  EXPECT_EQ("426fe5cf5ac3730f8c8db2a760e2b819", entry.info().md5);
+  for (int i=0; i<(int)samples.size(); i++) EXPECT_EQ(samples[i], entry.frames()[i]);
+  EXPECT_EQ(samples[2*700+1], entry.frames(700)[1]);
+
+  EXPECT_EQ(2*1000*sizeof(float), audioCacheStatistics().bytesWritten);
+  entry.close();
+  EXPECT_FALSE(entry.isOpen());
+
+  remove(path.c_str());
+}
+
+TEST(AudioCache, AbortedWriteLeavesNoEntry) {
+  string path = "build/test/audiocache_aborted.pcm";
+  remove(path.c_str());
+
+  float samples[2] = { 0.5, -0.5 };
+  {
+    AudioCacheWriter writer(path, 1);
+    writer.append(samples, 2);
+  }
+
+  AudioCacheEntry entry;
+  EXPECT_FALSE(entry.open(path));
+}
+
+TEST(AudioCache, InvalidEntry) {
+  string path = "build/test/audiocache_invalid.pcm";
+  {
+    AudioCacheWriter writer(path, 1);
+    float samples[3] = { 0.1, 0.2, 0.3 };
+    writer.append(samples, 3);
+    AudioCacheInfo info;
+    info.channels = 1;
+    writer.commit(info);
+  }
+
+  AudioCacheEntry entry;
+  EXPECT_TRUE(entry.open(path));
+
+  // corrupt the header of the entry
+  { ofstream f(path.c_str(), ios::out | ios::binary | ios::in); f.seekp(0); f << "ESSPCX"; }
+  EXPECT_FALSE(entry.open(path));
+  EXPECT_FALSE(entry.isOpen());
+
+  remove(path.c_str());
+}
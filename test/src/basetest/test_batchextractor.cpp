@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <set>
+#include "essentia_gtest.h"
+#include "batchextractor.h"
+using namespace std;
+using namespace essentia;
+
+
+// Make sure that files which cannot be processed are reported through the
+// callback, once each, without stopping the processing of the other files
+TEST(BatchExtractor, ErrorsAreReported) {
+  ::essentia::VectorEx<string> filenames;
+  for (int i=0; i<20; i++) {
+    filenames.push_back("test/audio/this_file_does_not_exist_" + to_string(i) + ".wav");
+  }
+
+  BatchExtractor extractor("MusicExtractor", ParameterMap(), 4);
+  EXPECT_EQ(extractor.numThreads(), 4);
+
+  int nCalls = 0; // callbacks are serialized, no need for an atomic here
+  set<string> reported;
+  extractor.process(filenames, [&](const BatchExtractor::Result& result) {
+    nCalls++;
+    reported.insert(result.filename);
+    EXPECT_FALSE(result.ok);
+    EXPECT_FALSE(result.error.empty());
+    EXPECT_TRUE(result.results.descriptorNames().empty());
+  });
+
+  EXPECT_EQ(nCalls, 20);
+  EXPECT_EQ(reported, set<string>(filenames.begin(), filenames.end()));
+  EXPECT_EQ(extractor.processedFiles(), 20);
+  EXPECT_EQ(extractor.failedFiles(), 20);
+}
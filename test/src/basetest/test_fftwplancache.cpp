@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+
+// the FFTW algorithms are only part of the library when it uses FFTW for the
+// FFT (see the --fft configure option)
+#if ESSENTIA_USE_FFTW
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include "algorithms/standard/fftw.h"
+#include "algorithms/standard/ifftw.h"
+#include "algorithms/standard/fftwcomplex.h"
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+namespace {
+
+// gives access to the plan used by an FFT algorithm
+template <typename FFTAlgorithm>
+class PlanOf : public FFTAlgorithm {
+ public:
+  PlanOf(int size) {
+    this->declareParameters();
+    setSize(size);
+  }
+  void setSize(int size) { this->Algorithm::configure("size", size); }
+  fftwf_plan plan() const { return this->_fftPlan; }
+};
+
+// a cache which is not the process-wide one, so that it reads the
+// environment variables again
+class LocalPlanCache : public FFTWPlanCache {
+ public:
+  LocalPlanCache() {}
+};
+
+} // namespace
+
+
+TEST(FFTWPlanCache, SharedPlans) {
+  // a size which no other test uses, so that the plans are created here
+  const int size = 1234;
+  PlanOf<FFTW> fft1(size), fft2(size);
+  PlanOf<IFFTW> ifft1(size), ifft2(size);
+  PlanOf<FFTWComplex> fftc1(size), fftc2(size);
+
+  EXPECT_TRUE(fft1.plan() != 0);
+  EXPECT_EQ(fft1.plan(), fft2.plan());
+  EXPECT_EQ(ifft1.plan(), ifft2.plan());
+  EXPECT_EQ(fftc1.plan(), fftc2.plan());
+
+  // one plan per type of transform
+  EXPECT_NE(fft1.plan(), ifft1.plan());
+  EXPECT_NE(fft1.plan(), fftc1.plan());
+  EXPECT_EQ(fft1.plan(), FFTWPlanCache::instance().plan(FFTWPlanCache::RealForward, size));
+
+  // reconfiguring to another size gets another plan, and back the same one
+  fft2.setSize(2*size);
+  EXPECT_NE(fft1.plan(), fft2.plan());
+  fft2.setSize(size);
+  EXPECT_EQ(fft1.plan(), fft2.plan());
+}
+
+TEST(FFTWPlanCache, SharedPlanResults) {
+  // two instances running the same plan give the same results as one
+  // running it alone, also when interleaved
+  const int size = 64;
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+  Algorithm* fft1 = factory.create("FFT", "size", size);
+  Algorithm* fft2 = factory.create("FFT", "size", size);
+
+  ::essentia::VectorEx<Real> frame1(size), frame2(size);
+  for (int i=0; i<size; i++) {
+    frame1[i] = sin(2 * M_PI * 3 * i / size);
+    frame2[i] = (i % 8) / 8.;
+  }
+  ::essentia::VectorEx<complex<Real> > out1, out2, expected1, expected2;
+
+  fft1->input("frame").set(frame1);
+  fft1->output("fft").set(expected1);
+  fft1->compute();
+  fft1->input("frame").set(frame2);
+  fft1->output("fft").set(expected2);
+  fft1->compute();
+
+  fft1->input("frame").set(frame1);
+  fft1->output("fft").set(out1);
+  fft2->input("frame").set(frame2);
+  fft2->output("fft").set(out2);
+  fft1->compute();
+  fft2->compute();
+
+  EXPECT_VEC_EQ(out1, expected1);
+  EXPECT_VEC_EQ(out2, expected2);
+
+  delete fft1;
+  delete fft2;
+}
+
+// the environment variables are set with setenv, which Windows doesn't have
+#ifndef OS_WIN32
+TEST(FFTWPlanCache, Wisdom) {
+  const string filename = "test_fftw_wisdom.tmp";
+  remove(filename.c_str());
+
+  // the file doesn't exist yet
+  EXPECT_FALSE(FFTWPlanCache::instance().importWisdom(filename));
+
+  setenv("ESSENTIA_FFTW_PLANNER", "measure", 1);
+  setenv("ESSENTIA_FFTW_WISDOM", filename.c_str(), 1);
+
+  // the caches are never destroyed, like the process-wide one, as FFTW
+  // plans outliving them would otherwise leak
+  static LocalPlanCache* cache = new LocalPlanCache();
+  EXPECT_TRUE(cache->plan(FFTWPlanCache::RealForward, 96) != 0);
+
+  // measuring has generated some wisdom, which has been written to the file
+  ifstream file(filename.c_str());
+  ASSERT_TRUE(file.good());
+  string wisdom((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  EXPECT_NE(string::npos, wisdom.find("fftwf_wisdom"));
+  file.close();
+
+  // a new cache imports it: once forgotten, planning the same transform with
+  // wisdom only succeeds if the wisdom has been imported back
+  fftwf_forget_wisdom();
+  static LocalPlanCache* other = new LocalPlanCache();
+  float* input = (float*)fftwf_malloc(sizeof(complex<float>)*96);
+  fftwf_complex* output = (fftwf_complex*)fftwf_malloc(sizeof(complex<float>)*96);
+  fftwf_plan p = fftwf_plan_dft_r2c_1d(96, input, output, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+  EXPECT_TRUE(p != 0);
+  if (p) fftwf_destroy_plan(p);
+  fftwf_free(input);
+  fftwf_free(output);
+  EXPECT_TRUE(other->plan(FFTWPlanCache::RealForward, 96) != 0);
+
+  unsetenv("ESSENTIA_FFTW_PLANNER");
+  unsetenv("ESSENTIA_FFTW_WISDOM");
+  remove(filename.c_str());
+}
+#endif // OS_WIN32
+
+#endif // ESSENTIA_USE_FFTW
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "network.h"
+#include "networkprofiler.h"
+#include "vectorinput.h"
+#include "vectoroutput.h"
+#include <sstream>
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+using namespace essentia::scheduler;
+
+
+TEST(NetworkProfiler, Disabled) {
+  ::essentia::VectorEx<Real> input(100, 1.0), output;
+  VectorInput<Real>* gen = new VectorInput<Real>(&input);
+  connect(gen->output("data"), output);
+
+  Network network(gen);
+  network.run();
+
+  EXPECT_FALSE(network.profiling());
+  EXPECT_TRUE(network.profiler() == 0);
+  ostringstream out;
+  ASSERT_THROW(network.printProfile(out), EssentiaException);
+  ASSERT_THROW(network.writeTrace(out), EssentiaException);
+}
+
+TEST(NetworkProfiler, Serial) {
+  ::essentia::VectorEx<Real> input(1000, 1.0), output;
+  VectorInput<Real>* gen = new VectorInput<Real>(&input);
+  connect(gen->output("data"), output);
+
+  Network network(gen);
+  network.setProfiling(true, true);
+  network.run();
+  EXPECT_VEC_EQ(output, input);
+
+  ASSERT_TRUE(network.profiler() != 0);
+  const ::essentia::VectorEx<AlgorithmProfile>& profiles = network.profiler()->profiles();
+  ASSERT_EQ(network.linearExecutionOrder().size(), profiles.size());
+
+  const AlgorithmProfile& generator = profiles[0];
+  EXPECT_EQ("VectorInput", generator.name);
+  EXPECT_EQ((uint64_t)input.size(), generator.tokensProduced);
+  EXPECT_GT(generator.calls, (uint64_t)0);
+  EXPECT_GE(generator.wallTime, 0);
+
+  const AlgorithmProfile& sink = profiles[1];
+  EXPECT_EQ("VectorOutput", sink.name);
+  EXPECT_GT(sink.ok, (uint64_t)0);
+  // the sink is run until it has nothing left to read after each call to the generator
+  EXPECT_GT(sink.noInput, (uint64_t)0);
+  EXPECT_EQ(sink.calls, sink.ok + sink.noInput + sink.noOutput);
+
+  ostringstream summary;
+  network.printProfile(summary);
+  EXPECT_NE(string::npos, summary.str().find("VectorInput"));
+  EXPECT_NE(string::npos, summary.str().find("Total"));
+
+  ostringstream trace;
+  network.writeTrace(trace);
+  EXPECT_EQ(0u, trace.str().find("{\"traceEvents\":["));
+  EXPECT_NE(string::npos, trace.str().find("\"name\":\"VectorOutput\""));
+  EXPECT_NE(string::npos, trace.str().find("\"ph\":\"X\""));
+  // calls which returned NO_INPUT are not part of the timeline
+  EXPECT_EQ(string::npos, trace.str().find("NO_INPUT"));
+}
+
+TEST(NetworkProfiler, Parallel) {
+  ::essentia::VectorEx<Real> input(1000, 1.0), output1, output2;
+  VectorInput<Real>* gen = new VectorInput<Real>(&input);
+  connect(gen->output("data"), output1);
+  connect(gen->output("data"), output2);
+
+  Network network(gen);
+  network.setNumThreads(2);
+  network.setProfiling(true);
+  network.run();
+  EXPECT_VEC_EQ(output1, input);
+  EXPECT_VEC_EQ(output2, input);
+
+  const ::essentia::VectorEx<AlgorithmProfile>& profiles = network.profiler()->profiles();
+  ASSERT_EQ((size_t)3, profiles.size());
+  for (int i=1; i<3; i++) {
+    EXPECT_EQ("VectorOutput", profiles[i].name);
+    EXPECT_GT(profiles[i].ok, (uint64_t)0);
+  }
+
+  // no timeline when only profiling
+  ostringstream trace;
+  network.writeTrace(trace);
+  EXPECT_EQ(string::npos, trace.str().find("\"ph\":\"X\""));
+}
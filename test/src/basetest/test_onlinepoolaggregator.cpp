@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "essentiamath.h"
+#include "network.h"
+#include "vectorinput.h"
+#include "onlinepoolaggregator.h"
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+using namespace essentia::scheduler;
+
+
+TEST(P2Quantile, ExactForFewValues) {
+  util::P2Quantile median;
+  EXPECT_EQ(median.value(), 0.0);
+
+  Real values[] = { 3, 1, 4, 1, 5 };
+  ::essentia::VectorEx<Real> added;
+  for (int i=0; i<(int)ARRAY_SIZE(values); i++) {
+    median.add(values[i]);
+    added.push_back(values[i]);
+    EXPECT_EQ(median.value(), ::essentia::median(added));
+  }
+}
+
+TEST(P2Quantile, Approximation) {
+  util::P2Quantile median, quartile(0.25);
+  for (int i=0; i<10000; i++) {
+    double x = (rand() % 10000) / 100.0;
+    median.add(x);
+    quartile.add(x);
+  }
+  EXPECT_NEAR(median.value(), 50, 1);
+  EXPECT_NEAR(quartile.value(), 25, 1);
+}
+
+TEST(RunningCovariance, SameAsTwoPasses) {
+  int n = 200, size = 3;
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > frames(n, ::essentia::VectorEx<Real>(size));
+  util::RunningCovariance cov(size);
+  for (int i=0; i<n; i++) {
+    for (int j=0; j<size; j++) frames[i][j] = (rand() % 1000) / 100.0 + i * j * 0.1;
+    cov.add(&frames[i][0]);
+  }
+
+  ::essentia::VectorEx<Real> m = meanFrames(frames);
+  for (int i=0; i<size; i++) {
+    EXPECT_NEAR(cov.mean(i), m[i], 1e-4);
+    for (int j=0; j<size; j++) {
+      double c = 0;
+      for (int k=0; k<n; k++) c += (frames[k][i] - m[i]) * (frames[k][j] - m[j]);
+      EXPECT_NEAR(cov.covariance(i, j), c / (n - 1), 1e-3);
+    }
+  }
+}
+
+TEST(OnlinePoolAggregator, SameAsPoolAggregator) {
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > frames(101, ::essentia::VectorEx<Real>(2));
+  ::essentia::VectorEx<Real> reals(frames.size());
+  for (int i=0; i<(int)frames.size(); i++) {
+    frames[i][0] = (rand() % 1000) / 100.0;
+    frames[i][1] = i * 0.5 + (rand() % 100) / 100.0;
+    reals[i] = frames[i][0];
+  }
+
+  const char* statsC[] = { "mean", "var", "stdev", "skew", "kurt", "min", "max", "dmean", "dvar2" };
+  ::essentia::VectorEx<string> stats = arrayToVector<string>(statsC);
+
+  Pool online;
+  VectorInput<::essentia::VectorEx<Real> >* gen = new VectorInput<::essentia::VectorEx<Real> >(&frames);
+  connectAggregated(gen->output("data"), online, "frames", stats);
+  Network(gen).run();
+
+  VectorInput<Real>* realGen = new VectorInput<Real>(&reals);
+  connectAggregated(realGen->output("data"), online, "reals", stats);
+  Network(realGen).run();
+
+  Pool stored, aggregated;
+  for (int i=0; i<(int)frames.size(); i++) {
+    stored.add("frames", frames[i]);
+    stored.add("reals", reals[i]);
+  }
+  standard::Algorithm* aggregator = standard::AlgorithmFactory::create("PoolAggregator", "defaultStats", stats);
+  aggregator->input("input").set(stored);
+  aggregator->output("output").set(aggregated);
+  aggregator->compute();
+  delete aggregator;
+
+  for (int i=0; i<(int)stats.size(); i++) {
+    ::essentia::VectorEx<Real> expected = aggregated.value<::essentia::VectorEx<Real> >("frames." + stats[i]);
+    ::essentia::VectorEx<Real> found = online.value<::essentia::VectorEx<Real> >("frames." + stats[i]);
+    ASSERT_EQ(found.size(), expected.size());
+    for (int j=0; j<(int)found.size(); j++) {
+      EXPECT_NEAR(found[j], expected[j], 1e-4 * max(Real(1), abs(expected[j]))) << stats[i];
+    }
+    EXPECT_NEAR(online.value<Real>("reals." + stats[i]), aggregated.value<Real>("reals." + stats[i]),
+                1e-4 * max(Real(1), abs(aggregated.value<Real>("reals." + stats[i])))) << stats[i];
+  }
+}
+
+TEST(OnlinePoolAggregator, Covariance) {
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > frames(50, ::essentia::VectorEx<Real>(2));
+  for (int i=0; i<(int)frames.size(); i++) {
+    frames[i][0] = (rand() % 1000) / 100.0;
+    frames[i][1] = (rand() % 1000) / 100.0 - frames[i][0];
+  }
+
+  const char* statsC[] = { "cov", "icov" };
+  Pool pool;
+  VectorInput<::essentia::VectorEx<Real> >* gen = new VectorInput<::essentia::VectorEx<Real> >(&frames);
+  connectAggregated(gen->output("data"), pool, "frames", arrayToVector<string>(statsC));
+  Network(gen).run();
+
+  const ::essentia::VectorEx<::essentia::VectorEx<Real> >& cov = pool.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("frames.cov");
+  const ::essentia::VectorEx<::essentia::VectorEx<Real> >& icov = pool.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("frames.icov");
+  ASSERT_EQ(cov.size(), (size_t)2);
+  ASSERT_EQ(icov.size(), (size_t)2);
+
+  // their product is the identity
+  for (int i=0; i<2; i++) {
+    for (int j=0; j<2; j++) {
+      Real p = cov[i][0] * icov[0][j] + cov[i][1] * icov[1][j];
+      EXPECT_NEAR(p, i == j ? 1 : 0, 1e-4);
+    }
+  }
+}
+
+TEST(OnlinePoolAggregator, InvalidStats) {
+  Pool pool;
+  ::essentia::VectorEx<string> stats(1, "foo");
+  ASSERT_THROW(OnlinePoolAggregator<Real>(&pool, "foo", stats), EssentiaException);
+
+  const char* copyC[] = { "copy", "mean" };
+  ASSERT_THROW(OnlinePoolAggregator<Real>(&pool, "foo", arrayToVector<string>(copyC)), EssentiaException);
+
+  ::essentia::VectorEx<string> cov(1, "cov");
+  ASSERT_THROW(OnlinePoolAggregator<Real>(&pool, "foo", cov), EssentiaException);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "network.h"
+#include "vectorinput.h"
+#include "vectoroutput.h"
+#include <sstream>
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+
+
+// writes n consecutive integers starting at next, returns false if the buffer
+// could not provide room for them
+bool write(Source<int>& source, int n, int& next) {
+  if (!source.acquire(n)) return false;
+  ::essentia::VectorEx<int>& tokens = source.tokens();
+  for (int i=0; i<n; i++) tokens[i] = next++;
+  source.release(n);
+  return true;
+}
+
+// reads n tokens and checks that they follow each other, returns false if
+// there were not enough of them
+bool read(Sink<int>& sink, int n, int& next, bool& ordered) {
+  if (!sink.acquire(n)) return false;
+  const ::essentia::VectorEx<int>& tokens = sink.tokens();
+  for (int i=0; i<n; i++) {
+    if (tokens[i] != next++) ordered = false;
+  }
+  sink.release(n);
+  return true;
+}
+
+
+TEST(PhantomBuffer, LazyAllocation) {
+  Source<int> source("Source");
+  Sink<int> sink("Sink");
+  connect(source, sink);
+
+  // the maximum sizes don't allocate anything
+  source.setBufferInfo(BufferInfo(1 << 20, 1 << 16));
+  EXPECT_EQ(0, source.allocatedBufferInfo().size);
+  EXPECT_EQ((uint64_t)0, source.bufferMemory());
+
+  // the first acquire allocates a small buffer, far from the maximum
+  int written = 0, read = 0;
+  bool ordered = true;
+  ASSERT_TRUE(write(source, 10, written));
+  BufferInfo allocated = source.allocatedBufferInfo();
+  EXPECT_GT(allocated.size, 10);
+  EXPECT_LT(allocated.size, 1 << 20);
+  EXPECT_LT(allocated.maxContiguousElements, 1 << 16);
+  EXPECT_EQ(source.bufferInfo().size, 1 << 20);
+
+  // and it grows from there
+  for (int i=0; i<100; i++) ASSERT_TRUE(write(source, 100, written));
+  while (::read(sink, 50, read, ordered)) {}
+  while (::read(sink, 1, read, ordered)) {}
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(written, read);
+  EXPECT_LT(source.allocatedBufferInfo().size, 1 << 20);
+
+  // lowering the maximum sizes shrinks the storage
+  source.setBufferInfo(BufferInfo(64, 16));
+  EXPECT_LE(source.allocatedBufferInfo().size, 64);
+  EXPECT_LE(source.allocatedBufferInfo().maxContiguousElements, 16);
+  ASSERT_TRUE(write(source, 10, written));
+  ASSERT_TRUE(::read(sink, 10, read, ordered));
+  EXPECT_TRUE(ordered);
+}
+
+TEST(PhantomBuffer, GrowKeepsTokens) {
+  Source<int> source("Source");
+  Sink<int> fast("Fast");
+  Sink<int> slow("Slow");
+  connect(source, fast);
+  connect(source, slow);
+
+  source.setBufferInfo(BufferInfo(4096, 256));
+  source.setAllocatedBufferInfo(BufferInfo(16, 4));
+  EXPECT_EQ(16, source.allocatedBufferInfo().size);
+
+  // the slow reader lags behind and reads larger chunks, so that the buffer
+  // has to grow both for the writer and for the readers
+  int written = 0, readFast = 0, readSlow = 0;
+  bool ordered = true;
+  for (int step=0; step<200; step++) {
+    int n = 1 + (step*7) % 50;
+    ASSERT_TRUE(write(source, n, written));
+    read(fast, 1 + (step*3) % 20, readFast, ordered);
+    if (step % 4 == 3) {
+      while (read(slow, 1 + (step*11) % 150, readSlow, ordered)) {}
+    }
+  }
+  while (read(fast, 1, readFast, ordered)) {}
+  while (read(slow, 1, readSlow, ordered)) {}
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(written, readFast);
+  EXPECT_EQ(written, readSlow);
+
+  BufferInfo allocated = source.allocatedBufferInfo();
+  EXPECT_GT(allocated.size, 16);
+  EXPECT_LE(allocated.size, 4096);
+  EXPECT_LE(allocated.maxContiguousElements, 256);
+  EXPECT_EQ(4096, source.bufferInfo().size);
+  EXPECT_EQ((uint64_t)(allocated.size + allocated.maxContiguousElements)*sizeof(int),
+            source.bufferMemory());
+}
+
+TEST(PhantomBuffer, Budget) {
+  Source<int> source("Source");
+  Sink<int> sink("Sink");
+  connect(source, sink);
+
+  source.setBufferInfo(BufferInfo(1 << 16, 64));
+  source.setAllocatedBufferInfo(BufferInfo(16, 4));
+
+  shared_ptr<BufferMemoryBudget> budget(new BufferMemoryBudget());
+  budget->setLimit(1024*sizeof(int));
+  source.setBufferMemoryBudget(budget);
+  EXPECT_EQ(source.bufferMemory(), budget->used());
+
+  // nobody reads: the writer fills the buffer until the budget is exhausted
+  int written = 0;
+  while (write(source, 32, written)) {}
+  EXPECT_GT(written, 16);
+  EXPECT_LE(budget->used(), budget->limit());
+  EXPECT_EQ(source.bufferMemory(), budget->used());
+
+  // reading makes room again without growing
+  int read = 0;
+  bool ordered = true;
+  while (::read(sink, 32, read, ordered)) {}
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(written, read);
+  EXPECT_TRUE(write(source, 32, written));
+
+  // the memory is given back to the budget
+  source.setBufferMemoryBudget(shared_ptr<BufferMemoryBudget>());
+  EXPECT_EQ((uint64_t)0, budget->used());
+}
+
+TEST(PhantomBuffer, AdaptiveNetwork) {
+  ::essentia::VectorEx<Real> input(100000);
+  for (int i=0; i<(int)input.size(); i++) input[i] = i;
+
+  ::essentia::VectorEx<Real> output[2];
+  uint64_t memory[2];
+
+  for (int adaptive=0; adaptive<2; adaptive++) {
+    VectorInput<Real>* gen = new VectorInput<Real>(&input);
+    gen->output("data").setBufferType(BufferUsage::forLargeAudioStream);
+    connect(gen->output("data"), output[adaptive]);
+
+    scheduler::Network network(gen);
+    network.setAdaptiveBufferSizes(adaptive);
+    network.run();
+    memory[adaptive] = network.bufferMemory();
+
+    if (adaptive) {
+      ostringstream report;
+      network.printBufferMemory(report);
+      EXPECT_NE(string::npos, report.str().find("Total"));
+    }
+  }
+
+  EXPECT_VEC_EQ(output[0], input);
+  EXPECT_VEC_EQ(output[1], input);
+  EXPECT_LT(memory[1]*100, memory[0]);
+}
@@ -19,6 +19,10 @@
 
 #include <algorithm>
 #include "essentia_gtest.h"
+#if THREAD_SAFE_MUTEX
+#include <thread>
+#include <atomic>
+#endif
 using namespace std;
 using essentia::Real;
 using essentia::EssentiaException;
@@ -264,3 +268,207 @@ TEST(Pool, IntegrityCheck) {
   p.add("foo.bar", (Real)1.23456789);
   ASSERT_THROW(p.add("foo.bar", "mixed up the types!"), EssentiaException);
 }
+
+TEST(Pool, ParentAndChildDescriptorNames) {
+  essentia::Pool p;
+  p.add("foo.bar", (Real)1);
+  p.add("foo.barbar", (Real)1);
+  p.add("foo-bar", (Real)1);
+  ASSERT_THROW(p.add("foo.bar.baz", (Real)1), EssentiaException);
+  ASSERT_THROW(p.add("foo", (Real)1), EssentiaException);
+  ASSERT_THROW(p.set("foo", "string"), EssentiaException);
+
+  // the names become available again once removed
+  p.removeNamespace("foo");
+  p.remove("foo-bar");
+  p.add("foo", (Real)1);
+  p.add("foo-bar.baz", (Real)1);
+}
+
+TEST(Pool, DescriptorHandle) {
+  essentia::DescriptorHandle<Real> handle("foo.bar");
+
+  essentia::Pool p;
+  p.add(handle, (Real)1);
+  p.add("foo.bar", (Real)2);
+  p.add(handle, (Real)3);
+
+  ::essentia::VectorEx<Real> expected;
+  expected.push_back(1);
+  expected.push_back(2);
+  expected.push_back(3);
+  EXPECT_VEC_EQ(p.value<::essentia::VectorEx<Real> >("foo.bar"), expected);
+
+  // the handle is looked up again after descriptors have been removed
+  p.remove("foo.bar");
+  p.add(handle, (Real)4);
+  EXPECT_VEC_EQ(p.value<::essentia::VectorEx<Real> >("foo.bar"), ::essentia::VectorEx<Real>(1, (Real)4));
+
+  // or when it is used with another pool
+  essentia::Pool p2;
+  p2.add(handle, (Real)5);
+  EXPECT_VEC_EQ(p2.value<::essentia::VectorEx<Real> >("foo.bar"), ::essentia::VectorEx<Real>(1, (Real)5));
+  EXPECT_VEC_EQ(p.value<::essentia::VectorEx<Real> >("foo.bar"), ::essentia::VectorEx<Real>(1, (Real)4));
+
+  // or with a copy of the pool it was used with
+  {
+    essentia::Pool copy(p2);
+    copy.add(handle, (Real)6);
+    ::essentia::VectorEx<Real> copied;
+    copied.push_back(5);
+    copied.push_back(6);
+    EXPECT_VEC_EQ(copy.value<::essentia::VectorEx<Real> >("foo.bar"), copied);
+  }
+  EXPECT_VEC_EQ(p2.value<::essentia::VectorEx<Real> >("foo.bar"), ::essentia::VectorEx<Real>(1, (Real)5));
+
+  // and is validated as any other descriptor name
+  p.clear();
+  p.add("foo", (Real)1);
+  ASSERT_THROW(p.add(handle, (Real)6), EssentiaException);
+}
+
+TEST(Pool, DescriptorHandleOutlivingPool) {
+  essentia::DescriptorHandle<Real> handle("foo.bar");
+
+  // a new pool is created at the address of the one the handle was used with,
+  // which it must not mistake for the deleted one
+  union Storage {
+    essentia::Pool pool;
+    Storage() {}
+    ~Storage() {}
+  } storage;
+
+  new (&storage.pool) essentia::Pool();
+  storage.pool.add(handle, (Real)1);
+  storage.pool.~Pool();
+
+  new (&storage.pool) essentia::Pool();
+  storage.pool.add(handle, (Real)2);
+  storage.pool.add(handle, (Real)3);
+  ::essentia::VectorEx<Real> expected;
+  expected.push_back(2);
+  expected.push_back(3);
+  EXPECT_VEC_EQ(storage.pool.value<::essentia::VectorEx<Real> >("foo.bar"), expected);
+  storage.pool.~Pool();
+}
+
+TEST(Pool, ColumnarStorage) {
+  essentia::Pool p;
+  p.setColumnarStorage(true);
+
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > expected;
+  for (int i=0; i<100; i++) {
+    ::essentia::VectorEx<Real> frame(3);
+    for (int j=0; j<3; j++) frame[j] = i*3 + j;
+    expected.push_back(frame);
+    if (i < 50) p.add("foo.bar", frame);
+  }
+  p.append("foo.bar", ::essentia::VectorEx<::essentia::VectorEx<Real> >(expected.begin() + 50, expected.end()));
+  EXPECT_TRUE(p.isColumnar("foo.bar"));
+
+  // all the frames are contiguous
+  const ::essentia::VectorEx<::essentia::VectorEx<Real> >& frames =
+    p.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("foo.bar");
+  EXPECT_MATRIX_EQ(frames, expected);
+  EXPECT_EQ(frames[99].data(), frames[0].data() + 99*3);
+
+  // copies of the pool have their own frames
+  essentia::Pool copy(p);
+  p.clear();
+  EXPECT_MATRIX_EQ(copy.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("foo.bar"), expected);
+  EXPECT_TRUE(copy.isColumnar("foo.bar"));
+
+  // frames of another size can't be stored in columnar mode
+  ::essentia::VectorEx<Real> other(2, 0.);
+  expected.push_back(other);
+  copy.add("foo.bar", other);
+  EXPECT_FALSE(copy.isColumnar("foo.bar"));
+  EXPECT_MATRIX_EQ(copy.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("foo.bar"), expected);
+
+  // merged frames don't point to the columns of the pool they come from,
+  // which is deleted here before they are read
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > first(expected.begin(), expected.begin() + 10);
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > second(expected.begin() + 10, expected.begin() + 20);
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > interleaved;
+  for (int i=0; i<10; i++) {
+    interleaved.push_back(first[i]);
+    interleaved.push_back(second[i]);
+  }
+
+  essentia::Pool merged, mergedColumnar;
+  mergedColumnar.setColumnarStorage(true);
+  essentia::Pool* destinations[] = { &merged, &mergedColumnar };
+  {
+    essentia::Pool source;
+    source.setColumnarStorage(true);
+    source.append("merge.new", first);
+    source.append("merge.replaced", second);
+    source.append("merge.interleaved", second);
+
+    for (int d=0; d<2; d++) {
+      destinations[d]->append("merge.replaced", first);
+      destinations[d]->append("merge.interleaved", first);
+      destinations[d]->merge("merge.new", source.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.new"));
+      destinations[d]->merge("merge.replaced", source.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.replaced"), "replace");
+      destinations[d]->merge("merge.interleaved", source.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.interleaved"), "interleave");
+    }
+  }
+
+  for (int d=0; d<2; d++) {
+    EXPECT_MATRIX_EQ(destinations[d]->value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.new"), first);
+    EXPECT_MATRIX_EQ(destinations[d]->value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.replaced"), second);
+    EXPECT_MATRIX_EQ(destinations[d]->value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("merge.interleaved"), interleaved);
+  }
+
+  // and are stored in columnar mode if the destination pool is
+  EXPECT_FALSE(merged.isColumnar("merge.new"));
+  EXPECT_TRUE(mergedColumnar.isColumnar("merge.new"));
+  EXPECT_TRUE(mergedColumnar.isColumnar("merge.replaced"));
+  EXPECT_TRUE(mergedColumnar.isColumnar("merge.interleaved"));
+}
+
+#if THREAD_SAFE_MUTEX
+
+// Make sure several threads can add and merge into the same pool at the same
+// time, including under descriptor names none of them has created yet
+TEST(Pool, ConcurrentAdd) {
+  const int nThreads = 8;
+  const int nValues = 1000;
+
+  essentia::Pool p;
+  std::atomic<bool> start(false);
+  ::essentia::VectorEx<std::thread*> threads;
+  for (int t=0; t<nThreads; t++) {
+    threads.push_back(new std::thread([&p, &start, t]() {
+      essentia::Pool local;
+      local.add("thread" + std::to_string(t), (Real)t);
+      while (!start) std::this_thread::yield();
+      for (int i=0; i<nValues; i++) {
+        p.add("shared.real", (Real)i);
+        p.add("shared.vector", ::essentia::VectorEx<Real>(2));
+        p.add("shared.string", "foo");
+      }
+      p.merge(local);
+    }));
+  }
+  start = true;
+  for (int t=0; t<nThreads; t++) {
+    threads[t]->join();
+    delete threads[t];
+  }
+
+  EXPECT_EQ(p.value<::essentia::VectorEx<Real> >("shared.real").size(), size_t(nThreads*nValues));
+  EXPECT_EQ(p.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("shared.vector").size(), size_t(nThreads*nValues));
+  EXPECT_EQ(p.value<::essentia::VectorEx<string> >("shared.string").size(), size_t(nThreads*nValues));
+
+  Real sum = 0;
+  const ::essentia::VectorEx<Real>& values = p.value<::essentia::VectorEx<Real> >("shared.real");
+  for (int i=0; i<(int)values.size(); i++) sum += values[i];
+  EXPECT_EQ(sum, (Real)nThreads*nValues*(nValues-1)/2);
+
+  for (int t=0; t<nThreads; t++) {
+    EXPECT_EQ(p.value<::essentia::VectorEx<Real> >("thread" + std::to_string(t))[0], (Real)t);
+  }
+}
+
+#endif // THREAD_SAFE_MUTEX
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "essentiamath.h"
+#include "runningmoments.h"
+using namespace std;
+using namespace essentia;
+
+
+TEST(RunningMoments, SameAsEssentiaMath) {
+  ::essentia::VectorEx<Real> values(1000);
+  for (int i=0; i<(int)values.size(); i++) values[i] = (rand() % 1000) / 100.0 + (i % 7);
+
+  util::RunningMoments moments;
+  for (int i=0; i<(int)values.size(); i++) moments.add(values[i]);
+
+  Real m = mean(values);
+  EXPECT_EQ(moments.count(), values.size());
+  EXPECT_NEAR(moments.mean(), m, 1e-4);
+  EXPECT_NEAR(moments.variance(), variance(values, m), 1e-3);
+  EXPECT_NEAR(moments.skewness(), skewness(values, m), 1e-4);
+  EXPECT_NEAR(moments.kurtosis(), kurtosis(values, m), 1e-4);
+}
+
+TEST(RunningMoments, Constant) {
+  util::RunningMoments moments;
+  for (int i=0; i<10; i++) moments.add(0.1);
+
+  EXPECT_EQ(moments.variance(), 0.0);
+  EXPECT_EQ(moments.skewness(), 0.0);
+  EXPECT_EQ(moments.kurtosis(), -3.0);
+
+  moments.reset();
+  EXPECT_EQ(moments.count(), (size_t)0);
+  EXPECT_EQ(moments.mean(), 0.0);
+  EXPECT_EQ(moments.variance(), 0.0);
+}
+
+TEST(RunningMoments, Merge) {
+  util::RunningMoments all, first, second, empty;
+  for (int i=0; i<300; i++) {
+    double x = (rand() % 1000) / 10.0;
+    all.add(x);
+    if (i < 100) first.add(x);
+    else second.add(x);
+  }
+
+  first.merge(empty);
+  first.merge(second);
+  EXPECT_EQ(first.count(), all.count());
+  EXPECT_NEAR(first.mean(), all.mean(), 1e-9);
+  EXPECT_NEAR(first.variance(), all.variance(), 1e-6);
+  EXPECT_NEAR(first.skewness(), all.skewness(), 1e-9);
+  EXPECT_NEAR(first.kurtosis(), all.kurtosis(), 1e-9);
+
+  empty.merge(all);
+  EXPECT_EQ(empty.count(), all.count());
+  EXPECT_EQ(empty.mean(), all.mean());
+}
@@ -21,6 +21,8 @@
 #include "network.h"
 #include "networkparser.h"
 #include "graphutils.h"
+#include "vectorinput.h"
+#include "streamingalgorithmwrapper.h"
 using namespace std;
 using namespace essentia;
 using namespace essentia::streaming;
@@ -61,3 +63,159 @@ TEST(Scheduler, SourceProxyFork) {
 
   network.run();
 }
+
+
+/**
+ * Builds a network with several independent branches fed by the same
+ * FrameCutter and writing into the given pool. The frame-based algorithms
+ * process batchSize frames per call.
+ */
+Network* createBranchingNetwork(const ::essentia::VectorEx<Real>& signal, Pool& pool,
+                                int batchSize=1) {
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+
+  Algorithm* gen      = new VectorInput<Real>(&signal);
+  Algorithm* fc       = factory.create("FrameCutter", "frameSize", 1024, "hopSize", 512);
+  Algorithm* window   = factory.create("Windowing", "type", "hann");
+  Algorithm* spectrum = factory.create("Spectrum");
+  Algorithm* mfcc     = factory.create("MFCC");
+  Algorithm* centroid = factory.create("Centroid");
+  Algorithm* rms      = factory.create("RMS");
+  Algorithm* zcr      = factory.create("ZeroCrossingRate");
+
+  gen->output("data")          >>  fc->input("signal");
+  fc->output("frame")          >>  window->input("frame");
+  fc->output("frame")          >>  rms->input("array");
+  fc->output("frame")          >>  zcr->input("signal");
+  window->output("frame")      >>  spectrum->input("frame");
+  spectrum->output("spectrum") >>  mfcc->input("spectrum");
+  spectrum->output("spectrum") >>  centroid->input("array");
+
+  mfcc->output("bands")        >>  NOWHERE;
+  mfcc->output("mfcc")         >>  PC(pool, "mfcc");
+  centroid->output("centroid") >>  PC(pool, "centroid");
+  rms->output("rms")           >>  PC(pool, "rms");
+  zcr->output("zeroCrossingRate") >> PC(pool, "zcr");
+
+  if (batchSize > 1) {
+    Algorithm* wrapped[] = { window, spectrum, mfcc, centroid, rms, zcr };
+    for (int i=0; i<(int)ARRAY_SIZE(wrapped); i++) {
+      dynamic_cast<StreamingAlgorithmWrapper*>(wrapped[i])->setBatchSize(batchSize);
+    }
+  }
+
+  return new Network(gen);
+}
+
+/**
+ * Test that running a network on several threads gives exactly the same
+ * results as running it sequentially.
+ */
+TEST(Scheduler, MultiThreaded) {
+  ::essentia::VectorEx<Real> signal(44100);
+  for (int i=0; i<(int)signal.size(); i++) {
+    signal[i] = sin(2*M_PI*440*i/44100.) + 0.1*(rand()/Real(RAND_MAX) - 0.5);
+  }
+
+  Pool expected;
+  Network* sequential = createBranchingNetwork(signal, expected);
+  sequential->run();
+  delete sequential;
+
+  for (int nThreads=2; nThreads<=4; nThreads++) {
+    Pool result;
+    Network* parallel = createBranchingNetwork(signal, result);
+    parallel->setNumThreads(nThreads);
+    parallel->run();
+    delete parallel;
+
+    EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("centroid"),
+                  expected.value<::essentia::VectorEx<Real> >("centroid"));
+    EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("rms"),
+                  expected.value<::essentia::VectorEx<Real> >("rms"));
+    EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("zcr"),
+                  expected.value<::essentia::VectorEx<Real> >("zcr"));
+    EXPECT_MATRIX_EQ(result.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("mfcc"),
+                     expected.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("mfcc"));
+  }
+}
+
+
+/**
+ * Test that processing the frames in batches gives exactly the same results
+ * as processing them one by one, including for the last, incomplete, batch.
+ */
+TEST(Scheduler, Batched) {
+  ::essentia::VectorEx<Real> signal(44100);
+  for (int i=0; i<(int)signal.size(); i++) {
+    signal[i] = sin(2*M_PI*440*i/44100.) + 0.1*(rand()/Real(RAND_MAX) - 0.5);
+  }
+
+  Pool expected;
+  Network* sequential = createBranchingNetwork(signal, expected);
+  sequential->run();
+  delete sequential;
+
+  int batchSizes[] = { 2, 16, 64 };
+  for (int i=0; i<(int)ARRAY_SIZE(batchSizes); i++) {
+    for (int nThreads=1; nThreads<=2; nThreads++) {
+      Pool result;
+      Network* batched = createBranchingNetwork(signal, result, batchSizes[i]);
+      batched->setNumThreads(nThreads);
+      batched->run();
+      delete batched;
+
+      EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("centroid"),
+                    expected.value<::essentia::VectorEx<Real> >("centroid"));
+      EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("rms"),
+                    expected.value<::essentia::VectorEx<Real> >("rms"));
+      EXPECT_VEC_EQ(result.value<::essentia::VectorEx<Real> >("zcr"),
+                    expected.value<::essentia::VectorEx<Real> >("zcr"));
+      EXPECT_MATRIX_EQ(result.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("mfcc"),
+                       expected.value<::essentia::VectorEx<::essentia::VectorEx<Real> > >("mfcc"));
+    }
+  }
+}
+
+
+/**
+ * Test that an algorithm implementing the batch interface computes the same
+ * frames with computeBatch() as with compute() called on each of them.
+ */
+TEST(Scheduler, ComputeBatch) {
+  standard::Algorithm* windowing = standard::AlgorithmFactory::create("Windowing", "type", "hann",
+                                                                      "zeroPadding", 16);
+  ASSERT_TRUE(windowing->supportsBatch());
+
+  const int n = 5;
+  ::essentia::VectorEx<::essentia::VectorEx<Real> > frames(n), batched(n), expected(n);
+  for (int i=0; i<n; i++) {
+    frames[i].resize(64);
+    for (int j=0; j<64; j++) frames[i][j] = sin(0.1*(i+1)*j);
+
+    windowing->input("frame").set(frames[i]);
+    windowing->output("frame").set(expected[i]);
+    windowing->compute();
+  }
+
+  // the inputs and outputs point to the first of the contiguous frames
+  windowing->input("frame").set(frames[0]);
+  windowing->output("frame").set(batched[0]);
+  windowing->computeBatch(n);
+
+  EXPECT_MATRIX_EQ(batched, expected);
+  delete windowing;
+}
+
+TEST(Scheduler, BatchSizeOnlyForTokens) {
+  AlgorithmFactory& factory = AlgorithmFactory::instance();
+
+  // LowPass wraps its standard counterpart with STREAM inputs and outputs
+  Algorithm* lowpass = factory.create("LowPass");
+  StreamingAlgorithmWrapper* wrapper = dynamic_cast<StreamingAlgorithmWrapper*>(lowpass);
+  ASSERT_TRUE(wrapper != 0);
+  ASSERT_THROW(wrapper->setBatchSize(4), EssentiaException);
+  wrapper->setBatchSize(1);
+  EXPECT_EQ(1, wrapper->batchSize());
+  delete lowpass;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include "essentia_gtest.h"
+#include "simd.h"
+using namespace std;
+using namespace essentia;
+
+
+namespace {
+
+// sizes which are not multiples of the vector widths, to also test the tails
+const int sizes[] = { 0, 1, 3, 4, 7, 8, 15, 17, 1025 };
+
+::essentia::VectorEx<Real> randomVector(int size) {
+  ::essentia::VectorEx<Real> v(size);
+  for (int i=0; i<size; i++) v[i] = (Real)rand() / RAND_MAX * 2 - 1;
+  return v;
+}
+
+// runs f at all the supported levels and compares the results with the
+// scalar version, which gives the reference values
+template <typename F>
+void compareLevels(F f, Real tolerance) {
+  simd::Level supported = simd::supportedLevel();
+  for (int s=0; s<(int)ARRAY_SIZE(sizes); s++) {
+    simd::setLevel(simd::SCALAR);
+    ::essentia::VectorEx<Real> expected = f(sizes[s]);
+
+    for (int level=simd::SSE2; level<=supported; level++) {
+      simd::setLevel((simd::Level)level);
+      ::essentia::VectorEx<Real> found = f(sizes[s]);
+      ASSERT_EQ(expected.size(), found.size());
+      for (int i=0; i<(int)found.size(); i++) {
+        EXPECT_NEAR(expected[i], found[i], tolerance)
+          << "level " << simd::levelName((simd::Level)level) << ", size " << sizes[s] << ", index " << i;
+      }
+    }
+  }
+  simd::setLevel(supported);
+}
+
+}
+
+
+TEST(Simd, Multiply) {
+  compareLevels([](int n) {
+    srand(n);
+    ::essentia::VectorEx<Real> a = randomVector(n), b = randomVector(n), out(n);
+    simd::multiply(a.data(), b.data(), out.data(), n);
+    for (int i=0; i<n; i++) EXPECT_EQ(out[i], a[i] * b[i]);
+    return out;
+  }, 0);
+}
+
+TEST(Simd, Square) {
+  compareLevels([](int n) {
+    srand(n);
+    ::essentia::VectorEx<Real> a = randomVector(n), out(n);
+    simd::square(a.data(), out.data(), n);
+    return out;
+  }, 0);
+}
+
+TEST(Simd, MagnitudeAndPower) {
+  compareLevels([](int n) {
+    srand(n);
+    ::essentia::VectorEx<Real> re = randomVector(n), im = randomVector(n);
+    ::essentia::VectorEx<complex<Real> > c(n);
+    for (int i=0; i<n; i++) c[i] = complex<Real>(re[i], im[i]);
+
+    ::essentia::VectorEx<Real> out(2*n);
+    simd::magnitude(c.data(), out.data(), n);
+    simd::power(c.data(), out.data() + n, n);
+    for (int i=0; i<n; i++) EXPECT_NEAR(out[i], abs(c[i]), 1e-6);
+    return out;
+  }, 0);
+}
+
+TEST(Simd, Dot) {
+  compareLevels([](int n) {
+    srand(n);
+    ::essentia::VectorEx<Real> a = randomVector(n), b = randomVector(n);
+    return ::essentia::VectorEx<Real>(1, simd::dot(a.data(), b.data(), n));
+  }, 1e-4);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include <algorithm>
+#include "essentia_gtest.h"
+#include "slidingmedian.h"
+using namespace std;
+using namespace essentia;
+
+
+TEST(SlidingMedian, SameAsSorting) {
+  // few distinct values, so that there are a lot of duplicates in the window
+  ::essentia::VectorEx<Real> values(2000);
+  for (int i=0; i<(int)values.size(); i++) values[i] = rand() % 20;
+
+  int sizes[] = { 1, 3, 5, 11, 101 };
+  for (int s=0; s<(int)ARRAY_SIZE(sizes); s++) {
+    int size = sizes[s];
+    util::SlidingMedian window(size);
+
+    for (int i=0; i<(int)values.size(); i++) {
+      window.push(values[i]);
+      EXPECT_EQ(window.full(), i >= size-1);
+      if (!window.full()) continue;
+
+      ::essentia::VectorEx<Real> sorted(values.begin() + i-size+1, values.begin() + i+1);
+      sort(sorted.begin(), sorted.end());
+      EXPECT_EQ(window.median(), sorted[size/2]);
+    }
+
+    window.reset();
+    EXPECT_FALSE(window.full());
+  }
+}
+
+TEST(SlidingMedian, EvenSize) {
+  ASSERT_THROW(util::SlidingMedian(4), EssentiaException);
+  ASSERT_THROW(util::SlidingMedian(0), EssentiaException);
+}
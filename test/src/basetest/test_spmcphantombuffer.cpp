@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "network.h"
+#include "vectorinput.h"
+#include "vectoroutput.h"
+#include <chrono>
+#include <thread>
+using namespace std;
+using namespace essentia;
+using namespace essentia::streaming;
+
+
+TEST(SPMCPhantomBuffer, SingleThread) {
+  Source<int> source("Source");
+  Sink<int> sink("Sink");
+  connect(source, sink);
+  source.setBufferInfo(BufferInfo(16, 8));
+  source.setConcurrentBuffer(true);
+
+  // chunks of phantomSize + 1 tokens, which need the phantom zone to be
+  // contiguous when they wrap around the end of the buffer
+  int written = 0, read = 0;
+  for (int step=0; step<20; step++) {
+    ASSERT_TRUE(source.acquire(9));
+    for (int i=0; i<9; i++) source.tokens()[i] = written++;
+    source.release(9);
+
+    // the buffer is full until the reader catches up
+    EXPECT_FALSE(source.acquire(9));
+
+    ASSERT_TRUE(sink.acquire(9));
+    for (int i=0; i<9; i++) EXPECT_EQ(read++, sink.tokens()[i]);
+    sink.release(9);
+    EXPECT_FALSE(sink.acquire(1));
+  }
+  EXPECT_EQ(written, source.totalProduced());
+  EXPECT_EQ(written - 1, source.lastTokenProduced());
+
+  ASSERT_THROW(source.acquire(10), EssentiaException);
+  ASSERT_THROW(source.setConcurrentBuffer(false), EssentiaException);
+}
+
+TEST(SPMCPhantomBuffer, WaitTime) {
+  Source<int> source("Source");
+  Sink<int> sink("Sink");
+  connect(source, sink);
+  source.setConcurrentBuffer(true, 2000);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  EXPECT_FALSE(sink.acquire(1));
+  EXPECT_GE(chrono::steady_clock::now() - start, chrono::microseconds(2000));
+
+  // a token written while the reader waits is picked up
+  source.setConcurrentBuffer(true, -1);
+  thread writer([&source] {
+    this_thread::sleep_for(chrono::microseconds(500));
+    source.push(42);
+  });
+  EXPECT_EQ(42, sink.pop());
+  writer.join();
+}
+
+TEST(SPMCPhantomBuffer, Stress) {
+  const int nTokens = 1000000;
+  const int nReaders = 3;
+
+  Source<int> source("Source");
+  Sink<int> sinks[nReaders];
+  for (int r=0; r<nReaders; r++) connect(source, sinks[r]);
+  // a small buffer, so that it is often full or empty and wraps around a lot
+  source.setBufferInfo(BufferInfo(64, 16));
+  source.setConcurrentBuffer(true, -1);
+
+  bool ordered[nReaders];
+  vector<thread> readers;
+  for (int r=0; r<nReaders; r++) {
+    ordered[r] = true;
+    readers.push_back(thread([&, r]() {
+      Sink<int>& sink = sinks[r];
+      int read = 0;
+      while (read < nTokens) {
+        int n = min(1 + (read*7 + r) % 17, nTokens - read);
+        sink.acquire(n);
+        const ::essentia::VectorEx<int>& tokens = sink.tokens();
+        for (int i=0; i<n; i++) {
+          if (tokens[i] != read + i) ordered[r] = false;
+        }
+        // release in two steps, to check partial releases
+        sink.release(n/2);
+        sink.release(n - n/2);
+        read += n;
+      }
+    }));
+  }
+
+  int written = 0;
+  while (written < nTokens) {
+    int n = min(1 + written % 17, nTokens - written);
+    source.acquire(n);
+    ::essentia::VectorEx<int>& tokens = source.tokens();
+    for (int i=0; i<n; i++) tokens[i] = written + i;
+    source.release(n);
+    written += n;
+  }
+
+  for (int r=0; r<nReaders; r++) {
+    readers[r].join();
+    EXPECT_TRUE(ordered[r]);
+    EXPECT_EQ(nTokens, source.typedBuffer().totalTokensRead(r));
+  }
+}
+
+TEST(SPMCPhantomBuffer, Network) {
+  ::essentia::VectorEx<Real> input(10000);
+  for (int i=0; i<(int)input.size(); i++) input[i] = i;
+  ::essentia::VectorEx<Real> output;
+
+  VectorInput<Real>* gen = new VectorInput<Real>(&input);
+  gen->output("data").setConcurrentBuffer(true);
+  connect(gen->output("data"), output);
+  scheduler::Network(gen).run();
+
+  EXPECT_VEC_EQ(output, input);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+
+#include "essentia_gtest.h"
+#include "spscring.h"
+#include <thread>
+using namespace std;
+using namespace essentia;
+using namespace essentia::util;
+
+
+TEST(SPSCRing, FullAndEmpty) {
+  SPSCRing<int> ring(3);
+  EXPECT_EQ(3u, ring.capacity());
+  EXPECT_TRUE(ring.front() == 0);
+
+  for (int i=0; i<3; i++) {
+    ASSERT_TRUE(ring.back() != 0);
+    *ring.back() = i;
+    ring.push();
+  }
+  EXPECT_TRUE(ring.back() == 0);
+
+  EXPECT_EQ(0, *ring.front());
+  ring.pop();
+  ASSERT_TRUE(ring.back() != 0);
+  *ring.back() = 3;
+  ring.push();
+
+  for (int i=1; i<4; i++) {
+    ASSERT_TRUE(ring.front() != 0);
+    EXPECT_EQ(i, *ring.front());
+    ring.pop();
+  }
+  EXPECT_TRUE(ring.front() == 0);
+
+  *ring.back() = 4;
+  ring.push();
+  ring.clear();
+  EXPECT_TRUE(ring.front() == 0);
+}
+
+TEST(SPSCRing, SlotsAreReused) {
+  SPSCRing<vector<int> > ring(2);
+  for (int i=0; i<10; i++) {
+    vector<int>* slot = ring.back();
+    slot->assign(100, i);
+    ring.push();
+    EXPECT_EQ(i, (*ring.front())[99]);
+    ring.pop();
+  }
+  // each slot has been allocated once and kept its capacity
+  ring.back()->clear();
+  EXPECT_GE(ring.back()->capacity(), 100u);
+}
+
+TEST(SPSCRing, TwoThreads) {
+  const int n = 100000;
+  SPSCRing<int> ring(16);
+
+  thread producer([&ring] {
+    for (int i=0; i<n; i++) {
+      int* slot;
+      while (!(slot = ring.back())) this_thread::yield();
+      *slot = i;
+      ring.push();
+    }
+  });
+
+  bool ordered = true;
+  for (int i=0; i<n; i++) {
+    int* slot;
+    while (!(slot = ring.front())) this_thread::yield();
+    if (*slot != i) ordered = false;
+    ring.pop();
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(ring.front() == 0);
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+ *
+ * This file is part of Essentia
+ *
+ * Essentia is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ */
+#include "essentia_gtest.h"
+#include "roguevector.h"
+using namespace std;
+using namespace essentia;
+
+
+TEST(VectorEx, Owned) {
+  ::essentia::VectorEx<Real> v;
+  EXPECT_TRUE(v.empty());
+  for (int i=0; i<100; i++) v.push_back(i);  // reallocates a few times
+
+  EXPECT_EQ(v.size(), 100u);
+  EXPECT_EQ(v.data(), &v[0]);
+  EXPECT_EQ(v.end() - v.begin(), 100);
+  EXPECT_EQ(v.front(), 0);
+  EXPECT_EQ(v.back(), 99);
+
+  v.erase(v.begin(), v.begin() + 10);
+  v.pop_back();
+  EXPECT_EQ(v.size(), 89u);
+  EXPECT_EQ(v[0], 10);
+  EXPECT_EQ(v.back(), 98);
+
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.begin(), v.end());
+}
+
+TEST(VectorEx, View) {
+  Real array[] = {1, 2, 3, 4, 5};
+  RogueVector<Real> v(array, 5);
+
+  EXPECT_EQ(v.data(), array);
+  EXPECT_EQ(v.size(), 5u);
+  v[1] = 20;
+  EXPECT_EQ(array[1], 20);
+
+  // shrinking keeps the view
+  v.resize(3);
+  EXPECT_EQ(v.data(), array);
+  EXPECT_EQ(v.size(), 3u);
+
+  // anything else copies the data and leaves the array alone
+  v.push_back(6);
+  EXPECT_NE(v.data(), array);
+  Real expected[] = {1, 20, 3, 6};
+  EXPECT_VEC_EQ(v, arrayToVector<Real>(expected));
+  EXPECT_EQ(array[3], 4);
+}
+
+TEST(VectorEx, ViewErase) {
+  Real array[] = {1, 2, 3, 4, 5};
+  RogueVector<Real> v(array, 5);
+
+  v.erase(v.begin() + 1, v.begin() + 3);
+  Real expected[] = {1, 4, 5};
+  EXPECT_VEC_EQ(v, arrayToVector<Real>(expected));
+
+  RogueVector<Real> w(array, 5);
+  w.insert(w.begin() + 1, 10);
+  Real expected2[] = {1, 10, 2, 3, 4, 5};
+  EXPECT_VEC_EQ(w, arrayToVector<Real>(expected2));
+}
+
+TEST(VectorEx, CopyAndMove) {
+  Real array[] = {1, 2, 3};
+
+  // copying a view gives another view on the same data
+  RogueVector<Real> view(array, 3);
+  ::essentia::VectorEx<Real> viewCopy(view);
+  EXPECT_EQ(viewCopy.data(), array);
+  EXPECT_EQ(viewCopy.size(), 3u);
+
+  // copying owned data copies it
+  ::essentia::VectorEx<Real> owned = arrayToVector<Real>(array);
+  ::essentia::VectorEx<Real> ownedCopy;
+  ownedCopy = owned;
+  EXPECT_NE(ownedCopy.data(), owned.data());
+  EXPECT_VEC_EQ(ownedCopy, owned);
+
+  // moving keeps the storage
+  const Real* data = owned.data();
+  ::essentia::VectorEx<Real> moved(std::move(owned));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved.size(), 3u);
+  EXPECT_TRUE(owned.empty());
+
+  ::essentia::VectorEx<Real> swapped;
+  swapped.swap(moved);
+  EXPECT_EQ(swapped.data(), data);
+  EXPECT_TRUE(moved.empty());
+  swapped.push_back(4);
+  EXPECT_EQ(swapped.back(), 4);
+}
+
+TEST(VectorEx, Alignment) {
+  // the data owned by the vectors of real and complex values is aligned, so
+  // that it can be handed directly to FFTW and the SIMD kernels
+  for (int size=1; size<100; size+=7) {
+    ::essentia::VectorEx<Real> real(size);
+    ::essentia::VectorEx<std::complex<Real> > cplx(size);
+    EXPECT_EQ((size_t)real.data() % ESSENTIA_VECTOR_ALIGNMENT, 0u);
+    EXPECT_EQ((size_t)cplx.data() % ESSENTIA_VECTOR_ALIGNMENT, 0u);
+
+    real.push_back(1);
+    cplx.insert(cplx.begin(), std::complex<Real>(1, 0));
+    EXPECT_EQ((size_t)real.data() % ESSENTIA_VECTOR_ALIGNMENT, 0u);
+    EXPECT_EQ((size_t)cplx.data() % ESSENTIA_VECTOR_ALIGNMENT, 0u);
+  }
+
+  // a view on some unaligned data gets aligned storage once it needs its own
+  Real array[] = {1, 2, 3, 4, 5};
+  RogueVector<Real> view(array+1, 3);
+  view.push_back(6);
+  EXPECT_EQ((size_t)view.data() % ESSENTIA_VECTOR_ALIGNMENT, 0u);
+  EXPECT_EQ(view.size(), 4u);
+  EXPECT_EQ(view[0], 2);
+}
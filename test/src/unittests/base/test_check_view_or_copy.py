@@ -51,6 +51,46 @@ class TestCheckViewOrCopy(TestCase):
         self.assertEqualVector(fbands1(spectrum), fbands2(spectrum))
 
 
+    def testMatrixViewInput(self):
+        # 2D arrays are read as C-ordered rows, so transposed or sliced views
+        # have to give the same result as their contiguous copies.
+        features = numpy.arange(60, dtype=numpy.float32).reshape(12, 5)
+        query = features.T[:, 2:]
+        reference = features[::2].T
+
+        csm = CrossSimilarityMatrix()
+        self.assertEqualMatrix(csm(query, reference),
+                               csm(numpy.ascontiguousarray(query),
+                                   numpy.ascontiguousarray(reference)))
+
+    def testMatrixOutputIsOwned(self):
+        # The returned array takes the output's data over, so it must neither
+        # change when the algorithm is computed again nor share the input data.
+        query = numpy.arange(12, dtype=numpy.float32).reshape(4, 3)
+        csm = CrossSimilarityMatrix()
+        first = csm(query, query)
+        expected = numpy.array(first)
+
+        csm(query + 1, query * 2)
+        self.assertEqualMatrix(first, expected)
+
+        first[0, 0] = 100
+        self.assertEqualMatrix(csm(query, query), expected)
+
+    def testTensorViewInputAndOwnedOutput(self):
+        tensor = numpy.arange(120, dtype=numpy.float32).reshape(1, 2, 3, 20)
+        view = tensor[:, :, :, ::2]
+        transpose = TensorTranspose(permutation=[0, 1, 2, 3])
+
+        result = transpose(view)
+        self.assertEqualVector(result.flatten(), view.flatten())
+
+        # modifying the result doesn't write through to the input
+        result[0, 0, 0, 0] = -1
+        self.assertEqual(tensor[0, 0, 0, 0], 0)
+        self.assertEqualVector(transpose(view).flatten(), view.flatten())
+
+
 suite = allTests(TestCheckViewOrCopy)
 
 if __name__ == '__main__':
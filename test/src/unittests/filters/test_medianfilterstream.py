@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+
+# Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+#
+# This file is part of Essentia
+#
+# Essentia is free software: you can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the Free
+# Software Foundation (FSF), either version 3 of the License, or (at your
+# option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the Affero GNU General Public License
+# version 3 along with this program. If not, see http://www.gnu.org/licenses/
+
+
+
+from essentia_test import *
+from essentia.streaming import MedianFilterStream, MedianFilter
+import essentia.standard as std
+
+
+class TestMedianFilterStream(TestCase):
+
+    def run_streaming(self, signal, kernelSize):
+        gen = VectorInput(signal)
+        medianFilter = MedianFilterStream(kernelSize=kernelSize)
+        p = Pool()
+
+        gen.data >> medianFilter.array
+        medianFilter.filteredArray >> (p, 'filtered')
+        run(gen)
+
+        if not p.descriptorNames():
+            return []
+        return p['filtered']
+
+    def testStdVsStreaming(self):
+        # the window is kept across the chunks of the stream, which gives the
+        # same output as filtering the whole signal
+        signal = numpy.random.RandomState(0).rand(10000).astype(numpy.float32)
+        for kernelSize in [1, 3, 11, 101]:
+            expected = std.MedianFilter(kernelSize=kernelSize)(signal)
+            self.assertEqualVector(self.run_streaming(signal, kernelSize), expected)
+
+    def testPadding(self):
+        x = [16, 51, 45, 41, 45, 51, 45, 4, 51, 45, 6, 46, 3]
+        y = self.run_streaming(x, 7)
+        self.assertEqual(len(y), len(x))
+        self.assertEqual(y[0], x[0])
+        self.assertEqual(y[-1], x[-1])
+
+    def testShorterThanKernel(self):
+        # unlike MedianFilter, this is allowed as the stream can be of any length
+        self.assertEqualVector(self.run_streaming([1, 2], 11), [1, 2])
+
+    def testEmpty(self):
+        self.assertEqualVector(self.run_streaming([], 11), [])
+
+    def testMedianFilterTokens(self):
+        # the streaming MedianFilter still filters each array independently
+        frames = numpy.random.RandomState(1).rand(3, 100).astype(numpy.float32)
+        gen = VectorInput(frames)
+        medianFilter = MedianFilter(kernelSize=11)
+        p = Pool()
+
+        gen.data >> medianFilter.array
+        medianFilter.filteredArray >> (p, 'filtered')
+        run(gen)
+
+        for frame, filtered in zip(frames, p['filtered']):
+            self.assertEqualVector(filtered, std.MedianFilter(kernelSize=11)(frame))
+
+
+suite = allTests(TestMedianFilterStream)
+
+if __name__ == '__main__':
+    TextTestRunner(verbosity=2).run(suite)
@@ -182,6 +182,140 @@ class TestAudioLoader_Streaming(TestCase):
         self.assertEqualMatrix(audio2, audio1)
         self.assertEqualMatrix(audio2, audio3)
 
+    def testSegment(self):
+        from essentia.standard import AudioLoader as stdAudioLoader
+        dir = join(testdata.audio_dir, 'recorded')
+        md5s = { 'wav': "bf0f4d0613fab0fa5268ece9b043c441",
+                 'flac': "93ee45bc8776eed656a554b32d0d9616" }
+
+        for ext in ['wav', 'flac']:
+            filename = join(dir, 'dubstep.' + ext)
+            audio, sr, _, _, _, _ = stdAudioLoader(filename=filename)()
+            start, end = int(1.5*sr), int(2.5*sr)
+
+            # decoding starts close to the segment, which is cut to the sample
+            segment, sr2, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1.5, endTime=2.5)()
+            self.assertEqual(sr2, sr)
+            self.assertEqualMatrix(segment, audio[start:end])
+
+            # the checksum still covers the whole file
+            segment, _, _, md5, _, _ = stdAudioLoader(filename=filename, startTime=1.5, endTime=2.5, computeMD5=True)()
+            self.assertEqualMatrix(segment, audio[start:end])
+            self.assertEqual(md5, md5s[ext])
+
+            segment, _, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1.5)()
+            self.assertEqualMatrix(segment, audio[start:])
+
+            segment, _, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1000)()
+            self.assertEqual(len(segment), 0)
+
+        # lossy decoders start from a seek point before the segment instead of
+        # from the beginning of the file, so their state, and thus the decoded
+        # samples, can differ slightly from the ones of the full decode
+        def assertCloseAudio(found, expected):
+            self.assertEqual(found.shape, expected.shape)
+            self.assertAlmostEqualAbs(numpy.abs(found - expected).max(), 0, 1e-3)
+
+        for ext in ['mp3', 'ogg']:
+            filename = join(dir, 'dubstep.' + ext)
+            audio, sr, _, md5, _, _ = stdAudioLoader(filename=filename, computeMD5=True)()
+            start, end = int(1.5*sr), int(2.5*sr)
+
+            segment, sr2, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1.5, endTime=2.5)()
+            self.assertEqual(sr2, sr)
+            assertCloseAudio(segment, audio[start:end])
+
+            segment, _, _, md52, _, _ = stdAudioLoader(filename=filename, startTime=1.5, endTime=2.5, computeMD5=True)()
+            assertCloseAudio(segment, audio[start:end])
+            self.assertEqual(md52, md5)
+
+            segment, _, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1.5)()
+            assertCloseAudio(segment, audio[start:])
+
+            segment, _, _, _, _, _ = stdAudioLoader(filename=filename, startTime=1000)()
+            self.assertEqual(len(segment), 0)
+
+        filename = join(dir, 'dubstep.wav')
+        self.assertConfigureFails(stdAudioLoader(), {'filename': filename, 'startTime': 2, 'endTime': 1})
+
+    def testDecodeAhead(self):
+        from essentia.standard import AudioLoader as stdAudioLoader
+        dir = join(testdata.audio_dir, 'recorded')
+
+        for filename in ['cat_purrrr.wav', 'dubstep.flac']:
+            filename = join(dir, filename)
+            audio, sr, nChannels, md5, _, _ = stdAudioLoader(filename=filename, computeMD5=True)()
+
+            # the audio decoded ahead is the same, whatever the size of the ring
+            # and the number of threads of the decoder
+            for decodeThreads in [1, 0]:
+                loader = stdAudioLoader(filename=filename, computeMD5=True,
+                                        decodeAhead=True, decodeThreads=decodeThreads)
+                audio2, sr2, nChannels2, md52, _, _ = loader()
+                self.assertEqualMatrix(audio2, audio)
+                self.assertEqual(sr2, sr)
+                self.assertEqual(nChannels2, nChannels)
+                self.assertEqual(md52, md5)
+
+                # the loader can be run again after a reset
+                audio3, _, _, _, _, _ = loader()
+                self.assertEqualMatrix(audio3, audio)
+
+            segment, _, _, _, _, _ = stdAudioLoader(filename=filename, decodeAhead=True, startTime=1.0, endTime=2.0)()
+            self.assertEqualMatrix(segment, audio[int(sr):int(2*sr)])
+
+        mono1 = MonoLoader(filename=join(dir, 'dubstep.flac'))()
+        mono2 = MonoLoader(filename=join(dir, 'dubstep.flac'), decodeAhead=True)()
+        self.assertEqualVector(mono2, mono1)
+
+        self.assertRaises(RuntimeError, lambda: stdAudioLoader(filename='unknown.wav', decodeAhead=True)())
+
+    def testCache(self):
+        from essentia.standard import AudioLoader as stdAudioLoader
+        import os, shutil, tempfile
+        cacheDirectory = tempfile.mkdtemp()
+        audiofile = join(testdata.audio_dir, 'recorded', 'cat_purrrr.wav')
+
+        try:
+            essentia.resetAudioCacheStatistics()
+            audio1, sr1, nChannels1, md51, bitrate1, codec1 = stdAudioLoader(filename=audiofile, computeMD5=True, cacheDirectory=cacheDirectory)()
+            stats = essentia.audioCacheStatistics()
+            self.assertEqual(stats['hits'], 0)
+            self.assertEqual(stats['misses'], 1)
+            self.assertEqual(stats['bytesWritten'], 219343*2*4)
+            self.assertEqual(len([f for f in os.listdir(cacheDirectory) if f.endswith('.pcm')]), 1)
+
+            audio2, sr2, nChannels2, md52, bitrate2, codec2 = stdAudioLoader(filename=audiofile, computeMD5=True, cacheDirectory=cacheDirectory)()
+            stats = essentia.audioCacheStatistics()
+            self.assertEqual(stats['hits'], 1)
+            self.assertEqual(stats['misses'], 1)
+            self.assertEqual(stats['bytesRead'], 219343*2*4)
+
+            self.assertEqualMatrix(audio2, audio1)
+            self.assertEqual(sr2, sr1)
+            self.assertEqual(nChannels2, nChannels1)
+            self.assertEqual(md52, "426fe5cf5ac3730f8c8db2a760e2b819")
+            self.assertEqual(md52, md51)
+            self.assertEqual(bitrate2, bitrate1)
+            self.assertEqual(codec2, codec1)
+
+            # the checksum is only output when asked for, even on a cache hit
+            _, _, _, md53, _, _ = stdAudioLoader(filename=audiofile, cacheDirectory=cacheDirectory)()
+            self.assertEqual(md53, "")
+
+            # the cache is shared by the other loaders
+            mono1 = MonoLoader(filename=audiofile)()
+            mono2 = MonoLoader(filename=audiofile, cacheDirectory=cacheDirectory)()
+            self.assertEqualVector(mono2, mono1)
+            self.assertEqual(essentia.audioCacheStatistics()['hits'], 3)
+
+            # segments are read directly from the cached audio
+            segment, _, _, _, _, _ = stdAudioLoader(filename=audiofile, cacheDirectory=cacheDirectory, startTime=1.0, endTime=2.0)()
+            self.assertEqualMatrix(segment, audio1[44100:88200])
+            self.assertEqual(essentia.audioCacheStatistics()['hits'], 4)
+        finally:
+            shutil.rmtree(cacheDirectory)
+
     def testBitrate(self):
         from math import fabs
         dir = join(testdata.audio_dir,'recorded')
@@ -104,6 +104,28 @@ class TestEqloudLoader_Streaming(TestCase):
         self.assertEqualVector(audio2, audio1)
         self.assertEqualVector(audio2, audio3)
 
+    def testDecodeAheadAndCache(self):
+        # the options of the AudioLoader are forwarded to it, and don't change
+        # the loaded audio
+        import os, tempfile, shutil
+        from essentia.standard import EqloudLoader as stdEqloudLoader
+        filename = join(testdata.audio_dir,'recorded','musicbox.wav')
+        expected = stdEqloudLoader(filename=filename, startTime=1, endTime=5)()
+
+        audio = stdEqloudLoader(filename=filename, startTime=1, endTime=5, decodeAhead=True)()
+        self.assertEqualVector(audio, expected)
+
+        # the audio is only cached when it is loaded from the beginning
+        expected = stdEqloudLoader(filename=filename, endTime=5)()
+        cacheDir = tempfile.mkdtemp()
+        try:
+            for i in range(2):
+                audio = stdEqloudLoader(filename=filename, endTime=5, cacheDirectory=cacheDir)()
+                self.assertEqualVector(audio, expected)
+            self.assertTrue(len(os.listdir(cacheDir)) > 0)
+        finally:
+            shutil.rmtree(cacheDir)
+
 
 
 suite = allTests(TestEqloudLoader_Streaming)
@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+
+# Copyright (C) 2006-2021  Music Technology Group - Universitat Pompeu Fabra
+#
+# This file is part of Essentia
+#
+# Essentia is free software: you can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the Free
+# Software Foundation (FSF), either version 3 of the License, or (at your
+# option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the Affero GNU General Public License
+# version 3 along with this program. If not, see http://www.gnu.org/licenses/
+
+
+
+from essentia_test import *
+from essentia import poolbinary
+import os
+
+
+class TestPoolBinaryOutput(TestCase):
+
+    filename = 'test.pool'
+
+    def tearDown(self):
+        if os.path.exists(self.filename):
+            os.remove(self.filename)
+
+    def makePool(self):
+        p = Pool()
+        p.set('single.real', 1.5)
+        p.set('single.vector', [1, 2, 3])
+        p.set('single.string', 'foo')
+        for i in range(5):
+            p.add('frames.real', i)
+            p.add('frames.vector', [i, 2*i, 3*i])
+            p.add('frames.string', 'bar%d' % i)
+        p.add('frames.ragged', [1, 2])
+        p.add('frames.ragged', [3])
+        p.add('frames.matrix', array([[1, 2], [3, 4]]))
+        p.add('frames.matrix', array([[5, 6], [7, 8]]))
+        return p
+
+    def testRoundTrip(self):
+        p = self.makePool()
+        PoolBinaryOutput(filename=self.filename)(p)
+        result = PoolBinaryInput(filename=self.filename)()
+
+        self.assertEqualVector(sorted(result.descriptorNames()), sorted(p.descriptorNames()))
+        self.assertEqual(result['single.real'], 1.5)
+        self.assertEqualVector(result['single.vector'], [1, 2, 3])
+        self.assertEqual(result['single.string'], 'foo')
+        self.assertEqualVector(result['frames.real'], [0, 1, 2, 3, 4])
+        self.assertEqualMatrix(result['frames.vector'], p['frames.vector'])
+        self.assertEqualVector(result['frames.string'], p['frames.string'])
+        self.assertEqualVector(result['frames.ragged'][0], [1, 2])
+        self.assertEqualVector(result['frames.ragged'][1], [3])
+        self.assertEqualMatrix(result['frames.matrix'][1], [[5, 6], [7, 8]])
+
+    def testMemoryMapped(self):
+        p = self.makePool()
+        PoolBinaryOutput(filename=self.filename)(p)
+        result = poolbinary.load(self.filename)
+
+        self.assertEqual(result['single.real'], 1.5)
+        self.assertEqual(result['single.string'], 'foo')
+        self.assertEqualVector(result['frames.real'], [0, 1, 2, 3, 4])
+        # rectangular frames are a single 2D array
+        self.assertEqual(result['frames.vector'].shape, (5, 3))
+        self.assertEqualMatrix(result['frames.vector'], p['frames.vector'])
+        self.assertEqualVector(result['frames.string'], p['frames.string'])
+        self.assertEqual(len(result['frames.ragged']), 2)
+        self.assertEqualMatrix(result['frames.matrix'][0], [[1, 2], [3, 4]])
+        # the arrays map the file
+        self.assertFalse(result['frames.vector'].flags.writeable)
+
+    def testInvalidFile(self):
+        with open(self.filename, 'wb') as f:
+            f.write(b'not a pool')
+        self.assertComputeFails(PoolBinaryInput(filename=self.filename))
+        self.assertRaises(ValueError, poolbinary.load, self.filename)
+
+    def testTruncatedFile(self):
+        PoolBinaryOutput(filename=self.filename)(self.makePool())
+        with open(self.filename, 'rb') as f:
+            data = f.read()
+        with open(self.filename, 'wb') as f:
+            f.write(data[:len(data) // 2])
+        self.assertComputeFails(PoolBinaryInput(filename=self.filename))
+        self.assertRaises(ValueError, poolbinary.load, self.filename)
+
+
+suite = allTests(TestPoolBinaryOutput)
+
+if __name__ == '__main__':
+    TextTestRunner(verbosity=2).run(suite)
@@ -254,6 +254,26 @@ class TestPoolAggregator(TestCase):
         self.assertEqualMatrix(results['foo.bar.dvar2'], [[0,0],[0,0]])
 
 
+    def testThreads(self):
+        p = Pool()
+        for i in range(20):
+            p.add('foo%d' % i, [float((i*j) % 7) for j in range(10)])
+            p.add('bar%d' % i, float(i % 3))
+            p.add('bar%d' % i, float(i % 5))
+
+        defaultStats = ['mean', 'median', 'var', 'skew', 'kurt', 'dmean', 'dvar2']
+        expected = PoolAggregator(defaultStats=defaultStats)(p)
+        results = PoolAggregator(defaultStats=defaultStats, threads=4)(p)
+
+        self.assertEqualVector(sorted(results.descriptorNames()),
+                               sorted(expected.descriptorNames()))
+        for name in expected.descriptorNames():
+            if isinstance(expected[name], numpy.ndarray):
+                self.assertEqualVector(results[name], expected[name])
+            else:
+                self.assertEqual(results[name], expected[name])
+
+
     def testSkewKurtNanValue(self):
         p = Pool( {'foo': [[0, 1, 2, 3, 4]]} )
         